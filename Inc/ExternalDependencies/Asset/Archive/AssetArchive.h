@@ -0,0 +1,441 @@
+﻿#pragma once
+
+#ifndef GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_ARCHIVE_ASSETARCHIVE_H_
+#define GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_ARCHIVE_ASSETARCHIVE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ExternalDependencies/Asset/Archive/BlockCodec.h"
+#include "Thread/AsyncFileService/MappedFile.h"
+#include "Thread/JobSystem/JobSystem.h"
+#include "Thread/Parallel/Parallel.h"
+
+#include "nlohmann/json.hpp"
+
+
+/**************************************************
+*
+* Read-only archive of packed asset files
+* Layout: header, 16 byte aligned blobs, manifest
+* (MessagePack), TOC sorted by name hash, names
+* The whole archive is memory mapped, entries are
+* served as spans into the mapping
+* Blobs may be split into independently compressed
+* blocks, which decompress in parallel
+*
+**************************************************/
+class AssetArchive
+{
+public:
+
+    struct Entry {
+        std::string_view     name;
+        std::string_view     path;                 // Path in the manifest the archive was packed from
+        std::string_view     data;                 // Stored bytes, compressed if codec is not StoreBlockCodec::ID
+        std::uint64_t        size       = 0;       // Size of the original file
+        std::uint32_t        codec      = StoreBlockCodec::ID;
+        std::uint32_t        blockSize  = 0;
+        std::uint32_t        blockCount = 0;
+        const std::uint64_t* pBlockEnds = nullptr; // End of each block in data
+
+        bool IsCompressed() const noexcept {
+            return codec != StoreBlockCodec::ID;
+        }
+    };
+
+    struct PackOptions {
+        std::uint32_t codec     = LzBlockCodec::ID; // Codec of BlockCodecRegistry::GetDefault()
+        std::uint32_t blockSize = 64 * 1024;        // Uncompressed size of a block
+    };
+
+    AssetArchive() {}
+    explicit AssetArchive(const std::string& path) {
+        Open(path);
+    }
+
+    /**
+     * @brief Hash of entry names, FNV-1a 64.
+     */
+    static constexpr std::uint64_t HashName(std::string_view name) noexcept {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (const auto& e : name) {
+            hash = (hash ^ static_cast<std::uint8_t>(e)) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    /**
+     * @brief Pack the files of a manifest ({"list": [{"name", "path"}, ...]}) into an archive.
+     * @details The manifest entries are stored with the archive, so settings such as priorities and dependencies
+     *          survive packing. Files that do not get smaller with the codec are stored as they are.
+     * @return false if the manifest or one of its files could not be read, or the archive could not be written.
+     */
+    static bool Pack(const std::string& manifest_path, const std::string& archive_path, const PackOptions& options) {
+        const auto codec = BlockCodecRegistry::GetDefault().Find(options.codec);
+        if (!codec || !options.blockSize) return false;
+
+        MappedFile manifest_file;
+        if (!manifest_file.Open(manifest_path)) return false;
+        const auto manifest = nlohmann::json::parse(manifest_file.GetView().begin(), manifest_file.GetView().end(), nullptr, false);
+        if (manifest.is_discarded() || !manifest.contains("list") || !manifest.at("list").is_array()) return false;
+
+        std::ofstream ofs(archive_path, std::ios::binary);
+        if (!ofs) return false;
+
+        Header header;
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        std::uint64_t offset = sizeof(header);
+
+        std::vector<TocEntry> toc;
+        std::string strings;
+        for (const auto& e : manifest.at("list")) {
+            const auto name = e.at("name").get<std::string>();
+            const auto path = e.at("path").get<std::string>();
+            MappedFile file;
+            if (!file.Open(path)) return false;
+
+            TocEntry entry;
+            entry.nameHash   = HashName(name);
+            entry.offset     = offset;
+            entry.size       = file.GetSize();
+            entry.storedSize = file.GetSize();
+            entry.nameOffset = static_cast<std::uint32_t>(strings.size());
+            entry.nameSize   = static_cast<std::uint32_t>(name.size());
+            strings += name;
+            entry.pathOffset = static_cast<std::uint32_t>(strings.size());
+            entry.pathSize   = static_cast<std::uint32_t>(path.size());
+            strings += path;
+
+            std::string stored;
+            std::vector<std::uint64_t> block_ends;
+            if (codec->GetID() != StoreBlockCodec::ID && CompressBlocks(*codec, file.GetView(), options.blockSize, &stored, &block_ends)) {
+                entry.storedSize = stored.size();
+                entry.codec      = codec->GetID();
+                entry.blockSize  = options.blockSize;
+                entry.blockCount = static_cast<std::uint32_t>(block_ends.size());
+                ofs.write(stored.data(), static_cast<std::streamsize>(stored.size()));
+                offset += stored.size();
+                offset += WritePadding(ofs, offset);
+                entry.blockTableOffset = offset;
+                ofs.write(reinterpret_cast<const char*>(block_ends.data()), static_cast<std::streamsize>(block_ends.size() * sizeof(std::uint64_t)));
+                offset += block_ends.size() * sizeof(std::uint64_t);
+            }
+            else {
+                ofs.write(file.GetView().data(), static_cast<std::streamsize>(file.GetSize()));
+                offset += file.GetSize();
+            }
+            toc.push_back(entry);
+            offset += WritePadding(ofs, offset);
+        }
+
+        const auto manifest_bytes = nlohmann::json::to_msgpack(manifest.at("list"));
+        header.manifestOffset = offset;
+        header.manifestSize   = manifest_bytes.size();
+        ofs.write(reinterpret_cast<const char*>(manifest_bytes.data()), static_cast<std::streamsize>(manifest_bytes.size()));
+        offset += manifest_bytes.size();
+        offset += WritePadding(ofs, offset);
+
+        std::sort(toc.begin(), toc.end(), [&strings](const TocEntry& lhs, const TocEntry& rhs) {
+            if (lhs.nameHash != rhs.nameHash) return lhs.nameHash < rhs.nameHash;
+            return strings.compare(lhs.nameOffset, lhs.nameSize, strings, rhs.nameOffset, rhs.nameSize) < 0;
+        });
+        header.entryCount = static_cast<std::uint32_t>(toc.size());
+        header.tocOffset  = offset;
+        ofs.write(reinterpret_cast<const char*>(toc.data()), static_cast<std::streamsize>(toc.size() * sizeof(TocEntry)));
+        offset += toc.size() * sizeof(TocEntry);
+        header.stringsOffset = offset;
+        header.stringsSize   = strings.size();
+        ofs.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+
+        ofs.seekp(0);
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        return static_cast<bool>(ofs);
+    }
+
+    static bool Pack(const std::string& manifest_path, const std::string& archive_path) {
+        return Pack(manifest_path, archive_path, PackOptions{});
+    }
+
+    /**
+     * @brief Map an archive written by Pack.
+     * @return false if the file is missing, truncated or not an archive of this version.
+     */
+    bool Open(const std::string& path) {
+        m_path.clear();
+        m_pHeader = nullptr;
+        if (!m_file.Open(path) || m_file.GetSize() < sizeof(Header)) return false;
+
+        const auto* header = reinterpret_cast<const Header*>(m_file.GetView().data());
+        const auto size = static_cast<std::uint64_t>(m_file.GetSize());
+        if (std::memcmp(header->magic, MAGIC, sizeof(header->magic)) != 0 || header->version != VERSION) return false;
+        if (header->tocOffset > size || header->entryCount > (size - header->tocOffset) / sizeof(TocEntry)) return false;
+        if (header->stringsOffset > size || header->stringsSize > size - header->stringsOffset) return false;
+        if (header->manifestOffset > size || header->manifestSize > size - header->manifestOffset) return false;
+        for (const auto& e : GetToc(header)) {
+            if (e.offset > size || e.storedSize > size - e.offset) return false;
+            if (e.codec != StoreBlockCodec::ID) {
+                if (!e.blockSize || e.blockCount != (e.size + e.blockSize - 1) / e.blockSize) return false;
+                if (e.blockTableOffset % sizeof(std::uint64_t) || e.blockTableOffset > size || e.blockCount > (size - e.blockTableOffset) / sizeof(std::uint64_t)) return false;
+            }
+            else if (e.storedSize != e.size) {
+                return false;
+            }
+            if (static_cast<std::uint64_t>(e.nameOffset) + e.nameSize > header->stringsSize) return false;
+            if (static_cast<std::uint64_t>(e.pathOffset) + e.pathSize > header->stringsSize) return false;
+        }
+        m_pHeader = header;
+        m_path    = path;
+        return true;
+    }
+
+    bool IsOpened() const noexcept {
+        return m_pHeader != nullptr;
+    }
+
+    const std::string& GetPath() const noexcept {
+        return m_path;
+    }
+
+    std::size_t GetEntryCount() const noexcept {
+        return m_pHeader ? m_pHeader->entryCount : 0;
+    }
+
+    /**
+     * @brief Entry by index, in name hash order.
+     */
+    Entry GetEntry(std::size_t index) const noexcept {
+        return MakeEntry(GetToc(m_pHeader)[index]);
+    }
+
+    /**
+     * @brief Look up an entry by name. Binary search over the name hashes.
+     * @return false if the archive has no entry of that name.
+     */
+    bool Find(std::string_view name, Entry* entry) const noexcept {
+        if (!m_pHeader) return false;
+        const auto toc  = GetToc(m_pHeader);
+        const auto hash = HashName(name);
+        auto iter = std::lower_bound(toc.begin(), toc.end(), hash, [](const TocEntry& lhs, std::uint64_t rhs) {
+            return lhs.nameHash < rhs;
+        });
+        for (; iter != toc.end() && iter->nameHash == hash; ++iter) {
+            const auto candidate = MakeEntry(*iter);
+            if (candidate.name == name) {
+                *entry = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Decompress one block of an entry, for streaming through a small buffer.
+     * @param dst Buffer of at least GetBlockDataSize(entry, index) bytes.
+     * @return false if the codec is unknown or the block is corrupt.
+     */
+    static bool ReadBlock(const Entry& entry, std::size_t index, char* dst) {
+        if (!entry.IsCompressed()) {
+            if (index) return false;
+            std::memcpy(dst, entry.data.data(), entry.data.size());
+            return true;
+        }
+        const auto codec = BlockCodecRegistry::GetDefault().Find(entry.codec);
+        return codec && ReadBlock(*codec, entry, index, dst);
+    }
+
+    /**
+     * @brief Uncompressed size of a block. Entries that are not compressed are a single block.
+     */
+    static std::size_t GetBlockDataSize(const Entry& entry, std::size_t index) noexcept {
+        if (!entry.IsCompressed()) return static_cast<std::size_t>(entry.size);
+        const std::uint64_t begin = static_cast<std::uint64_t>(index) * entry.blockSize;
+        return static_cast<std::size_t>((std::min<std::uint64_t>)(entry.blockSize, entry.size - begin));
+    }
+
+    /**
+     * @brief Decompress a whole entry into a caller buffer.
+     * @param dst Buffer of at least entry.size bytes.
+     * @param job_system Decompresses the blocks in parallel when given, on the calling thread otherwise.
+     * @return false if the codec is unknown or a block is corrupt.
+     */
+    static bool Read(const Entry& entry, char* dst, JobSystem* job_system = nullptr) {
+        if (!entry.IsCompressed()) {
+            std::memcpy(dst, entry.data.data(), entry.data.size());
+            return true;
+        }
+        const auto codec = BlockCodecRegistry::GetDefault().Find(entry.codec);
+        if (!codec) return false;
+        if (!job_system || entry.blockCount < 2) {
+            for (std::size_t i = 0; i < entry.blockCount; ++i) {
+                if (!ReadBlock(*codec, entry, i, dst + i * entry.blockSize)) return false;
+            }
+            return true;
+        }
+        std::atomic<bool> is_succeeded = true;
+        parallel::Options options;
+        options.pJobSystem      = job_system;
+        options.grainSize       = 1;
+        options.serialThreshold = 2;
+        parallel::ParallelFor(std::size_t(0), static_cast<std::size_t>(entry.blockCount), [&](std::size_t i) {
+            if (!ReadBlock(*codec, entry, i, dst + i * entry.blockSize)) {
+                is_succeeded = false;
+            }
+        }, options);
+        return is_succeeded;
+    }
+
+    /**
+     * @brief Bytes of an entry. A span of the mapping if the entry is not compressed, nothing is copied then.
+     *        Otherwise the entry is decompressed into buffer.
+     * @return false if the entry could not be decompressed.
+     */
+    static bool GetBytes(const Entry& entry, std::string* buffer, std::string_view* bytes, JobSystem* job_system = nullptr) {
+        if (!entry.IsCompressed()) {
+            *bytes = entry.data;
+            return true;
+        }
+        buffer->resize(static_cast<std::size_t>(entry.size));
+        if (!Read(entry, buffer->data(), job_system)) return false;
+        *bytes = *buffer;
+        return true;
+    }
+
+    bool Contains(std::string_view name) const noexcept {
+        Entry entry;
+        return Find(name, &entry);
+    }
+
+    /**
+     * @brief The "list" of the manifest the archive was packed from.
+     */
+    nlohmann::json GetManifest() const {
+        if (!m_pHeader) return nlohmann::json::array();
+        const auto bytes = m_file.GetView().substr(static_cast<std::size_t>(m_pHeader->manifestOffset), static_cast<std::size_t>(m_pHeader->manifestSize));
+        auto manifest = nlohmann::json::from_msgpack(bytes.begin(), bytes.end(), true, false);
+        return manifest.is_discarded() ? nlohmann::json::array() : manifest;
+    }
+
+private:
+
+    static constexpr char          MAGIC[4]  = { 'G', 'L', 'A', 'R' };
+    static constexpr std::uint32_t VERSION   = 2;
+    static constexpr std::uint64_t ALIGNMENT = 16;
+
+    struct Header {
+        char          magic[4]       = { MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3] };
+        std::uint32_t version        = VERSION;
+        std::uint32_t entryCount     = 0;
+        std::uint32_t reserved       = 0;
+        std::uint64_t tocOffset      = 0;
+        std::uint64_t stringsOffset  = 0;
+        std::uint64_t stringsSize    = 0;
+        std::uint64_t manifestOffset = 0;
+        std::uint64_t manifestSize   = 0;
+        std::uint64_t reserved2      = 0;
+    };
+
+    struct TocEntry {
+        std::uint64_t nameHash         = 0;
+        std::uint64_t offset           = 0;
+        std::uint64_t storedSize       = 0;
+        std::uint64_t size             = 0;
+        std::uint64_t blockTableOffset = 0; // Compressed entries only
+        std::uint32_t nameOffset       = 0; // Into the string table
+        std::uint32_t nameSize         = 0;
+        std::uint32_t pathOffset       = 0;
+        std::uint32_t pathSize         = 0;
+        std::uint32_t codec            = StoreBlockCodec::ID;
+        std::uint32_t blockSize        = 0;
+        std::uint32_t blockCount       = 0;
+        std::uint32_t reserved         = 0;
+    };
+
+    struct TocView {
+        const TocEntry* pBegin = nullptr;
+        const TocEntry* pEnd   = nullptr;
+
+        const TocEntry* begin() const noexcept { return pBegin; }
+        const TocEntry* end() const noexcept { return pEnd; }
+        const TocEntry& operator[](std::size_t index) const noexcept { return pBegin[index]; }
+    };
+
+    /**
+     * @brief Compress data block by block. Blocks that do not get smaller are stored as they are.
+     * @return false if the whole did not get smaller.
+     */
+    static bool CompressBlocks(const IBlockCodec& codec, std::string_view data, std::uint32_t block_size, std::string* stored, std::vector<std::uint64_t>* block_ends) {
+        std::vector<char> block(block_size);
+        for (std::size_t begin = 0; begin < data.size(); begin += block_size) {
+            const auto size = (std::min<std::size_t>)(block_size, data.size() - begin);
+            const auto compressed_size = codec.Compress(data.data() + begin, size, block.data(), size - 1);
+            if (compressed_size && compressed_size < size) {
+                stored->append(block.data(), compressed_size);
+            }
+            else {
+                stored->append(data.data() + begin, size);
+            }
+            block_ends->push_back(stored->size());
+        }
+        return stored->size() < data.size();
+    }
+
+    static bool ReadBlock(const IBlockCodec& codec, const Entry& entry, std::size_t index, char* dst) {
+        if (index >= entry.blockCount) return false;
+        const std::uint64_t begin = index ? entry.pBlockEnds[index - 1] : 0;
+        const std::uint64_t end   = entry.pBlockEnds[index];
+        if (begin > end || end > entry.data.size()) return false;
+        const auto src      = entry.data.data() + begin;
+        const auto src_size = static_cast<std::size_t>(end - begin);
+        const auto dst_size = GetBlockDataSize(entry, index);
+        // Blocks that did not compress are stored as they are
+        if (src_size == dst_size) {
+            std::memcpy(dst, src, src_size);
+            return true;
+        }
+        return codec.Decompress(src, src_size, dst, dst_size);
+    }
+
+    static std::uint64_t WritePadding(std::ofstream& ofs, std::uint64_t offset) {
+        static constexpr char ZEROS[ALIGNMENT] = {};
+        const auto padding = (ALIGNMENT - offset % ALIGNMENT) % ALIGNMENT;
+        ofs.write(ZEROS, static_cast<std::streamsize>(padding));
+        return padding;
+    }
+
+    TocView GetToc(const Header* header) const noexcept {
+        if (!header) return {};
+        const auto* begin = reinterpret_cast<const TocEntry*>(m_file.GetView().data() + header->tocOffset);
+        return { begin, begin + header->entryCount };
+    }
+
+    Entry MakeEntry(const TocEntry& toc_entry) const noexcept {
+        const auto view    = m_file.GetView();
+        const auto strings = view.substr(static_cast<std::size_t>(m_pHeader->stringsOffset), static_cast<std::size_t>(m_pHeader->stringsSize));
+        Entry entry;
+        entry.name       = strings.substr(toc_entry.nameOffset, toc_entry.nameSize);
+        entry.path       = strings.substr(toc_entry.pathOffset, toc_entry.pathSize);
+        entry.data       = view.substr(static_cast<std::size_t>(toc_entry.offset), static_cast<std::size_t>(toc_entry.storedSize));
+        entry.size       = toc_entry.size;
+        entry.codec      = toc_entry.codec;
+        entry.blockSize  = toc_entry.blockSize;
+        entry.blockCount = toc_entry.blockCount;
+        if (toc_entry.codec != StoreBlockCodec::ID) {
+            entry.pBlockEnds = reinterpret_cast<const std::uint64_t*>(view.data() + toc_entry.blockTableOffset);
+        }
+        return entry;
+    }
+
+    MappedFile    m_file;
+    std::string   m_path;
+    const Header* m_pHeader = nullptr;
+
+};
+
+#endif
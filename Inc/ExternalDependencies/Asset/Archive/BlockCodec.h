@@ -0,0 +1,286 @@
+﻿#pragma once
+
+#ifndef GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_ARCHIVE_BLOCKCODEC_H_
+#define GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_ARCHIVE_BLOCKCODEC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+
+/**************************************************
+*
+* Interface of codecs that compress independent
+* blocks of an asset archive entry
+*
+**************************************************/
+class IBlockCodec
+{
+public:
+
+    virtual ~IBlockCodec() {}
+
+    /**
+     * @brief ID stored in archives. 0 and 1 are taken by the built-in codecs.
+     */
+    virtual std::uint32_t GetID() const noexcept = 0;
+
+    /**
+     * @brief Compress a block.
+     * @return Compressed size, 0 if the result did not fit in capacity.
+     */
+    virtual std::size_t Compress(const char* src, std::size_t src_size, char* dst, std::size_t capacity) const = 0;
+
+    /**
+     * @brief Decompress a block whose decompressed size is known.
+     * @return false if the data is malformed or does not decompress to exactly dst_size bytes.
+     */
+    virtual bool Decompress(const char* src, std::size_t src_size, char* dst, std::size_t dst_size) const = 0;
+
+};
+
+/**************************************************
+*
+* Stores blocks as they are
+*
+**************************************************/
+class StoreBlockCodec : public IBlockCodec
+{
+public:
+
+    static constexpr std::uint32_t ID = 0;
+
+    std::uint32_t GetID() const noexcept override {
+        return ID;
+    }
+
+    std::size_t Compress(const char* src, std::size_t src_size, char* dst, std::size_t capacity) const override {
+        if (src_size > capacity) return 0;
+        std::memcpy(dst, src, src_size);
+        return src_size;
+    }
+
+    bool Decompress(const char* src, std::size_t src_size, char* dst, std::size_t dst_size) const override {
+        if (src_size != dst_size) return false;
+        std::memcpy(dst, src, src_size);
+        return true;
+    }
+
+};
+
+/**************************************************
+*
+* Fast LZ77 codec in the spirit of LZ4: greedy
+* matching through a small hash table, byte
+* aligned sequences of literals and matches
+* Trades ratio for speed, decompression is a
+* plain copy loop without entropy decoding
+*
+**************************************************/
+class LzBlockCodec : public IBlockCodec
+{
+public:
+
+    static constexpr std::uint32_t ID = 1;
+
+    std::uint32_t GetID() const noexcept override {
+        return ID;
+    }
+
+    std::size_t Compress(const char* src, std::size_t src_size, char* dst, std::size_t capacity) const override {
+        const auto* const base  = reinterpret_cast<const std::uint8_t*>(src);
+        const auto* const end   = base + src_size;
+        auto*             op    = reinterpret_cast<std::uint8_t*>(dst);
+        auto* const       o_end = op + capacity;
+        const auto*       ip     = base;
+        const auto*       anchor = base;
+
+        if (src_size >= MF_LIMIT) {
+            std::uint32_t table[1 << HASH_BITS] = {};
+            const auto* const match_limit = end - LAST_LITERALS;
+            const auto* const ip_limit    = end - MF_LIMIT;
+            ++ip;
+            while (ip <= ip_limit) {
+                const auto sequence = Read32(ip);
+                auto& slot = table[Hash(sequence)];
+                const auto* ref = base + slot;
+                slot = static_cast<std::uint32_t>(ip - base);
+                if (ref >= ip || ip - ref > MAX_OFFSET || Read32(ref) != sequence) {
+                    // Skip faster through data that does not compress
+                    ip += 1 + ((ip - anchor) >> SKIP_STRENGTH);
+                    continue;
+                }
+                while (ip > anchor && ref > base && ip[-1] == ref[-1]) {
+                    --ip;
+                    --ref;
+                }
+                const auto* match_end = ip + MIN_MATCH;
+                for (const auto* r = ref + MIN_MATCH; match_end < match_limit && *match_end == *r; ++match_end, ++r) {}
+
+                if (!WriteSequence(&op, o_end, anchor, static_cast<std::size_t>(ip - anchor), static_cast<std::size_t>(ip - ref), static_cast<std::size_t>(match_end - ip))) {
+                    return 0;
+                }
+                ip     = match_end;
+                anchor = ip;
+            }
+        }
+        if (!WriteSequence(&op, o_end, anchor, static_cast<std::size_t>(end - anchor), 0, 0)) {
+            return 0;
+        }
+        return static_cast<std::size_t>(op - reinterpret_cast<std::uint8_t*>(dst));
+    }
+
+    bool Decompress(const char* src, std::size_t src_size, char* dst, std::size_t dst_size) const override {
+        const auto*       ip    = reinterpret_cast<const std::uint8_t*>(src);
+        const auto* const i_end = ip + src_size;
+        auto* const       begin = reinterpret_cast<std::uint8_t*>(dst);
+        auto*             op    = begin;
+        auto* const       o_end = op + dst_size;
+
+        const auto read_length = [&](std::size_t* length) {
+            std::uint8_t byte = 255;
+            while (byte == 255) {
+                if (ip >= i_end) return false;
+                byte = *ip++;
+                *length += byte;
+            }
+            return true;
+        };
+
+        while (ip < i_end) {
+            const std::uint8_t token = *ip++;
+            std::size_t literal_length = token >> 4;
+            if (literal_length == 15 && !read_length(&literal_length)) return false;
+            if (literal_length > static_cast<std::size_t>(i_end - ip) || literal_length > static_cast<std::size_t>(o_end - op)) return false;
+            std::memcpy(op, ip, literal_length);
+            ip += literal_length;
+            op += literal_length;
+            // The last sequence has no match
+            if (ip == i_end) break;
+
+            if (i_end - ip < 2) return false;
+            const std::size_t offset = static_cast<std::size_t>(ip[0]) | (static_cast<std::size_t>(ip[1]) << 8);
+            ip += 2;
+            if (!offset || offset > static_cast<std::size_t>(op - begin)) return false;
+            std::size_t match_length = token & 15;
+            if (match_length == 15 && !read_length(&match_length)) return false;
+            match_length += MIN_MATCH;
+            if (match_length > static_cast<std::size_t>(o_end - op)) return false;
+
+            const auto* ref = op - offset;
+            if (offset >= match_length) {
+                std::memcpy(op, ref, match_length);
+                op += match_length;
+            }
+            else {
+                // Overlapping match repeats the last offset bytes
+                for (std::size_t i = 0; i < match_length; ++i) {
+                    *op++ = *ref++;
+                }
+            }
+        }
+        return op == o_end;
+    }
+
+private:
+
+    static constexpr std::size_t    MIN_MATCH     = 4;
+    static constexpr std::size_t    LAST_LITERALS = 5;  // The end of a block is always literals, matches never read past it
+    static constexpr std::size_t    MF_LIMIT      = 12;
+    static constexpr std::ptrdiff_t MAX_OFFSET    = 65535;
+    static constexpr int            HASH_BITS     = 12;
+    static constexpr int            SKIP_STRENGTH = 6;
+
+    static std::uint32_t Read32(const std::uint8_t* p) noexcept {
+        std::uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    static std::uint32_t Hash(std::uint32_t sequence) noexcept {
+        return (sequence * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    static bool WriteLength(std::uint8_t** op, const std::uint8_t* o_end, std::size_t length) {
+        for (; length >= 255; length -= 255) {
+            if (*op >= o_end) return false;
+            *(*op)++ = 255;
+        }
+        if (*op >= o_end) return false;
+        *(*op)++ = static_cast<std::uint8_t>(length);
+        return true;
+    }
+
+    /**
+     * @brief Write literals followed by a match. match_length 0 writes the last sequence, which has no match.
+     */
+    static bool WriteSequence(std::uint8_t** op, const std::uint8_t* o_end, const std::uint8_t* literals, std::size_t literal_length, std::size_t offset, std::size_t match_length) {
+        if (*op >= o_end) return false;
+        auto* token = (*op)++;
+        const std::size_t match_code = match_length ? match_length - MIN_MATCH : 0;
+        *token = static_cast<std::uint8_t>(((literal_length < 15 ? literal_length : 15) << 4) | (match_code < 15 ? match_code : 15));
+        if (literal_length >= 15 && !WriteLength(op, o_end, literal_length - 15)) return false;
+        if (literal_length > static_cast<std::size_t>(o_end - *op)) return false;
+        std::memcpy(*op, literals, literal_length);
+        *op += literal_length;
+        if (!match_length) return true;
+
+        if (o_end - *op < 2) return false;
+        *(*op)++ = static_cast<std::uint8_t>(offset & 0xFF);
+        *(*op)++ = static_cast<std::uint8_t>(offset >> 8);
+        if (match_code >= 15 && !WriteLength(op, o_end, match_code - 15)) return false;
+        return true;
+    }
+
+};
+
+/**************************************************
+*
+* Codecs known to archive readers by ID
+* The built-in codecs are always registered
+*
+**************************************************/
+class BlockCodecRegistry
+{
+public:
+
+    BlockCodecRegistry() {
+        Register(std::make_shared<StoreBlockCodec>());
+        Register(std::make_shared<LzBlockCodec>());
+    }
+
+    static BlockCodecRegistry& GetDefault() {
+        static BlockCodecRegistry registry;
+        return registry;
+    }
+
+    /**
+     * @brief Add a codec. Replaces a codec with the same ID.
+     */
+    void Register(std::shared_ptr<const IBlockCodec> codec) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_spCodecs[codec->GetID()] = std::move(codec);
+    }
+
+    /**
+     * @return nullptr if no codec has the ID.
+     */
+    std::shared_ptr<const IBlockCodec> Find(std::uint32_t id) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (auto iter = m_spCodecs.find(id); iter != m_spCodecs.end()) {
+            return iter->second;
+        }
+        return nullptr;
+    }
+
+private:
+
+    mutable std::mutex                                                    m_mutex;
+    std::unordered_map<std::uint32_t, std::shared_ptr<const IBlockCodec>> m_spCodecs;
+
+};
+
+#endif
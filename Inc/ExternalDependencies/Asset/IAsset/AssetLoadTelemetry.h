@@ -0,0 +1,428 @@
+﻿#pragma once
+
+#ifndef GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_IASSET_ASSETLOADTELEMETRY_H_
+#define GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_IASSET_ASSETLOADTELEMETRY_H_
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+
+/**************************************************
+*
+* Timings of one asset load
+* Times are steady clock nanoseconds. A load waits
+* in a queue, reads its bytes, possibly waits again
+* for a worker and then parses them
+*
+**************************************************/
+struct AssetLoadRecord {
+    std::string   name;
+    std::int64_t  requestNS    = 0; // Load was asked for
+    std::int64_t  ioBeginNS    = 0; // Reading started
+    std::int64_t  ioEndNS      = 0; // Bytes were available
+    std::int64_t  parseBeginNS = 0; // Building the asset started
+    std::int64_t  endNS        = 0;
+    std::uint64_t bytes        = 0; // Bytes read, the file size if the load did not report them
+    std::uint64_t thread       = 0; // Hash of the id of the thread that parsed
+    bool          isSucceeded  = false;
+
+    std::int64_t GetQueueWaitNS() const noexcept {
+        return (ioBeginNS - requestNS) + (parseBeginNS - ioEndNS);
+    }
+    std::int64_t GetIoNS() const noexcept {
+        return ioEndNS - ioBeginNS;
+    }
+    std::int64_t GetParseNS() const noexcept {
+        return endNS - parseBeginNS;
+    }
+    std::int64_t GetTotalNS() const noexcept {
+        return endNS - requestNS;
+    }
+};
+
+/**************************************************
+*
+* Histogram with power of two buckets
+* Bucket 0 counts zeros, bucket i values in
+* [2^(i-1), 2^i)
+*
+**************************************************/
+class AssetLoadHistogram
+{
+public:
+
+    static constexpr std::size_t BUCKET_COUNT = 65;
+
+    void Add(std::uint64_t value) noexcept {
+        ++m_buckets[GetBucket(value)];
+        ++m_count;
+        m_sum += value;
+        m_max = (std::max)(m_max, value);
+    }
+
+    std::uint64_t GetCount() const noexcept {
+        return m_count;
+    }
+    std::uint64_t GetSum() const noexcept {
+        return m_sum;
+    }
+    std::uint64_t GetMax() const noexcept {
+        return m_max;
+    }
+    double GetMean() const noexcept {
+        return m_count ? static_cast<double>(m_sum) / static_cast<double>(m_count) : 0.0;
+    }
+
+    /**
+     * @brief Upper bound of the bucket the percentile falls in, never more than the maximum.
+     * @param percentile 0 to 100.
+     */
+    std::uint64_t GetPercentile(double percentile) const noexcept {
+        if (!m_count) return 0;
+        const auto rank = static_cast<std::uint64_t>(static_cast<double>(m_count) * percentile / 100.0);
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += m_buckets[i];
+            if (seen > rank || seen == m_count) {
+                return (std::min)(GetBucketUpperBound(i), m_max);
+            }
+        }
+        return m_max;
+    }
+
+    const std::array<std::uint64_t, BUCKET_COUNT>& GetBuckets() const noexcept {
+        return m_buckets;
+    }
+
+    static std::size_t GetBucket(std::uint64_t value) noexcept {
+        std::size_t bucket = 0;
+        for (; value; value >>= 1) {
+            ++bucket;
+        }
+        return bucket;
+    }
+    /**
+     * @brief Largest value of a bucket.
+     */
+    static std::uint64_t GetBucketUpperBound(std::size_t bucket) noexcept {
+        return bucket >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << bucket) - 1;
+    }
+
+    nlohmann::json ToJson() const {
+        nlohmann::json buckets = nlohmann::json::array();
+        for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+            if (m_buckets[i]) {
+                buckets.push_back({ GetBucketUpperBound(i), m_buckets[i] });
+            }
+        }
+        return {
+            { "count", m_count }, { "sum", m_sum }, { "mean", GetMean() }, { "max", m_max },
+            { "p50", GetPercentile(50) }, { "p90", GetPercentile(90) }, { "p99", GetPercentile(99) },
+            { "buckets", std::move(buckets) },
+        };
+    }
+
+private:
+
+    std::array<std::uint64_t, BUCKET_COUNT> m_buckets = {};
+    std::uint64_t                           m_count   = 0;
+    std::uint64_t                           m_sum     = 0;
+    std::uint64_t                           m_max     = 0;
+
+};
+
+/**************************************************
+*
+* Load records of the assets of a manager and
+* histograms of their phases
+* Assets record themselves from the thread that
+* loaded them. Exported as JSON, CSV or Chrome
+* trace events (chrome://tracing, Perfetto)
+* Histograms count every load, only the latest
+* records are kept so long sessions stay bounded
+*
+**************************************************/
+class AssetLoadTelemetry
+{
+public:
+
+    static constexpr std::size_t DEFAULT_RECORD_CAPACITY = 4096;
+
+    /**
+     * @brief Clock of the records.
+     */
+    static std::int64_t Now() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static std::uint64_t GetThreadID() noexcept {
+        return static_cast<std::uint64_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    }
+
+    void Record(AssetLoadRecord record) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_isEnabled) return;
+        m_queueWait.Add(static_cast<std::uint64_t>((std::max)(record.GetQueueWaitNS(), std::int64_t(0))));
+        m_io.Add(static_cast<std::uint64_t>((std::max)(record.GetIoNS(), std::int64_t(0))));
+        m_parse.Add(static_cast<std::uint64_t>((std::max)(record.GetParseNS(), std::int64_t(0))));
+        m_total.Add(static_cast<std::uint64_t>((std::max)(record.GetTotalNS(), std::int64_t(0))));
+        m_bytes.Add(record.bytes);
+        if (!record.isSucceeded) {
+            ++m_failedCount;
+        }
+        if (!m_recordCapacity) return;
+        if (m_records.size() < m_recordCapacity) {
+            m_records.push_back(std::move(record));
+        }
+        else {
+            // Full, overwrite the oldest
+            m_records[m_oldestRecord] = std::move(record);
+            m_oldestRecord = (m_oldestRecord + 1) % m_recordCapacity;
+        }
+    }
+
+    /**
+     * @brief Keep at most the latest capacity records, older ones are dropped. 0 keeps none, histograms still count
+     *        every load.
+     */
+    void SetRecordCapacity(std::size_t capacity) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto records = GetRecordsLocked();
+        if (records.size() > capacity) {
+            records.erase(records.begin(), records.end() - static_cast<std::ptrdiff_t>(capacity));
+        }
+        m_records        = std::move(records);
+        m_oldestRecord   = 0;
+        m_recordCapacity = capacity;
+    }
+    std::size_t GetRecordCapacity() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_recordCapacity;
+    }
+
+    /**
+     * @brief Stop or resume recording. Enabled by default, a load costs a few clock reads and one lock.
+     */
+    void SetEnabled(bool is_enabled) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isEnabled = is_enabled;
+    }
+    bool IsEnabled() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_isEnabled;
+    }
+
+    /**
+     * @brief Records that are kept, oldest first.
+     */
+    std::vector<AssetLoadRecord> GetRecords() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return GetRecordsLocked();
+    }
+    /**
+     * @brief Number of records that are kept. The histograms have the number of every load.
+     */
+    std::size_t GetCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_records.size();
+    }
+    std::size_t GetFailedCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_failedCount;
+    }
+
+    AssetLoadHistogram GetQueueWaitHistogram() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_queueWait;
+    }
+    AssetLoadHistogram GetIoHistogram() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_io;
+    }
+    AssetLoadHistogram GetParseHistogram() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_parse;
+    }
+    AssetLoadHistogram GetTotalHistogram() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_total;
+    }
+    AssetLoadHistogram GetBytesHistogram() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_bytes;
+    }
+
+    /**
+     * @brief Records sorted by a key, the largest first. e.g. GetSlowest(10, &AssetLoadRecord::GetTotalNS)
+     */
+    template<class Key>
+    std::vector<AssetLoadRecord> GetSlowest(std::size_t count, Key&& key) const {
+        auto records = GetRecords();
+        std::sort(records.begin(), records.end(), [&](const AssetLoadRecord& lhs, const AssetLoadRecord& rhs) {
+            return std::invoke(key, lhs) > std::invoke(key, rhs);
+        });
+        if (records.size() > count) {
+            records.resize(count);
+        }
+        return records;
+    }
+
+    void Clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_records.clear();
+        m_oldestRecord = 0;
+        m_failedCount  = 0;
+        m_queueWait    = {};
+        m_io           = {};
+        m_parse        = {};
+        m_total        = {};
+        m_bytes        = {};
+    }
+
+    /**
+     * @brief Histograms and the kept records. count is the number of every load. Times are in nanoseconds, relative
+     *        to the first kept request.
+     */
+    void WriteJson(std::ostream& os) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto origin = GetOriginLocked();
+        nlohmann::json loads = nlohmann::json::array();
+        for (const auto& e : GetRecordsLocked()) {
+            loads.push_back({
+                { "name", e.name }, { "requestNS", e.requestNS - origin }, { "endNS", e.endNS - origin },
+                { "queueWaitNS", e.GetQueueWaitNS() }, { "ioNS", e.GetIoNS() }, { "parseNS", e.GetParseNS() },
+                { "bytes", e.bytes }, { "thread", e.thread }, { "succeeded", e.isSucceeded },
+            });
+        }
+        const nlohmann::json json = {
+            { "count", m_total.GetCount() },
+            { "failedCount", m_failedCount },
+            { "histograms", {
+                { "queueWaitNS", m_queueWait.ToJson() },
+                { "ioNS", m_io.ToJson() },
+                { "parseNS", m_parse.ToJson() },
+                { "totalNS", m_total.ToJson() },
+                { "bytes", m_bytes.ToJson() },
+            } },
+            { "loads", std::move(loads) },
+        };
+        os << json.dump(1) << '\n';
+    }
+
+    /**
+     * @brief One row per kept record. Times are in nanoseconds, relative to the first kept request.
+     */
+    void WriteCsv(std::ostream& os) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto origin = GetOriginLocked();
+        os << "name,request_ns,end_ns,queue_wait_ns,io_ns,parse_ns,bytes,thread,succeeded\n";
+        for (const auto& e : GetRecordsLocked()) {
+            os << '"';
+            for (const auto& c : e.name) {
+                if (c == '"') os << '"';
+                os << c;
+            }
+            os << "\"," << e.requestNS - origin << ',' << e.endNS - origin << ',' << e.GetQueueWaitNS() << ',' << e.GetIoNS() << ','
+               << e.GetParseNS() << ',' << e.bytes << ',' << e.thread << ',' << (e.isSucceeded ? 1 : 0) << '\n';
+        }
+    }
+
+    /**
+     * @brief Queue, I/O and parse spans of each load, on the row of the thread that parsed it.
+     */
+    void WriteChromeTrace(std::ostream& os) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto origin = GetOriginLocked();
+        const auto us = [&](std::int64_t ns) {
+            return static_cast<double>(ns - origin) / 1000.0;
+        };
+
+        std::unordered_map<std::uint64_t, std::size_t> tids;
+        nlohmann::json events = nlohmann::json::array();
+        for (const auto& e : GetRecordsLocked()) {
+            const auto [iter, is_new] = tids.emplace(e.thread, tids.size());
+            if (is_new) {
+                events.push_back({ { "ph", "M" }, { "name", "thread_name" }, { "pid", 0 }, { "tid", iter->second }, { "args", { { "name", "Loader " + std::to_string(iter->second) } } } });
+            }
+            const auto span = [&](const char* category, std::int64_t begin, std::int64_t end) {
+                if (end <= begin) return;
+                events.push_back({
+                    { "ph", "X" }, { "cat", category }, { "name", e.name }, { "pid", 0 }, { "tid", iter->second },
+                    { "ts", us(begin) }, { "dur", static_cast<double>(end - begin) / 1000.0 },
+                    { "args", { { "bytes", e.bytes }, { "succeeded", e.isSucceeded } } },
+                });
+            };
+            span("queue", e.requestNS, e.ioBeginNS);
+            span("io", e.ioBeginNS, e.ioEndNS);
+            span("queue", e.ioEndNS, e.parseBeginNS);
+            span("parse", e.parseBeginNS, e.endNS);
+        }
+        os << nlohmann::json({ { "displayTimeUnit", "ns" }, { "traceEvents", std::move(events) } }).dump() << '\n';
+    }
+
+    bool ExportJson(const std::string& path) const {
+        return Export(path, &AssetLoadTelemetry::WriteJson);
+    }
+    bool ExportCsv(const std::string& path) const {
+        return Export(path, &AssetLoadTelemetry::WriteCsv);
+    }
+    bool ExportChromeTrace(const std::string& path) const {
+        return Export(path, &AssetLoadTelemetry::WriteChromeTrace);
+    }
+
+private:
+
+    std::vector<AssetLoadRecord> GetRecordsLocked() const {
+        std::vector<AssetLoadRecord> records;
+        records.reserve(m_records.size());
+        records.insert(records.end(), m_records.begin() + static_cast<std::ptrdiff_t>(m_oldestRecord), m_records.end());
+        records.insert(records.end(), m_records.begin(), m_records.begin() + static_cast<std::ptrdiff_t>(m_oldestRecord));
+        return records;
+    }
+
+    std::int64_t GetOriginLocked() const noexcept {
+        std::int64_t origin = 0;
+        for (const auto& e : m_records) {
+            if (!origin || e.requestNS < origin) {
+                origin = e.requestNS;
+            }
+        }
+        return origin;
+    }
+
+    bool Export(const std::string& path, void (AssetLoadTelemetry::*write)(std::ostream&) const) const {
+        std::ofstream ofs(path, std::ios::binary);
+        if (!ofs) return false;
+        (this->*write)(ofs);
+        return static_cast<bool>(ofs);
+    }
+
+    mutable std::mutex           m_mutex;
+    bool                         m_isEnabled      = true;
+    std::vector<AssetLoadRecord> m_records;                           // Ring once it reaches the capacity
+    std::size_t                  m_oldestRecord   = 0;
+    std::size_t                  m_recordCapacity = DEFAULT_RECORD_CAPACITY;
+    std::size_t                  m_failedCount    = 0;
+    AssetLoadHistogram           m_queueWait;
+    AssetLoadHistogram           m_io;
+    AssetLoadHistogram           m_parse;
+    AssetLoadHistogram           m_total;
+    AssetLoadHistogram           m_bytes;
+
+};
+
+#endif
@@ -3,11 +3,26 @@
 #ifndef GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_IASSET_IASSETDATA_H_
 #define GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_IASSET_IASSETDATA_H_
 
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
 
+#include "ExternalDependencies/Asset/Archive/AssetArchive.h"
+#include "ExternalDependencies/Asset/IAsset/AssetLoadTelemetry.h"
+#include "Thread/AsyncFileService/AsyncFileService.h"
+#include "Thread/AsyncFileService/MappedFile.h"
+#include "Thread/JobSystem/JobSystem.h"
 #include "Thread/SimpleThreadManager/SimpleUniqueThread.h"
+#include "Utility/Assert.h"
 
 
 /**************************************************
@@ -21,7 +36,7 @@ class IAssetData
 {
 public:
 
-    using AssetClassT = typename AssetClass;
+    using AssetClassT = AssetClass;
 
     IAssetData(std::string_view path)
         : m_isLoaded(false)
@@ -36,19 +51,216 @@ public:
 
     virtual bool Load() = 0;
 
-    virtual void AsyncLoad(bool force = false) final {
-        if (!m_thread.IsEnd()) return;
-        if ((!m_thread.IsExists() && !m_isFirstTimeLoaded) || force) {
-            m_thread.CreateAutoEnd(&IAssetData::Load, this);
+    /**
+     * @brief Load unless the asset is already loaded successfully, or force. Loads through here run one at a time.
+     * @details A call while another thread loads the asset waits for that load and returns its result instead of
+     *          reading the file again, forced or not. A call nested in the load on the same thread, from a job run
+     *          while the load waits, cannot wait for itself and returns false.
+     */
+    virtual bool EnsureLoaded(bool force = false) final {
+        WaitLoad();
+        std::unique_lock<std::mutex> lock(m_ensureLoadMutex);
+        if (m_isEnsureLoading && m_ensureLoadThread == std::this_thread::get_id()) {
+            return false;
         }
+        const bool was_loading = m_isEnsureLoading;
+        m_ensureLoadCondition.wait(lock, [this] { return !m_isEnsureLoading; });
+        if (was_loading || (!force && IsLoaded() && m_isLoadSuccessed)) {
+            return m_isLoadSuccessed;
+        }
+        m_isEnsureLoading  = true;
+        m_ensureLoadThread = std::this_thread::get_id();
+        lock.unlock();
+
+        struct LoadingGuard {
+            IAssetData& asset;
+            ~LoadingGuard() {
+                {
+                    std::lock_guard<std::mutex> lock(asset.m_ensureLoadMutex);
+                    asset.m_isEnsureLoading = false;
+                }
+                asset.m_ensureLoadCondition.notify_all();
+            }
+        } guard{ *this };
+        return Load();
+    }
+
+    /**
+     * @brief Build the asset from the bytes of its file. Assets that cannot load from memory return false.
+     */
+    virtual bool LoadFromMemory(std::string_view) {
+        return false;
+    }
+
+    /**
+     * @brief Read the file through an AsyncFileService and build the asset from memory on the calling thread.
+     */
+    virtual bool LoadFromFile(AsyncFileService& service = AsyncFileService::GetDefault()) final {
+        return LoadProcess([&] {
+            auto file = service.ReadFile(m_filePath);
+            file.Wait();
+            EndLoadRead(file.GetData().size());
+            return file.IsSucceeded() && LoadFromMemory(file.GetData());
+        });
+    }
+
+    /**
+     * @brief Map the file and build the asset straight from the mapping, without copying it into a buffer.
+     * @details Assets that come from the same file share one mapping through the cache.
+     */
+    virtual bool LoadFromMappedFile(MappedFileCache& cache = MappedFileCache::GetDefault()) final {
+        return LoadProcess([&] {
+            auto file = cache.Open(m_filePath);
+            EndLoadRead(file ? file->GetView().size() : 0);
+            return file && LoadFromMemory(file->GetView());
+        });
+    }
+
+    /**
+     * @brief Load from a file that may still be being written, e.g. by an editor on hot reload.
+     * @details Load by default. Assets whose Load maps the file override it to read into a buffer, a mapping of a
+     *          file that is truncated meanwhile faults instead of failing the load.
+     */
+    virtual bool LoadFromChangedFile() {
+        return Load();
+    }
+
+    /**
+     * @brief Read the asset from an entry of a packed archive instead of its file.
+     * @details LoadFromArchive reads from it, as does Load of assets that support archives (JsonData).
+     */
+    virtual void SetArchiveSource(std::shared_ptr<const AssetArchive> archive, std::string_view name) final {
+        m_spArchive   = std::move(archive);
+        m_archiveName = name;
+    }
+    virtual bool IsArchived() const noexcept final {
+        return m_spArchive != nullptr;
+    }
+
+    /**
+     * @brief Build the asset from its archive entry. Stored entries are a span of the mapped archive, nothing is
+     *        copied. Compressed entries are decompressed block by block on the default job system.
+     */
+    virtual bool LoadFromArchive() final {
+        return LoadProcess([&] {
+            AssetArchive::Entry entry;
+            if (!m_spArchive || !m_spArchive->Find(m_archiveName, &entry)) return false;
+            std::string buffer;
+            std::string_view bytes;
+            if (!AssetArchive::GetBytes(entry, &buffer, &bytes, &JobSystem::GetDefault())) return false;
+            EndLoadRead(bytes.size());
+            return LoadFromMemory(bytes);
+        });
+    }
+
+    virtual CompletionHandle AsyncLoad(bool force = false) final {
+        if (!m_fileLoadCompletion.IsReady()) return m_fileLoadCompletion;
+        if (!m_thread.IsEnd()) return m_thread.GetCompletion();
+        if (!m_isFirstTimeLoaded || force) {
+            m_isFirstTimeLoaded = true;
+            MarkLoadRequested();
+            return m_thread.CreateAutoEnd(&IAssetData::Load, this);
+        }
+        return m_thread.GetCompletion();
+    }
+
+    /**
+     * @brief Read the file through an AsyncFileService and build the asset from memory on a JobSystem worker.
+     * @details No thread is created per asset, so loading many small assets is bounded by the batched I/O instead.
+     */
+    virtual CompletionHandle AsyncLoadFromFile(bool force = false, AsyncFileService& service = AsyncFileService::GetDefault(), JobSystem& job_system = JobSystem::GetDefault()) final {
+        if (!m_fileLoadCompletion.IsReady()) return m_fileLoadCompletion;
+        if (!m_thread.IsEnd()) return m_thread.GetCompletion();
+        if (!m_isFirstTimeLoaded || force) {
+            m_isFirstTimeLoaded = true;
+            m_isLoaded          = false;
+            MarkLoadRequested();
+            CompletionSource source;
+            m_fileLoadCompletion = source.GetHandle();
+            m_loadTiming.ioBeginNS = m_loadTiming.requestNS;
+            service.ReadFile(m_filePath, [this, source, &job_system](FileReadHandle file) {
+                EndLoadRead(file.GetData().size());
+                // Parsing is left to the pool, the I/O thread only moves bytes
+                job_system.Submit([this, source, file] {
+                    // Ready even if the load throws, IsLoaded, WaitLoad and the destructor wait for it
+                    struct ReadyGuard {
+                        const CompletionSource& source;
+                        ~ReadyGuard() {
+                            source.SetReady();
+                        }
+                    } guard{ source };
+                    LoadProcess([&] {
+                        try {
+                            return file.IsSucceeded() && LoadFromMemory(file.GetData());
+                        }
+                        catch (const std::exception& e) {
+                            assert::ShowError(ASSERT_FILE_LINE, "Load of " + m_filePath + " threw an exception: " + std::string(e.what()));
+                            return false;
+                        }
+                    });
+                });
+            });
+        }
+        return m_fileLoadCompletion;
     }
 
     virtual bool IsLoaded() const noexcept final {
-        return m_thread.IsExists() ? m_thread.IsEnd() : m_isLoaded;
+        if (!m_fileLoadCompletion.IsReady()) return false;
+        return m_thread.IsExists() ? m_thread.IsEnd() : m_isLoaded.load();
+    }
+
+    /**
+     * @brief Block until an async load has finished. Does not spin.
+     */
+    virtual void WaitLoad() const final {
+        m_fileLoadCompletion.Wait();
+        m_thread.GetCompletion().Wait();
     }
 
     virtual bool IsLoadSuccessed() const noexcept final {
-        return m_isLoadSuccessed;
+        return m_isLoadSuccessed.load();
+    }
+
+    /**
+     * @brief Estimate of the memory held by the loaded asset, used for memory budgets.
+     * @details The size of the file by default. Assets that grow a lot when parsed can override it.
+     */
+    virtual std::size_t GetMemorySize() const noexcept {
+        return m_memorySize.load();
+    }
+
+    /**
+     * @brief Free the loaded data and go back to the state before the first load. Waits for a running load.
+     */
+    virtual void Unload() final {
+        Release();
+        if (m_thread.IsExists()) {
+            m_thread.SyncEnd();
+        }
+        m_isLoaded          = false;
+        m_isLoadSuccessed   = false;
+        m_isFirstTimeLoaded = false;
+        m_isLoadedOnlyOnce  = false;
+        m_memorySize        = 0;
+        *m_upAssetData      = AssetClass();
+    }
+
+    /**
+     * @brief Take over the data of another instance that has finished loading. The previous data goes to the other one.
+     * @details A move of the top level object, so it is cheap and leaves no window with a partially parsed asset.
+     *          IsLoadedOnlyOnce fires again afterwards, as it does after the first load.
+     */
+    virtual void SwapLoadedData(IAssetData& loaded) final {
+        Release();
+        loaded.WaitLoad();
+        std::swap(*m_upAssetData, *loaded.m_upAssetData);
+        const auto memory_size = m_memorySize.load();
+        m_memorySize        = loaded.m_memorySize.load();
+        loaded.m_memorySize = memory_size;
+        m_isLoadSuccessed   = loaded.m_isLoadSuccessed.load();
+        m_isLoaded          = true;
+        m_isFirstTimeLoaded = true;
+        m_isLoadedOnlyOnce  = false;
     }
 
     virtual bool IsLoadedOnlyOnce() noexcept final {
@@ -67,40 +279,148 @@ public:
         return m_filePath;
     }
 
+    /**
+     * @brief Record every load of the asset in a telemetry, under the given name.
+     */
+    virtual void SetLoadTelemetry(std::shared_ptr<AssetLoadTelemetry> telemetry, std::string_view name) final {
+        m_spLoadTelemetry = std::move(telemetry);
+        m_telemetryName   = name;
+    }
+
+    /**
+     * @brief Called on the loading thread after every load, failed ones included. Set before the first load.
+     */
+    virtual void SetLoadedCallback(std::function<void()> callback) final {
+        m_loadedCallback = std::move(callback);
+    }
+
+    /**
+     * @brief Start the queue wait of the next load now, for loads that are queued before they run (bulk loads).
+     *        Not needed for AsyncLoad, which marks it itself. Ignored while the asset is loading, the running load
+     *        keeps its own timing and a load that joins it reads nothing.
+     */
+    virtual void MarkLoadRequested() noexcept final {
+        if (!m_fileLoadCompletion.IsReady() || !m_thread.IsEnd()) return;
+        std::lock_guard<std::mutex> lock(m_ensureLoadMutex);
+        if (!m_isEnsureLoading && !m_loadTiming.requestNS) {
+            m_loadTiming.requestNS = AssetLoadTelemetry::Now();
+        }
+    }
+
     const auto& GetData() const noexcept {
         return m_upAssetData;
     }
 
 protected:
 
+    /**
+     * @brief Call from a load once its bytes have been read, the rest of the load counts as parsing.
+     * @details Loads that never call it are recorded as all parsing, with the size of the file as bytes.
+     */
+    void EndLoadRead(std::size_t bytes) noexcept {
+        m_loadTiming.ioEndNS      = AssetLoadTelemetry::Now();
+        m_loadTiming.parseBeginNS = m_loadTiming.ioEndNS;
+        m_loadTiming.bytes        = bytes;
+        m_loadTiming.isRead       = true;
+    }
+
     template<class Func>
     bool LoadProcess(Func&& func) {
         m_isLoaded = false;
         m_isFirstTimeLoaded = true;
 
+        const auto start = AssetLoadTelemetry::Now();
+        if (!m_loadTiming.requestNS) {
+            m_loadTiming.requestNS = start;
+        }
+        if (m_loadTiming.isRead) {
+            // Read before the load ran (AsyncLoadFromFile), the gap until now was a wait for a worker
+            m_loadTiming.parseBeginNS = start;
+        }
+        else {
+            m_loadTiming.ioBeginNS = start;
+        }
+
         m_isLoadSuccessed = func();
 
+        std::size_t memory_size = 0;
+        if (m_isLoadSuccessed) {
+            AssetArchive::Entry entry;
+            std::error_code error;
+            if (m_spArchive && m_spArchive->Find(m_archiveName, &entry)) {
+                memory_size = static_cast<std::size_t>(entry.size);
+            }
+            else if (const auto file_size = std::filesystem::file_size(m_filePath, error); !error) {
+                memory_size = static_cast<std::size_t>(file_size);
+            }
+        }
+        m_memorySize = memory_size;
+
+        RecordLoad(memory_size);
+
         m_isLoaded = true;
+        if (m_loadedCallback) {
+            m_loadedCallback();
+        }
 
         return m_isLoadSuccessed;
     }
 
+    void RecordLoad(std::size_t memory_size) {
+        auto timing = std::exchange(m_loadTiming, LoadTiming{});
+        if (!m_spLoadTelemetry) return;
+        AssetLoadRecord record;
+        record.name         = m_telemetryName.empty() ? m_filePath : m_telemetryName;
+        record.requestNS    = timing.requestNS;
+        record.ioBeginNS    = timing.ioBeginNS;
+        record.ioEndNS      = timing.isRead ? timing.ioEndNS : timing.ioBeginNS;
+        record.parseBeginNS = timing.isRead ? timing.parseBeginNS : timing.ioBeginNS;
+        record.endNS        = AssetLoadTelemetry::Now();
+        record.bytes        = timing.isRead ? timing.bytes : memory_size;
+        record.thread       = AssetLoadTelemetry::GetThreadID();
+        record.isSucceeded  = m_isLoadSuccessed;
+        m_spLoadTelemetry->Record(std::move(record));
+    }
+
     void Release() {
-        if (m_thread.IsExists()) {
-            while (true) {
-                if (m_thread.IsEnd()) break;
-            }
-        }
+        // The load thread writes into this object, so it has to finish before destruction
+        m_fileLoadCompletion.Wait();
+        m_thread.GetCompletion().Wait();
     }
 
-    SimpleUniqueThread                m_thread;
-    bool                              m_isLoaded          = false;
-    bool                              m_isLoadSuccessed   = false;
-    bool                              m_isFirstTimeLoaded = false;
-    bool                              m_isLoadedOnlyOnce  = false;
+    SimpleUniqueThread                  m_thread;
+    CompletionHandle                    m_fileLoadCompletion;
+    std::atomic<bool>                   m_isLoaded          = false;
+    std::atomic<bool>                   m_isLoadSuccessed   = false;
+    std::atomic<bool>                   m_isFirstTimeLoaded = false;
+    std::atomic<std::size_t>            m_memorySize        = 0;
+    bool                                m_isLoadedOnlyOnce  = false;
+
+    const std::string                   m_filePath;
+    std::shared_ptr<const AssetArchive> m_spArchive         = nullptr;
+    std::string                         m_archiveName;
+    const std::unique_ptr<AssetClass>   m_upAssetData       = nullptr;
+
+private:
+
+    struct LoadTiming {
+        std::int64_t requestNS    = 0;
+        std::int64_t ioBeginNS    = 0;
+        std::int64_t ioEndNS      = 0;
+        std::int64_t parseBeginNS = 0;
+        std::size_t  bytes        = 0;
+        bool         isRead       = false;
+    };
+
+    LoadTiming                          m_loadTiming;       // Of the load in progress, written by one thread at a time
+    std::shared_ptr<AssetLoadTelemetry> m_spLoadTelemetry   = nullptr;
+    std::string                         m_telemetryName;
+    std::function<void()>               m_loadedCallback;
 
-    const std::string                 m_filePath;
-    const std::unique_ptr<AssetClass> m_upAssetData       = nullptr;
+    std::mutex                          m_ensureLoadMutex;
+    std::condition_variable             m_ensureLoadCondition;
+    bool                                m_isEnsureLoading   = false; // An EnsureLoaded is loading
+    std::thread::id                     m_ensureLoadThread;         // Of that load
 
 };
 
@@ -3,12 +3,29 @@
 #ifndef GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_IASSET_IASSETMANAGER_H_
 #define GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_IASSET_IASSETMANAGER_H_
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <queue>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include "Thread/AsyncFileService/FileWatcher.h"
+#include "Thread/JobSystem/JobSystem.h"
+#include "Thread/SimpleThreadManager/CompletionHandle.h"
+#include "Thread/TaskGraph/TaskGraph.h"
 #include "Utility/Assert.h"
+#include "Utility/StringIdMap.h"
+#include "ExternalDependencies/Asset/IAsset/AssetLoadTelemetry.h"
 #include "ExternalDependencies/Asset/Json/JsonData.h"
 
 #pragma warning(push)
@@ -26,7 +43,50 @@ class IAssetManager
 {
 public:
 
-    using AssetDataImplT = typename AssetDataImpl;
+    using AssetDataImplT = AssetDataImpl;
+
+    /**
+     * @brief Aggregate progress of a bulk load.
+     */
+    struct LoadProgress {
+        std::size_t totalCount  = 0;
+        std::size_t loadedCount = 0; // Finished, including failures
+        std::size_t failedCount = 0;
+
+        bool IsDone() const noexcept {
+            return loadedCount >= totalCount;
+        }
+        float GetRatio() const noexcept {
+            return totalCount ? static_cast<float>(loadedCount) / static_cast<float>(totalCount) : 1.0f;
+        }
+    };
+
+    /**
+     * @brief Options of a bulk load.
+     */
+    struct BulkLoadOptions {
+        JobSystem*                                pJobSystem      = nullptr; // nullptr uses JobSystem::GetDefault()
+        std::size_t                               maxConcurrentIO = 16;      // Assets being loaded at once
+        std::function<void(const LoadProgress&)> onProgress;                 // Called after each asset, from the loading thread
+    };
+
+    /**
+     * @brief Options of the request queue.
+     */
+    struct RequestOptions {
+        JobSystem*  pJobSystem      = nullptr; // nullptr uses JobSystem::GetDefault()
+        std::size_t maxConcurrentIO = 4;       // Requests being loaded at once
+    };
+
+    enum class RequestStatus {
+        QUEUED,
+        LOADING,
+        LOADED,    // Finished, successfully or not
+        CANCELLED, // Every caller cancelled before the load started
+    };
+
+    class AssetHandle;
+    class AssetRequest;
 
     IAssetManager() {}
     virtual ~IAssetManager() {
@@ -40,72 +100,173 @@ public:
             return;
         }
         for (const auto& e : json_data->GetData()->at("list")) {
-            auto name = e.at("name").get<std::string>();
-            auto path = e.at("path").get<std::string>();
-            auto asset_data = std::make_unique<AssetDataImpl>(path);
-            m_upAssets.emplace(name, std::move(asset_data));
+            RegisterEntry(e.at("name").get<std::string>(), e);
         }
     }
     virtual void Register(const std::unordered_map<std::string, std::unique_ptr<JsonData>>& jsons, std::initializer_list<std::string_view> keys = {}) {
         for (const auto& e : jsons) {
-            auto& json_data = e.second;
-            if (!json_data->IsLoaded()) {
-                assert::ShowWarning(ASSERT_FILE_LINE, "json data not loaded. Load (loading may take some time.)");
-                if (!json_data->Load()) {
-                    assert::ShowError(ASSERT_FILE_LINE, "Path not found: " + std::string(json_data->GetFilePath()));
-                    break;
-                }
-            }
+            if (!LoadRegisterSource(*e.second)) break;
+            if (!e.second->IsLoadSuccessed()) continue;
 
+            // Walk the loaded document in place, only the entry the keys lead to is read
+            const nlohmann::json* entry = e.second->GetData().get();
+            for (const auto& key : keys) {
+                auto iter = entry->find(key);
+                if (iter == entry->end()) return;
+                entry = &*iter;
+            }
+            RegisterEntry(e.first, *entry);
+        }
+    }
+    /**
+     * @brief Register one asset per json, whose entry ({"path", ...}) is found at a JSON pointer into the document.
+     * @details The documents are navigated in place, so large aggregate documents cost O(depth) per asset rather than
+     *          a copy of the whole document. Jsons without the pointer are skipped with a warning.
+     */
+    virtual void Register(const std::unordered_map<std::string, std::unique_ptr<JsonData>>& jsons, const nlohmann::json::json_pointer& pointer) {
+        for (const auto& e : jsons) {
+            if (!LoadRegisterSource(*e.second)) break;
             if (!e.second->IsLoadSuccessed()) continue;
-            auto copy_data = *e.second->GetData();
-            if (keys.size()) {
-                for (const auto& key : keys) {
-                    if (copy_data.count(key)) {
-                        copy_data = copy_data.at(key.data());
-                    }
-                    else return;
-                }
+
+            const auto& json = *e.second->GetData();
+            if (!json.contains(pointer)) {
+                assert::ShowWarning(ASSERT_FILE_LINE, "Pointer not found: " + pointer.to_string() + " in " + std::string(e.second->GetFilePath()));
+                continue;
             }
-            
-            auto& name = e.first;
-            auto path = copy_data.at("path").get<std::string>();
-            auto asset_data = std::make_unique<AssetDataImpl>(path);
-            m_upAssets.emplace(name, std::move(asset_data));
+            RegisterEntry(e.first, json.at(pointer));
+        }
+    }
+
+    /**
+     * @brief Register every asset of an archive made by AssetArchive::Pack. Loads read from the mapped archive.
+     * @details Settings of the manifest the archive was packed from (priorities, dependencies) apply as with Register.
+     * @return false if the archive could not be opened.
+     */
+    virtual bool RegisterArchive(const std::string& archive_path) {
+        auto archive = std::make_shared<AssetArchive>();
+        if (!archive->Open(archive_path)) {
+            assert::ShowError(ASSERT_FILE_LINE, "Archive could not be opened: " + archive_path);
+            return false;
+        }
+        for (const auto& e : archive->GetManifest()) {
+            auto name = e.at("name").get<std::string>();
+            auto path = e.at("path").get<std::string>();
+            auto asset_data = CreateAssetData(path);
+            asset_data->SetArchiveSource(archive, name);
+            AddAsset(name, std::move(asset_data));
+            RegisterEntryOptions(name, e);
         }
+        return true;
     }
 
     virtual const std::unordered_map<std::string, std::unique_ptr<AssetDataImpl>>& GetAssets() const final {
         return m_upAssets;
     }
-    virtual const std::unique_ptr<AssetDataImpl>& GetAsset(std::string_view name) const final {
-        if (auto iter = m_upAssets.find(name.data()); iter != m_upAssets.end()) {
-            return iter->second;
+    /**
+     * @brief Find an asset by id. Names convert implicitly, keep a StringId (e.g. "player"_sid) for per frame lookups.
+     */
+    virtual const std::unique_ptr<AssetDataImpl>& GetAsset(StringId name) const final {
+        if (auto* entry = m_pAssetsById.Find(name)) {
+            return (*entry)->second;
         }
-        assert::ShowError(ASSERT_FILE_LINE, "Asset not found: " + std::string(name.data()));
+        assert::ShowError(ASSERT_FILE_LINE, "Asset not found: " + name.GetName());
         return nullptr;
     }
-    virtual const typename AssetDataImpl::AssetClassT& operator[](std::string_view name) const final {
+    virtual const typename AssetDataImpl::AssetClassT& operator[](StringId name) const final {
         return *GetAsset(name)->GetData();
     }
 
     virtual void Load() final {
         for (const auto& e : m_upAssets) {
-            if (!e.second->Load()) {
+            if (!e.second->EnsureLoaded(true)) {
                 assert::ShowError(ASSERT_FILE_LINE, "Asset load failed: " + e.first);
             }
         }
     }
-    virtual bool Load(std::string_view name) const final {
+    /**
+     * @brief Load every asset on a JobSystem and block until all of them have finished.
+     * @details Assets are started in descending priority, at most maxConcurrentIO at a time. The calling thread helps.
+     */
+    virtual void Load(const BulkLoadOptions& options) final {
+        AsyncLoadAll(options).Wait();
+    }
+
+    /**
+     * @brief Start loading every asset on a JobSystem. Progress is polled with GetLoadProgress.
+     * @details A fixed number of loader jobs take assets from a list sorted by descending priority, so high priority
+     *          assets (e.g. the title screen) are started first and no more than maxConcurrentIO files are open at once.
+     *          Dependencies are started before the assets that need them and with at least their priority.
+     * @return Handle that is done when every asset has finished.
+     */
+    virtual JobHandle AsyncLoadAll(const BulkLoadOptions& options = {}) final {
+        m_bulkLoad.Wait();
+
+        auto state = std::make_shared<BulkLoadState>();
+        state->options = options;
+        const auto order_keys = GetLoadOrderKeys();
+        for (const auto& e : m_upAssets) {
+            const auto& key = order_keys.at(e.first);
+            state->entries.push_back({ &e.first, e.second.get(), key.priority, key.height });
+            // Skipped for assets still loading, the bulk load joins that load
+            e.second->MarkLoadRequested();
+        }
+        // Dependencies inherit the priority of what needs them and are started before it
+        std::sort(state->entries.begin(), state->entries.end(), [](const BulkLoadEntry& lhs, const BulkLoadEntry& rhs) {
+            if (lhs.priority != rhs.priority) return lhs.priority > rhs.priority;
+            if (lhs.height != rhs.height) return lhs.height < rhs.height;
+            return *lhs.pName < *rhs.pName;
+        });
+
+        m_loadTotalCount  = state->entries.size();
+        m_loadedCount     = 0;
+        m_loadFailedCount = 0;
+
+        auto& job_system = options.pJobSystem ? *options.pJobSystem : JobSystem::GetDefault();
+        m_bulkLoad = job_system.CreateGroup();
+        const std::size_t max_concurrent = options.maxConcurrentIO ? options.maxConcurrentIO : 1;
+        const std::size_t loader_count = (std::min)(max_concurrent, state->entries.size());
+        for (std::size_t i = 0; i < loader_count; ++i) {
+            job_system.Submit(m_bulkLoad, [this, state] {
+                RunBulkLoader(*state);
+            });
+        }
+        return m_bulkLoad;
+    }
+
+    LoadProgress GetLoadProgress() const noexcept {
+        return { m_loadTotalCount.load(), m_loadedCount.load(), m_loadFailedCount.load() };
+    }
+
+    /**
+     * @brief Timings of every load of the assets of this manager, hot reloads included.
+     */
+    AssetLoadTelemetry& GetLoadTelemetry() const noexcept {
+        return *m_spLoadTelemetry;
+    }
+
+    /**
+     * @brief Assets with a higher priority are started first by bulk loads. Also read from "priority" in manifests.
+     */
+    virtual void SetPriority(std::string_view name, int priority) final {
+        m_priorities[std::string(name)] = priority;
+    }
+    virtual int GetPriority(std::string_view name) const final {
+        if (auto iter = m_priorities.find(std::string(name)); iter != m_priorities.end()) {
+            return iter->second;
+        }
+        return 0;
+    }
+
+    virtual bool Load(StringId name) const final {
         if (auto& asset = GetAsset(name); asset) {
-            if (asset->Load()) {
+            if (asset->EnsureLoaded(true)) {
                 return true;
             }
             assert::ShowError(ASSERT_FILE_LINE, "Path not found: " + std::string(GetFilePath(name).data()));
         }
         return false;
     }
-    virtual bool AsyncLoad(std::string_view name, bool force = false) const final {
+    virtual bool AsyncLoad(StringId name, bool force = false) const final {
         if (auto& asset = GetAsset(name); asset) {
             asset->AsyncLoad(force);
             return true;
@@ -113,19 +274,109 @@ public:
         return false;
     }
 
-    virtual bool IsLoaded(std::string_view name) const final {
+    virtual bool IsLoaded(StringId name) const final {
         if (auto& asset = GetAsset(name); asset) {
             return asset->IsLoaded();
         }
         return false;
     }
-    virtual bool IsLoadedOnlyOnce(std::string_view name) const final {
+
+    /**
+     * @brief Make an asset depend on another. Also read from "dependencies" in manifests.
+     */
+    virtual void AddDependency(std::string_view name, std::string_view dependency) final {
+        m_dependencies[std::string(name)].emplace_back(dependency);
+        InvalidateDependencyClosures();
+    }
+    virtual const std::vector<std::string>& GetDependencies(std::string_view name) const final {
+        static const std::vector<std::string> empty;
+        if (auto iter = m_dependencies.find(std::string(name)); iter != m_dependencies.end()) {
+            return iter->second;
+        }
+        return empty;
+    }
+
+    /**
+     * @brief The asset and everything it depends on, dependencies before dependents.
+     * @return Empty if a dependency is missing or the dependencies form a cycle.
+     */
+    virtual std::vector<std::string> GetDependencyClosure(std::string_view name) const final {
+        std::lock_guard<std::mutex> lock(m_closureMutex);
+        std::vector<std::string> closure;
+        for (const auto* e : GetClosureLocked(name).pAssets) {
+            closure.push_back(e->first);
+        }
+        return closure;
+    }
+
+    /**
+     * @brief Check if an asset and its whole dependency closure have loaded successfully.
+     * @details The closure is built once and kept until dependencies or assets are added, so polling every frame
+     *          costs one lookup and a pass over the assets of the closure.
+     */
+    virtual bool IsReady(std::string_view name) const final {
+        std::lock_guard<std::mutex> lock(m_closureMutex);
+        const auto& closure = GetClosureLocked(name);
+        if (closure.pAssets.empty()) return false;
+        for (const auto* e : closure.pAssets) {
+            if (!e->second->IsLoaded() || !e->second->IsLoadSuccessed()) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Load an asset and exactly the assets it depends on, leaves first and in parallel where the graph allows.
+     * @param name Asset to load.
+     * @param force Reload assets of the closure that are already loaded.
+     * @param job_system Job system running the loads.
+     * @return Handle that is done when the whole closure has finished. Invalid if the closure could not be built.
+     * @details The task graph of the closure is built on the first call and reused. Its roots are submitted directly,
+     *          no worker waits for the graph. A call while the same closure is still loading joins that load.
+     */
+    virtual JobHandle AsyncLoadWithDependencies(std::string_view name, bool force = false, JobSystem& job_system = JobSystem::GetDefault()) final {
+        std::lock_guard<std::mutex> lock(m_closureMutex);
+        auto& closure = GetClosureLocked(name);
+        if (closure.pAssets.empty()) {
+            assert::ShowError(ASSERT_FILE_LINE, "Dependency graph of asset is invalid: " + std::string(name));
+            return JobHandle();
+        }
+        if (closure.running.IsValid() && !closure.running.IsDone()) {
+            return closure.running;
+        }
+
+        if (!closure.upGraph || closure.pJobSystem != &job_system) {
+            closure.upGraph    = std::make_unique<TaskGraph>(&job_system);
+            closure.pJobSystem = &job_system;
+            for (std::size_t i = 0; i < closure.pAssets.size(); ++i) {
+                // Node i is asset i of the closure
+                closure.upGraph->AddNode(closure.pAssets[i]->first, [entry = closure.pAssets[i], pClosure = &closure] {
+                    // Closures that share the asset load it once, and never at the same time
+                    if (!entry->second->EnsureLoaded(pClosure->isForced)) {
+                        assert::ShowError(ASSERT_FILE_LINE, "Asset load failed: " + entry->first);
+                    }
+                });
+                for (const auto& e : closure.dependencies[i]) {
+                    closure.upGraph->AddDependency(e, i);
+                }
+            }
+        }
+        closure.isForced = force;
+        closure.running  = closure.upGraph->RunAsync();
+        return closure.running;
+    }
+    virtual bool LoadWithDependencies(std::string_view name, bool force = false, JobSystem& job_system = JobSystem::GetDefault()) final {
+        auto handle = AsyncLoadWithDependencies(name, force, job_system);
+        if (!handle.IsValid()) return false;
+        handle.Wait();
+        return IsReady(name);
+    }
+    virtual bool IsLoadedOnlyOnce(StringId name) const final {
         if (auto& asset = GetAsset(name); asset) {
             return asset->IsLoadedOnlyOnce();
         }
         return false;
     }
-    virtual bool LoadedOnlyOnceReset(std::string_view name) const final {
+    virtual bool LoadedOnlyOnceReset(StringId name) const final {
         if (auto& asset = GetAsset(name); asset) {
             asset->LoadedOnlyOnceReset();
             return true;
@@ -133,28 +384,1096 @@ public:
         return false;
     }
 
-    virtual const std::string GetFilePath(std::string_view name) const final {
+    virtual const std::string GetFilePath(StringId name) const final {
         if (auto& asset = GetAsset(name); asset) {
             return asset->GetFilePath();
         }
         return std::string();
     }
 
-    virtual const std::unique_ptr<typename AssetDataImpl::AssetClassT>& GetData(std::string_view name) const final {
+    virtual const std::unique_ptr<typename AssetDataImpl::AssetClassT>& GetData(StringId name) const final {
         return GetAsset(name)->GetData();
     }
 
-    std::shared_ptr<typename AssetDataImpl::AssetClassT> CopyData(std::string_view name) {
+    /**
+     * @brief Deep copy of the loaded data. Prefer Acquire, which shares the data instead.
+     */
+    std::shared_ptr<typename AssetDataImpl::AssetClassT> CopyData(StringId name) {
         return std::make_shared<typename AssetDataImpl::AssetClassT>(*GetData(name).get());
     }
 
+    /**
+     * @brief Get a counted reference to an asset. The asset is loaded on first access through the handle.
+     * @return Invalid handle if the asset is not registered.
+     */
+    virtual AssetHandle Acquire(StringId name) final {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        auto* entry = m_pAssetsById.Find(name);
+        if (!entry) {
+            assert::ShowError(ASSERT_FILE_LINE, "Asset not found: " + name.GetName());
+            return AssetHandle();
+        }
+        CacheSlot* slot = nullptr;
+        if (auto* slot_entry = m_slots.Find(name)) {
+            slot = *slot_entry;
+        }
+        else {
+            if (m_pFreeSlots.empty()) {
+                m_upSlots.emplace_back(std::make_unique<CacheSlot>());
+                m_pFreeSlots.push_back(m_upSlots.back().get());
+            }
+            slot = m_pFreeSlots.back();
+            m_pFreeSlots.pop_back();
+            slot->pName  = &(*entry)->first;
+            slot->pAsset = (*entry)->second.get();
+            m_slots.TryEmplace(name, slot);
+        }
+        RetainSlotLocked(*slot);
+        return AssetHandle(this, slot, slot->generation.load());
+    }
+
+    /**
+     * @brief Limit the memory of assets that are not referenced by any handle. 0 means no limit.
+     * @details Only assets accessed through handles count towards the budget. When it is exceeded, the least
+     *          recently released assets are unloaded and load again on their next access.
+     */
+    virtual void SetMemoryBudget(std::size_t bytes) final {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        m_memoryBudget = bytes;
+        if (m_memoryBudget) {
+            EvictLocked(m_memoryBudget);
+        }
+    }
+    virtual std::size_t GetMemoryBudget() const final {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        return m_memoryBudget;
+    }
+
+    /**
+     * @brief Memory of the assets accessed through handles that are currently loaded.
+     */
+    virtual std::size_t GetResidentBytes() const final {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        return m_residentBytes;
+    }
+
+    virtual std::size_t GetReferenceCount(StringId name) const final {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        if (auto* slot = m_slots.Find(name)) {
+            return (*slot)->refCount;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Unload every asset accessed through handles that is no longer referenced.
+     */
+    virtual void Trim() final {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        EvictLocked(0);
+    }
+
+    /**
+     * @brief Watch the files of the registered assets and load the ones that change again.
+     * @details A changed asset is loaded on the watcher thread into a separate instance, readers keep seeing the old
+     *          data until UpdateHotReload swaps the new data in. Assets registered later are watched too. If a changed
+     *          file fails to load (e.g. saved halfway through an edit) the previous data is kept. Assets read from an
+     *          archive are not watched, the archive is what they were built from.
+     * @param debounce Quiet time after the last change before the changed files are loaded.
+     */
+    virtual void EnableHotReload(std::chrono::milliseconds debounce = std::chrono::milliseconds(50)) final {
+        if (m_upFileWatcher) return;
+        FileWatcher::Options options;
+        options.debounce = debounce;
+        m_upFileWatcher = std::make_unique<FileWatcher>([this](const std::vector<std::string>& paths) {
+            ReloadChangedFiles(paths);
+        }, options);
+        for (const auto& e : m_upAssets) {
+            WatchAsset(e.first);
+        }
+    }
+    virtual void DisableHotReload() final {
+        m_upFileWatcher = nullptr;
+        std::lock_guard<std::mutex> lock(m_hotReloadMutex);
+        m_hotReloadAssets.clear();
+        m_upReloadedAssets.clear();
+    }
+    virtual bool IsHotReloadEnabled() const noexcept final {
+        return m_upFileWatcher != nullptr;
+    }
+
+    /**
+     * @brief Swap in the assets that were reloaded since the last call. Call it once a frame on the thread that reads the assets.
+     * @return Number of assets swapped in. IsLoadedOnlyOnce fires for each of them.
+     */
+    virtual std::size_t UpdateHotReload() final {
+        std::vector<std::pair<std::string, std::unique_ptr<AssetDataImpl>>> reloaded;
+        {
+            std::lock_guard<std::mutex> lock(m_hotReloadMutex);
+            reloaded.swap(m_upReloadedAssets);
+        }
+        std::size_t count = 0;
+        for (auto&& e : reloaded) {
+            if (auto iter = m_upAssets.find(e.first); iter != m_upAssets.end()) {
+                iter->second->SwapLoadedData(*e.second);
+                OnSlotReloaded(StringId(e.first));
+                OnAssetLoaded(&*iter);
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * @brief Work done on the main thread for each loaded asset, e.g. GPU uploads or building derived data.
+     * @details Called from UpdateFinalization for every successful load, reloads and hot reloads included. Assets
+     *          that are loading again are left for a later call. A finalizer must not run while the same asset is
+     *          force reloaded (AsyncLoad(true) from another thread), the reload rewrites the data it reads.
+     */
+    using Finalizer = std::function<void(const std::string& name, AssetDataImpl& asset)>;
+
+    virtual void SetFinalizer(Finalizer finalizer) final {
+        m_finalizer = std::move(finalizer);
+    }
+
+    /**
+     * @brief Finalize loaded assets until the time budget is spent. Call it once a frame from the main loop.
+     * @details Assets are taken in descending priority, then in the order they finished loading. Assets left over
+     *          are carried to the next call. The next asset is only started if the average finalize time still
+     *          fits in the budget, so a frame overruns only when a single finalizer takes longer than the budget;
+     *          one asset is always finalized per call so large assets still make progress.
+     * @return Number of assets finalized.
+     */
+    virtual std::size_t UpdateFinalization(std::chrono::microseconds budget) final {
+        const auto start = std::chrono::steady_clock::now();
+        const auto budget_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(budget).count();
+        CollectLoadedAssets();
+
+        std::size_t count = 0;
+        std::vector<FinalizeEntry> deferred;
+        while (!m_finalizeQueue.empty()) {
+            const auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            if (count && elapsed_ns + m_finalizeCostNS > budget_ns) break;
+
+            const auto entry = m_finalizeQueue.top();
+            m_finalizeQueue.pop();
+            if (!entry.pAsset->second->IsLoaded()) {
+                // Reloading, or its loading thread has not ended yet. Kept queued for the next call
+                deferred.push_back(entry);
+                continue;
+            }
+            auto& state = m_finalizeStates[entry.id];
+            state.isQueued = false;
+            if (!entry.pAsset->second->IsLoadSuccessed()) continue;
+
+            const auto finalize_start = std::chrono::steady_clock::now();
+            if (m_finalizer) {
+                m_finalizer(entry.pAsset->first, *entry.pAsset->second);
+            }
+            const auto cost_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - finalize_start).count();
+            // Moving average, so one slow asset does not stall the following frames
+            m_finalizeCostNS = m_finalizeCostNS ? (m_finalizeCostNS * 7 + cost_ns) / 8 : cost_ns;
+            m_finalizeStates[entry.id].isFinalized = true;
+            ++count;
+        }
+        for (auto&& e : deferred) {
+            m_finalizeQueue.push(e);
+        }
+        return count;
+    }
+
+    /**
+     * @brief Check if the last load of an asset that UpdateFinalization has seen was finalized. Main thread only.
+     */
+    virtual bool IsFinalized(StringId name) const final {
+        const auto* state = m_finalizeStates.Find(name);
+        return state && state->isFinalized;
+    }
+
+    /**
+     * @brief Number of loaded assets waiting for UpdateFinalization. Main thread only.
+     */
+    virtual std::size_t GetFinalizationQueueSize() const final {
+        std::lock_guard<std::mutex> lock(m_loadedMutex);
+        return m_finalizeQueue.size() + m_pLoadedAssets.size();
+    }
+
+    /**
+     * @brief Set how requests are loaded. Call it before the first request.
+     */
+    virtual void SetRequestOptions(const RequestOptions& options) final {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        m_requestOptions = options;
+    }
+
+    /**
+     * @brief Queue a load of an asset, with the priority of its manifest entry.
+     */
+    virtual AssetRequest Request(StringId name) final {
+        if (auto* entry = m_pAssetsById.Find(name)) {
+            return Request(name, GetPriority((*entry)->first));
+        }
+        return Request(name, 0);
+    }
+    /**
+     * @brief Queue a load of an asset. Queued requests are loaded in descending priority by a few jobs.
+     * @details Requests for an asset that is queued or loading join that request, so any number of callers cause
+     *          one read; the request takes the highest priority asked for. A bulk load or dependency closure
+     *          loading the asset at the same time shares that read too. An asset that has already loaded
+     *          successfully is not read again, the request is finished at once.
+     * @return Invalid request if the asset is not registered.
+     */
+    virtual AssetRequest Request(StringId name, int priority) final {
+        auto* entry = m_pAssetsById.Find(name);
+        if (!entry) {
+            assert::ShowError(ASSERT_FILE_LINE, "Asset not found: " + name.GetName());
+            return AssetRequest();
+        }
+        auto* asset = (*entry)->second.get();
+
+        std::shared_ptr<RequestState> state;
+        bool is_loader_needed = false;
+        {
+            std::lock_guard<std::mutex> lock(m_requestMutex);
+            if (auto* queued = m_spRequests.Find(name)) {
+                state = *queued;
+                ++state->interest;
+                RaiseRequestLocked(state, priority);
+                return AssetRequest(this, std::move(state));
+            }
+            state = std::make_shared<RequestState>();
+            state->id       = name;
+            state->pAsset   = *entry;
+            state->priority = priority;
+            state->interest = 1;
+            if (asset->IsLoaded() && asset->IsLoadSuccessed()) {
+                state->status = RequestStatus::LOADED;
+                state->completion.SetReady();
+                return AssetRequest(this, std::move(state));
+            }
+            asset->MarkLoadRequested();
+            m_spRequests.TryEmplace(name, state);
+            m_requestQueue.push({ priority, m_requestSequence++, state });
+            ++m_queuedRequestCount;
+
+            const std::size_t max_loaders = m_requestOptions.maxConcurrentIO ? m_requestOptions.maxConcurrentIO : 1;
+            if (m_requestLoaderCount < max_loaders) {
+                ++m_requestLoaderCount;
+                is_loader_needed = true;
+                if (!m_requestLoads.IsValid()) {
+                    m_requestLoads = GetRequestJobSystem().CreateGroup();
+                }
+            }
+        }
+        if (is_loader_needed) {
+            GetRequestJobSystem().Submit(m_requestLoads, [this] {
+                RunRequestLoader();
+            });
+        }
+        return AssetRequest(this, std::move(state));
+    }
+
+    /**
+     * @brief Raise the priority of a queued request, e.g. when its asset becomes visible. Lower priorities are ignored.
+     * @return false if the asset has no queued request.
+     */
+    virtual bool RaiseRequestPriority(StringId name, int priority) final {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        auto* state = m_spRequests.Find(name);
+        return state && RaiseRequestLocked(*state, priority);
+    }
+
+    /**
+     * @brief Cancel every queued request regardless of how many callers wait on it, e.g. when leaving a level.
+     *        Requests that are loading finish.
+     * @return Number of requests cancelled.
+     */
+    virtual std::size_t CancelAllRequests() final {
+        std::vector<std::shared_ptr<RequestState>> cancelled;
+        {
+            std::lock_guard<std::mutex> lock(m_requestMutex);
+            m_spRequests.ForEach([&](StringId, const std::shared_ptr<RequestState>& state) {
+                if (state->status == RequestStatus::QUEUED) {
+                    cancelled.push_back(state);
+                }
+            });
+            for (const auto& e : cancelled) {
+                CancelLocked(*e);
+            }
+        }
+        for (const auto& e : cancelled) {
+            e->completion.SetReady();
+        }
+        return cancelled.size();
+    }
+
+    virtual std::size_t GetQueuedRequestCount() const final {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        return m_queuedRequestCount;
+    }
+
     virtual void Release() noexcept {
+        m_bulkLoad.Wait();
+        CancelAllRequests();
+        m_requestLoads.Wait();
+        InvalidateDependencyClosures();
+        DisableHotReload();
+        {
+            // Outstanding handles turn invalid, slots are kept for reuse
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            for (auto&& e : m_upSlots) {
+                if (e->pAsset) {
+                    ++e->generation;
+                    e->pName      = nullptr;
+                    e->pAsset     = nullptr;
+                    e->refCount   = 0;
+                    e->bytes      = 0;
+                    e->isResident = false;
+                    e->isInLru    = false;
+                    m_pFreeSlots.push_back(e.get());
+                }
+            }
+            m_slots.Clear();
+            m_lru.clear();
+            m_residentBytes = 0;
+        }
+        m_pAssetsById.Clear();
         m_upAssets.clear();
+        {
+            // Assets finishing their loads while being destroyed above still add themselves
+            std::lock_guard<std::mutex> lock(m_loadedMutex);
+            m_pLoadedAssets.clear();
+            m_pLoadedAssetSet.clear();
+        }
+        m_finalizeQueue  = {};
+        m_finalizeStates.Clear();
+        m_priorities.clear();
+        m_dependencies.clear();
     }
 
 protected:
 
+    /**
+     * @brief Create the asset of a manifest entry. Managers whose assets need more than a path override it.
+     */
+    virtual std::unique_ptr<AssetDataImpl> CreateAssetData(const std::string& path) {
+        return std::make_unique<AssetDataImpl>(path);
+    }
+
+    /**
+     * @brief Load a json given to Register if it is not loaded yet.
+     * @return false if it could not be loaded.
+     */
+    bool LoadRegisterSource(JsonData& json_data) {
+        if (json_data.IsLoaded()) return true;
+        assert::ShowWarning(ASSERT_FILE_LINE, "json data not loaded. Load (loading may take some time.)");
+        if (!json_data.Load()) {
+            assert::ShowError(ASSERT_FILE_LINE, "Path not found: " + std::string(json_data.GetFilePath()));
+            return false;
+        }
+        return true;
+    }
+
+    void RegisterEntry(const std::string& name, const nlohmann::json& entry) {
+        auto path = entry.at("path").get<std::string>();
+        AddAsset(name, CreateAssetData(path));
+        RegisterEntryOptions(name, entry);
+    }
+
+    /**
+     * @brief Add an asset and index it by the id of its name. An asset already registered with the name is kept.
+     */
+    void AddAsset(const std::string& name, std::unique_ptr<AssetDataImpl> asset) {
+        asset->SetLoadTelemetry(m_spLoadTelemetry, name);
+        auto* data = asset.get();
+        auto [iter, is_inserted] = m_upAssets.emplace(name, std::move(asset));
+        if (is_inserted) {
+            InvalidateDependencyClosures();
+            m_pAssetsById.TryEmplace(StringIdTable::GetDefault().Intern(name), &*iter);
+            data->SetLoadedCallback([this, entry = &*iter] {
+                OnAssetLoaded(entry);
+            });
+        }
+    }
+
+    /**
+     * @brief Read the optional per asset settings of a manifest entry.
+     */
+    void RegisterEntryOptions(const std::string& name, const nlohmann::json& entry) {
+        if (auto iter = entry.find("priority"); iter != entry.end() && iter->is_number_integer()) {
+            m_priorities[name] = iter->template get<int>();
+        }
+        if (auto iter = entry.find("dependencies"); iter != entry.end() && iter->is_array()) {
+            for (const auto& e : *iter) {
+                AddDependency(name, e.template get<std::string>());
+            }
+        }
+        if (m_upFileWatcher) {
+            WatchAsset(name);
+        }
+    }
+
+    using AssetEntry = typename std::unordered_map<std::string, std::unique_ptr<AssetDataImpl>>::value_type;
+
     std::unordered_map<std::string, std::unique_ptr<AssetDataImpl>> m_upAssets;
+    StringIdMap<AssetEntry*>                                         m_pAssetsById; // Nodes of m_upAssets, which never move
+    std::unordered_map<std::string, int>                             m_priorities;
+    std::unordered_map<std::string, std::vector<std::string>>        m_dependencies;
+
+private:
+
+    struct CacheSlot {
+        const std::string*                       pName      = nullptr;
+        AssetDataImpl*                           pAsset     = nullptr;
+        std::atomic<std::uint32_t>               generation = 0;
+        std::size_t                              refCount   = 0;
+        std::size_t                              bytes      = 0;
+        std::atomic<bool>                        isResident = false; // Loaded and counted in m_residentBytes
+        bool                                     isInLru    = false;
+        typename std::list<CacheSlot*>::iterator lruIter;
+        std::mutex                               loadMutex;
+    };
+
+    bool IsSlotValid(const CacheSlot* slot, std::uint32_t generation) const noexcept {
+        return slot && slot->generation.load(std::memory_order_acquire) == generation;
+    }
+
+    void RetainSlotLocked(CacheSlot& slot) {
+        if (!slot.refCount++ && slot.isInLru) {
+            m_lru.erase(slot.lruIter);
+            slot.isInLru = false;
+        }
+    }
+
+    void RetainSlot(CacheSlot* slot, std::uint32_t generation) {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        if (IsSlotValid(slot, generation)) {
+            RetainSlotLocked(*slot);
+        }
+    }
+
+    void ReleaseSlot(CacheSlot* slot, std::uint32_t generation) {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        if (!IsSlotValid(slot, generation) || --slot->refCount || !slot->isResident) return;
+        slot->lruIter = m_lru.insert(m_lru.end(), slot);
+        slot->isInLru = true;
+        if (m_memoryBudget) {
+            EvictLocked(m_memoryBudget);
+        }
+    }
+
+    const typename AssetDataImpl::AssetClassT& ResolveSlot(CacheSlot* slot, std::uint32_t generation) {
+        if (!IsSlotValid(slot, generation)) {
+            assert::ShowError(ASSERT_FILE_LINE, "Asset handle is invalid");
+            static const typename AssetDataImpl::AssetClassT empty{};
+            return empty;
+        }
+        // The handle keeps the slot referenced, so it cannot be evicted between here and the return
+        if (slot->isResident.load(std::memory_order_acquire)) {
+            return *slot->pAsset->GetData();
+        }
+        std::lock_guard<std::mutex> load_lock(slot->loadMutex);
+        if (!slot->isResident.load(std::memory_order_acquire)) {
+            if (!slot->pAsset->EnsureLoaded()) {
+                // Not resident, the next access tries again
+                assert::ShowError(ASSERT_FILE_LINE, "Asset load failed: " + *slot->pName);
+                return *slot->pAsset->GetData();
+            }
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            slot->bytes = slot->pAsset->GetMemorySize();
+            m_residentBytes += slot->bytes;
+            slot->isResident.store(true, std::memory_order_release);
+            if (m_memoryBudget) {
+                EvictLocked(m_memoryBudget);
+            }
+        }
+        return *slot->pAsset->GetData();
+    }
+
+    /**
+     * @brief Account the new data of a hot reloaded asset accessed through handles. Its size may have changed and
+     *        an evicted asset is resident again after the swap.
+     */
+    void OnSlotReloaded(StringId name) {
+        CacheSlot* slot = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            if (auto* slot_entry = m_slots.Find(name)) {
+                slot = *slot_entry;
+            }
+        }
+        if (!slot) return;
+        // Same order as ResolveSlot, which counts the slot when it loads it
+        std::lock_guard<std::mutex> load_lock(slot->loadMutex);
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        m_residentBytes -= slot->bytes;
+        slot->bytes = slot->pAsset->GetMemorySize();
+        m_residentBytes += slot->bytes;
+        if (!slot->isResident.load(std::memory_order_relaxed)) {
+            slot->isResident.store(true, std::memory_order_release);
+            if (!slot->refCount) {
+                slot->lruIter = m_lru.insert(m_lru.end(), slot);
+                slot->isInLru = true;
+            }
+        }
+        if (m_memoryBudget) {
+            EvictLocked(m_memoryBudget);
+        }
+    }
+
+    /**
+     * @brief Unload unreferenced assets, least recently released first, until the resident memory fits in target.
+     */
+    void EvictLocked(std::size_t target) {
+        while (m_residentBytes > target && !m_lru.empty()) {
+            auto* slot = m_lru.front();
+            m_lru.pop_front();
+            slot->isInLru = false;
+            slot->pAsset->Unload();
+            slot->isResident.store(false, std::memory_order_release);
+            m_residentBytes -= slot->bytes;
+            slot->bytes = 0;
+        }
+    }
+
+    void WatchAsset(const std::string& name) {
+        const auto& asset = m_upAssets.at(name);
+        if (asset->IsArchived()) return;
+        const auto& path = asset->GetFilePath();
+        {
+            std::lock_guard<std::mutex> lock(m_hotReloadMutex);
+            m_hotReloadAssets[FileWatcher::NormalizePath(path)].emplace_back(name, path);
+        }
+        m_upFileWatcher->Watch(path);
+    }
+
+    void ReloadChangedFiles(const std::vector<std::string>& paths) {
+        for (const auto& path : paths) {
+            std::vector<std::pair<std::string, std::string>> assets;
+            {
+                std::lock_guard<std::mutex> lock(m_hotReloadMutex);
+                if (auto iter = m_hotReloadAssets.find(path); iter != m_hotReloadAssets.end()) {
+                    assets = iter->second;
+                }
+            }
+            for (const auto& e : assets) {
+                auto asset = CreateAssetData(e.second);
+                asset->SetLoadTelemetry(m_spLoadTelemetry, e.first);
+                if (!asset->LoadFromChangedFile()) {
+                    assert::ShowWarning(ASSERT_FILE_LINE, "Hot reload failed, keeping the previous data: " + e.first);
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(m_hotReloadMutex);
+                auto iter = std::find_if(m_upReloadedAssets.begin(), m_upReloadedAssets.end(), [&](const auto& reloaded) {
+                    return reloaded.first == e.first;
+                });
+                if (iter != m_upReloadedAssets.end()) {
+                    iter->second = std::move(asset);
+                }
+                else {
+                    m_upReloadedAssets.emplace_back(e.first, std::move(asset));
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Hand a loaded asset to UpdateFinalization. Called on the loading thread, the entry is not read here.
+     * @details An asset is listed once until it is collected, so managers that never call UpdateFinalization hold
+     *          at most one entry per asset.
+     */
+    void OnAssetLoaded(AssetEntry* entry) {
+        std::lock_guard<std::mutex> lock(m_loadedMutex);
+        if (m_pLoadedAssetSet.insert(entry).second) {
+            m_pLoadedAssets.push_back(entry);
+        }
+    }
+
+    /**
+     * @brief Move the assets loaded since the last call into the priority queue. An asset that loaded again before
+     *        it was finalized is queued once.
+     */
+    void CollectLoadedAssets() {
+        std::vector<AssetEntry*> loaded;
+        {
+            std::lock_guard<std::mutex> lock(m_loadedMutex);
+            loaded.swap(m_pLoadedAssets);
+            m_pLoadedAssetSet.clear();
+        }
+        for (auto* e : loaded) {
+            const StringId id(e->first);
+            auto& state = m_finalizeStates[id];
+            state.isFinalized = false;
+            if (state.isQueued) continue;
+            state.isQueued = true;
+            m_finalizeQueue.push({ id, e, GetPriority(e->first), m_finalizeSequence++ });
+        }
+    }
+
+    struct FinalizeEntry {
+        StringId      id;
+        AssetEntry*   pAsset   = nullptr;
+        int           priority = 0;
+        std::uint64_t sequence = 0;
+
+        // Top of the queue is the highest priority, then the first loaded
+        bool operator<(const FinalizeEntry& other) const noexcept {
+            if (priority != other.priority) return priority < other.priority;
+            return sequence > other.sequence;
+        }
+    };
+
+    struct FinalizeState {
+        bool isQueued    = false;
+        bool isFinalized = false;
+    };
+
+    struct RequestState {
+        StringId                   id;
+        AssetEntry*                pAsset   = nullptr;
+        int                        priority = 0;
+        std::size_t                interest = 0; // Requests that have not cancelled
+        std::atomic<RequestStatus> status   = RequestStatus::QUEUED;
+        CompletionSource           completion;
+    };
+
+    struct QueuedRequest {
+        int                           priority = 0;
+        std::uint64_t                 sequence = 0;
+        std::shared_ptr<RequestState> spState;
+
+        // Top of the queue is the highest priority, then the oldest request
+        bool operator<(const QueuedRequest& other) const noexcept {
+            if (priority != other.priority) return priority < other.priority;
+            return sequence > other.sequence;
+        }
+    };
+
+    JobSystem& GetRequestJobSystem() const noexcept {
+        return m_requestOptions.pJobSystem ? *m_requestOptions.pJobSystem : JobSystem::GetDefault();
+    }
+
+    /**
+     * @brief Raising pushes the request again, the old queue entry is skipped when it comes up.
+     */
+    bool RaiseRequestLocked(const std::shared_ptr<RequestState>& state, int priority) {
+        if (state->status != RequestStatus::QUEUED || priority <= state->priority) return false;
+        state->priority = priority;
+        m_requestQueue.push({ priority, m_requestSequence++, state });
+        return true;
+    }
+
+    void CancelLocked(RequestState& state) {
+        state.status = RequestStatus::CANCELLED;
+        --m_queuedRequestCount;
+        m_spRequests.Erase(state.id);
+    }
+
+    /**
+     * @brief Withdraw one caller from a request. The request is cancelled when no caller is left and it has not started.
+     * @return true if the request was still queued.
+     */
+    bool CancelRequest(RequestState& state) {
+        {
+            std::lock_guard<std::mutex> lock(m_requestMutex);
+            if (state.status != RequestStatus::QUEUED) return false;
+            if (--state.interest) return true;
+            CancelLocked(state);
+        }
+        state.completion.SetReady();
+        return true;
+    }
+
+    bool RaiseRequest(const std::shared_ptr<RequestState>& state, int priority) {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        return RaiseRequestLocked(state, priority);
+    }
+
+    void RunRequestLoader() {
+        while (true) {
+            std::shared_ptr<RequestState> state;
+            {
+                std::lock_guard<std::mutex> lock(m_requestMutex);
+                while (!m_requestQueue.empty() && !state) {
+                    auto top = m_requestQueue.top();
+                    m_requestQueue.pop();
+                    // Entries of cancelled requests and superseded priorities are stale
+                    if (top.spState->status == RequestStatus::QUEUED && top.priority == top.spState->priority) {
+                        state = std::move(top.spState);
+                    }
+                }
+                if (!state) {
+                    --m_requestLoaderCount;
+                    return;
+                }
+                state->status = RequestStatus::LOADING;
+                --m_queuedRequestCount;
+            }
+
+            // Shares the load of the asset with bulk loads and dependency closures
+            if (!state->pAsset->second->EnsureLoaded()) {
+                assert::ShowError(ASSERT_FILE_LINE, "Asset load failed: " + state->pAsset->first);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_requestMutex);
+                state->status = RequestStatus::LOADED;
+                m_spRequests.Erase(state->id);
+            }
+            state->completion.SetReady();
+        }
+    }
+
+    struct BulkLoadEntry {
+        const std::string* pName     = nullptr;
+        AssetDataImpl*     pAsset    = nullptr;
+        int                priority  = 0;
+        std::size_t        height    = 0;
+    };
+
+    struct LoadOrderKey {
+        int         priority = 0; // Highest priority of the asset and everything that depends on it
+        std::size_t height   = 0; // Longest dependency chain below the asset, 0 for leaves
+    };
+
+    struct DependencyClosure {
+        std::vector<AssetEntry*>              pAssets;              // Dependencies before dependents
+        std::vector<std::vector<std::size_t>> dependencies;         // Indices into pAssets of the direct dependencies of each
+        std::unique_ptr<TaskGraph>            upGraph    = nullptr; // Built by the first AsyncLoadWithDependencies
+        JobSystem*                            pJobSystem = nullptr; // Of upGraph
+        JobHandle                             running;              // Last run of upGraph
+        bool                                  isForced   = false;   // Of the run in progress
+    };
+
+    /**
+     * @brief Cached closure of an asset, built on first use. Empty if a dependency is missing or forms a cycle.
+     */
+    DependencyClosure& GetClosureLocked(std::string_view name) const {
+        const StringId id(name);
+        if (auto* closure = m_upClosures.Find(id)) {
+            return **closure;
+        }
+        auto closure = std::make_unique<DependencyClosure>();
+        std::vector<std::string> names;
+        std::unordered_map<std::string, bool> visited; // false while on the current path
+        if (CollectClosure(std::string(name), &visited, &names)) {
+            std::unordered_map<std::string_view, std::size_t> indices;
+            for (const auto& e : names) {
+                auto iter = m_upAssets.find(e);
+                std::vector<std::size_t> dependencies;
+                for (const auto& dependency : GetDependencies(e)) {
+                    dependencies.push_back(indices.at(dependency));
+                }
+                indices.emplace(iter->first, closure->pAssets.size());
+                closure->pAssets.push_back(const_cast<AssetEntry*>(&*iter));
+                closure->dependencies.push_back(std::move(dependencies));
+            }
+        }
+        return **m_upClosures.TryEmplace(id, std::move(closure)).first;
+    }
+
+    /**
+     * @brief Drop the cached closures after dependencies or assets changed. Waits for the graphs still running.
+     */
+    void InvalidateDependencyClosures() {
+        std::vector<std::unique_ptr<DependencyClosure>> closures;
+        {
+            std::lock_guard<std::mutex> lock(m_closureMutex);
+            m_upClosures.ForEach([&](StringId, std::unique_ptr<DependencyClosure>& closure) {
+                closures.push_back(std::move(closure));
+            });
+            m_upClosures.Clear();
+        }
+        // Outside the lock, the loads may check IsReady
+        for (auto&& e : closures) {
+            if (e->running.IsValid()) {
+                e->running.Wait();
+            }
+        }
+    }
+
+    bool CollectClosure(const std::string& name, std::unordered_map<std::string, bool>* visited, std::vector<std::string>* closure) const {
+        if (auto iter = visited->find(name); iter != visited->end()) {
+            if (!iter->second) {
+                assert::ShowError(ASSERT_FILE_LINE, "Asset dependency cycle: " + name);
+                return false;
+            }
+            return true;
+        }
+        if (!m_upAssets.count(name)) {
+            assert::ShowError(ASSERT_FILE_LINE, "Asset not found: " + name);
+            (*visited)[name] = true;
+            return false;
+        }
+        (*visited)[name] = false;
+        for (const auto& e : GetDependencies(name)) {
+            if (!CollectClosure(e, visited, closure)) {
+                // Settle the failed path, later walks through it are neither reported again nor taken for a cycle
+                (*visited)[name] = true;
+                return false;
+            }
+        }
+        (*visited)[name] = true;
+        closure->push_back(name);
+        return true;
+    }
+
+    std::unordered_map<std::string, LoadOrderKey> GetLoadOrderKeys() const {
+        std::unordered_map<std::string, LoadOrderKey> keys;
+        std::vector<std::string> order;
+        std::unordered_map<std::string, bool> visited;
+        // In name order, so which asset a broken graph is reported for does not depend on the hash map
+        std::vector<std::string_view> names;
+        for (const auto& e : m_upAssets) {
+            names.push_back(e.first);
+        }
+        std::sort(names.begin(), names.end());
+        for (const auto& e : names) {
+            const std::string name(e);
+            keys[name].priority = GetPriority(name);
+            CollectClosure(name, &visited, &order);
+        }
+        // order has dependencies first: heights forward, priorities pushed down backward
+        for (const auto& name : order) {
+            for (const auto& e : GetDependencies(name)) {
+                if (keys.count(e)) {
+                    keys[name].height = (std::max)(keys[name].height, keys[e].height + 1);
+                }
+            }
+        }
+        for (auto iter = order.rbegin(); iter != order.rend(); ++iter) {
+            for (const auto& e : GetDependencies(*iter)) {
+                if (keys.count(e)) {
+                    keys[e].priority = (std::max)(keys[e].priority, keys[*iter].priority);
+                }
+            }
+        }
+        return keys;
+    }
+
+    struct BulkLoadState {
+        BulkLoadOptions            options;
+        std::vector<BulkLoadEntry> entries;
+        std::atomic<std::size_t>   next = 0;
+        std::mutex                 progressMutex;
+    };
+
+    void RunBulkLoader(BulkLoadState& state) {
+        for (std::size_t i = state.next++; i < state.entries.size(); i = state.next++) {
+            const auto& entry = state.entries[i];
+            if (!entry.pAsset->EnsureLoaded(true)) {
+                ++m_loadFailedCount;
+                assert::ShowError(ASSERT_FILE_LINE, "Asset load failed: " + *entry.pName);
+            }
+            ++m_loadedCount;
+            if (state.options.onProgress) {
+                std::lock_guard<std::mutex> lock(state.progressMutex);
+                state.options.onProgress(GetLoadProgress());
+            }
+        }
+    }
+
+    mutable std::mutex                      m_cacheMutex;
+    std::vector<std::unique_ptr<CacheSlot>> m_upSlots;          // Never freed before the manager, handles point into it
+    std::vector<CacheSlot*>                 m_pFreeSlots;
+    StringIdMap<CacheSlot*>                 m_slots;
+    std::list<CacheSlot*>                   m_lru;              // Unreferenced resident assets, least recently released first
+    std::size_t                             m_memoryBudget  = 0;
+    std::size_t                             m_residentBytes = 0;
+
+    std::unique_ptr<FileWatcher>                                                      m_upFileWatcher;
+    std::mutex                                                                        m_hotReloadMutex;
+    std::unordered_map<std::string, std::vector<std::pair<std::string, std::string>>> m_hotReloadAssets;  // Normalized path to names and paths of its assets
+    std::vector<std::pair<std::string, std::unique_ptr<AssetDataImpl>>>               m_upReloadedAssets; // Waiting for UpdateHotReload
+
+    const std::shared_ptr<AssetLoadTelemetry> m_spLoadTelemetry = std::make_shared<AssetLoadTelemetry>(); // Shared with the assets
+
+    mutable std::mutex                                      m_closureMutex;
+    mutable StringIdMap<std::unique_ptr<DependencyClosure>> m_upClosures; // Of the assets asked for, until dependencies or assets change
+
+    Finalizer                          m_finalizer;
+    mutable std::mutex                 m_loadedMutex;
+    std::vector<AssetEntry*>           m_pLoadedAssets;          // Loaded since the last UpdateFinalization
+    std::unordered_set<AssetEntry*>    m_pLoadedAssetSet;        // Same assets, so each is listed once
+    std::priority_queue<FinalizeEntry> m_finalizeQueue;
+    StringIdMap<FinalizeState>         m_finalizeStates;
+    std::uint64_t                      m_finalizeSequence = 0;
+    std::int64_t                       m_finalizeCostNS   = 0; // Average time of a finalizer
+
+    mutable std::mutex                         m_requestMutex;
+    RequestOptions                             m_requestOptions;
+    StringIdMap<std::shared_ptr<RequestState>> m_spRequests; // Queued or loading, one per asset
+    std::priority_queue<QueuedRequest>         m_requestQueue;
+    std::uint64_t                              m_requestSequence    = 0;
+    std::size_t                                m_queuedRequestCount = 0;
+    std::size_t                                m_requestLoaderCount = 0;
+    JobHandle                                  m_requestLoads;
+
+    JobHandle                m_bulkLoad;
+    std::atomic<std::size_t> m_loadTotalCount  = 0;
+    std::atomic<std::size_t> m_loadedCount     = 0;
+    std::atomic<std::size_t> m_loadFailedCount = 0;
+
+};
+
+/**
+ * @class IAssetManager::AssetHandle
+ * @brief Counted reference to an asset of a manager. Referenced assets are never evicted.
+ * @details Copies share the reference. Evicted assets load again on the next access. A handle turns invalid when
+ *          the manager is released and must not outlive the manager itself.
+ */
+template<class AssetDataImpl>
+class IAssetManager<AssetDataImpl>::AssetHandle
+{
+public:
+
+    AssetHandle() noexcept = default;
+    AssetHandle(const AssetHandle& other)
+        : m_pManager(other.m_pManager)
+        , m_pSlot(other.m_pSlot)
+        , m_generation(other.m_generation)
+    {
+        if (m_pManager) {
+            m_pManager->RetainSlot(m_pSlot, m_generation);
+        }
+    }
+    AssetHandle(AssetHandle&& other) noexcept
+        : m_pManager(std::exchange(other.m_pManager, nullptr))
+        , m_pSlot(std::exchange(other.m_pSlot, nullptr))
+        , m_generation(other.m_generation)
+    {}
+    ~AssetHandle() {
+        Reset();
+    }
+
+    AssetHandle& operator=(AssetHandle other) noexcept {
+        std::swap(m_pManager, other.m_pManager);
+        std::swap(m_pSlot, other.m_pSlot);
+        std::swap(m_generation, other.m_generation);
+        return *this;
+    }
+
+    bool IsValid() const noexcept {
+        return m_pManager && m_pManager->IsSlotValid(m_pSlot, m_generation);
+    }
+
+    /**
+     * @brief Data of the asset, loaded first if it is not resident.
+     */
+    const typename AssetDataImpl::AssetClassT& Get() const {
+        return m_pManager->ResolveSlot(m_pSlot, m_generation);
+    }
+    const typename AssetDataImpl::AssetClassT& operator*() const {
+        return Get();
+    }
+    const typename AssetDataImpl::AssetClassT* operator->() const {
+        return &Get();
+    }
+
+    void Reset() {
+        if (m_pManager) {
+            m_pManager->ReleaseSlot(m_pSlot, m_generation);
+            m_pManager = nullptr;
+            m_pSlot    = nullptr;
+        }
+    }
+
+private:
+
+    friend class IAssetManager<AssetDataImpl>;
+
+    AssetHandle(IAssetManager* manager, CacheSlot* slot, std::uint32_t generation) noexcept
+        : m_pManager(manager)
+        , m_pSlot(slot)
+        , m_generation(generation)
+    {}
+
+    IAssetManager* m_pManager   = nullptr;
+    CacheSlot*     m_pSlot      = nullptr;
+    std::uint32_t  m_generation = 0;
+
+};
+
+/**
+ * @class IAssetManager::AssetRequest
+ * @brief One caller's interest in a queued asset load. Callers asking for the same asset share the load.
+ * @details Move only. Dropping a request does not cancel it, Cancel does. A request must not outlive its manager.
+ */
+template<class AssetDataImpl>
+class IAssetManager<AssetDataImpl>::AssetRequest
+{
+public:
+
+    AssetRequest() noexcept = default;
+    AssetRequest(AssetRequest&&) noexcept = default;
+    AssetRequest& operator=(AssetRequest&&) noexcept = default;
+
+    AssetRequest(const AssetRequest&) = delete;
+    AssetRequest& operator=(const AssetRequest&) = delete;
+
+    bool IsValid() const noexcept {
+        return m_spState != nullptr;
+    }
+
+    RequestStatus GetStatus() const noexcept {
+        return m_spState ? m_spState->status.load() : RequestStatus::CANCELLED;
+    }
+
+    /**
+     * @brief Check if the request has loaded or was cancelled.
+     */
+    bool IsReady() const noexcept {
+        return GetCompletion().IsReady();
+    }
+
+    /**
+     * @brief Check if the request loaded and the load succeeded.
+     */
+    bool IsLoadSuccessed() const noexcept {
+        return GetStatus() == RequestStatus::LOADED && m_spState->pAsset->second->IsLoadSuccessed();
+    }
+
+    /**
+     * @brief Block until the request has loaded or was cancelled.
+     */
+    void Wait() const {
+        GetCompletion().Wait();
+    }
+
+    CompletionHandle GetCompletion() const noexcept {
+        return m_spState ? m_spState->completion.GetHandle() : CompletionHandle();
+    }
+
+    /**
+     * @brief Raise the priority of the shared load while it is queued.
+     * @return false if it is no longer queued or already has a priority at least as high.
+     */
+    bool RaisePriority(int priority) {
+        return m_spState && m_pManager->RaiseRequest(m_spState, priority);
+    }
+
+    /**
+     * @brief Withdraw this caller. The load is cancelled once every caller has withdrawn, unless it already started.
+     * @return false if the load already started or this request was cancelled before.
+     */
+    bool Cancel() {
+        if (!m_spState || m_isCancelled) return false;
+        m_isCancelled = true;
+        return m_pManager->CancelRequest(*m_spState);
+    }
+
+private:
+
+    friend class IAssetManager<AssetDataImpl>;
+
+    AssetRequest(IAssetManager* manager, std::shared_ptr<RequestState> state) noexcept
+        : m_pManager(manager)
+        , m_spState(std::move(state))
+    {}
+
+    IAssetManager*                m_pManager    = nullptr;
+    std::shared_ptr<RequestState> m_spState     = nullptr;
+    bool                          m_isCancelled = false;
 
 };
 
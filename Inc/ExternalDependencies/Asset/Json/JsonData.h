@@ -3,12 +3,13 @@
 #ifndef GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_JSON_JSONDATA_H_
 #define GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_JSON_JSONDATA_H_
 
-#include <fstream>
 #include <memory>
 #include <string>
 #include <unordered_map>
 
 #include "ExternalDependencies/Asset/IAsset/IAssetData.h"
+#include "ExternalDependencies/Asset/Json/JsonParseCache.h"
+#include "ExternalDependencies/Asset/Json/JsonSchemaCache.h"
 
 #include "nlohmann/json.hpp"
 #ifdef ENABLE_JSON_SCHEMA_VALIDATOR
@@ -31,46 +32,63 @@ public:
     
     using Json = nlohmann::json;
     using JsonValidator = nlohmann::json_schema::json_validator;
+    using JsonSchemas = std::unordered_map<std::string, std::shared_ptr<JsonSchema>>;
 
-    JsonData(std::string_view file_path, std::shared_ptr<std::unordered_map<std::string, JsonData::JsonValidator>> validators = nullptr)
+    JsonData(std::string_view file_path, std::shared_ptr<JsonSchemas> schemas = nullptr)
         : IAssetData(file_path)
-        , m_wpValidators(validators)
+        , m_wpSchemas(schemas)
     {}
 
     virtual ~JsonData() override {
         Release();
     }
     
+    /**
+     * @details Documents read from the parse cache skip validation if they passed the same schema when stored.
+     *          Validation runs on the thread that loads, so bulk loads validate one file while parsing the next.
+     */
     bool Load() override {
         return LoadProcess([&] {
             Json json;
-            std::ifstream ifs(m_filePath);
-            if (!ifs) return false;
-            ifs >> json;
-            if (ValidateJson(json)) {
-                *m_upAssetData = json;
-                return true;
+            bool is_cached = false;
+            std::uint64_t validated_schema_hash = 0;
+            JsonParseCache::SourceStamp stamp;
+            if (!ReadJson(&json, &is_cached, &validated_schema_hash, &stamp)) return false;
+            std::uint64_t schema_hash = 0;
+            if (!ValidateJson(json, is_cached ? validated_schema_hash : 0, &schema_hash)) return false;
+            if (!is_cached || validated_schema_hash != schema_hash) {
+                StoreJson(json, stamp, schema_hash);
             }
-            return false;
+            *m_upAssetData = std::move(json);
+            return true;
         });
     }
 
+    bool LoadFromMemory(std::string_view bytes) override {
+        Json json = Json::parse(bytes.begin(), bytes.end(), nullptr, false);
+        std::uint64_t schema_hash = 0;
+        if (json.is_discarded() || !ValidateJson(json, 0, &schema_hash)) return false;
+        *m_upAssetData = std::move(json);
+        return true;
+    }
+
 private:
 
-    bool ValidateJson(const Json& data) const {
-        if (m_wpValidators.expired() || !data.count("schema") || !data.at("schema").is_string()) {
+    /**
+     * @param validated_schema_hash Hash of the schema the document is known to pass, validation is skipped if it matches.
+     * @param schema_hash Receives the hash of the schema of the document, 0 if it has none.
+     */
+    bool ValidateJson(const Json& data, std::uint64_t validated_schema_hash, std::uint64_t* schema_hash) const {
+        *schema_hash = 0;
+        auto schemas = m_wpSchemas.lock();
+        if (!schemas || !data.count("schema") || !data.at("schema").is_string()) {
             return true;
         }
         std::string schema_name = data.at("schema").get<std::string>();
-        if (m_wpValidators.lock()->count(schema_name.data())) {
-            try {
-                m_wpValidators.lock()->at(schema_name.data()).validate(data);
-                return true;
-            }
-            catch (const std::exception& e) {
-                assert::ShowError(ASSERT_FILE_LINE, "Validation of json failed: " + m_filePath + " - " + std::string(e.what()));
-                return false;
-            }
+        if (auto iter = schemas->find(schema_name); iter != schemas->end()) {
+            *schema_hash = iter->second->GetHash();
+            if (validated_schema_hash == *schema_hash) return true;
+            return iter->second->Validate(data, m_filePath);
         }
         else {
             assert::ShowError(ASSERT_FILE_LINE, "Schema name not found: " + m_filePath + " - " + schema_name);
@@ -78,7 +96,7 @@ private:
         }
     }
 
-    std::weak_ptr<std::unordered_map<std::string, JsonData::JsonValidator>> m_wpValidators;
+    std::weak_ptr<JsonSchemas> m_wpSchemas;
     
 #else
 public:
@@ -95,14 +113,81 @@ public:
 
     bool Load() override {
         return LoadProcess([&] {
-            std::ifstream ifs(m_filePath);
-            if (!ifs) return false;
-            ifs >> *m_upAssetData;
+            bool is_cached = false;
+            std::uint64_t validated_schema_hash = 0;
+            JsonParseCache::SourceStamp stamp;
+            if (!ReadJson(m_upAssetData.get(), &is_cached, &validated_schema_hash, &stamp)) return false;
+            if (!is_cached) {
+                StoreJson(*m_upAssetData, stamp, 0);
+            }
             return true;
         });
     }
+
+    bool LoadFromMemory(std::string_view bytes) override {
+        Json json = Json::parse(bytes.begin(), bytes.end(), nullptr, false);
+        if (json.is_discarded()) return false;
+        *m_upAssetData = std::move(json);
+        return true;
+    }
     
 #endif
+
+public:
+
+    /**
+     * @brief Read into a buffer and parse it, skipping the mapping and the parse cache of Load.
+     */
+    bool LoadFromChangedFile() override {
+        return LoadFromFile();
+    }
+
+private:
+
+    /**
+     * @brief Parse the archive entry of archived assets. Otherwise read the document from the parse cache, or parse
+     *        the file.
+     * @param is_cached Receives whether the document came from the parse cache.
+     * @param validated_schema_hash Receives the hash of the schema a cached document passed, 0 otherwise.
+     * @param stamp Receives the stamp of the file taken before it was read, the document is stored in the cache with it.
+     */
+    bool ReadJson(Json* json, bool* is_cached, std::uint64_t* validated_schema_hash, JsonParseCache::SourceStamp* stamp) {
+        *is_cached = false;
+        *validated_schema_hash = 0;
+        *stamp = JsonParseCache::SourceStamp();
+        if (IsArchived()) {
+            AssetArchive::Entry entry;
+            std::string buffer;
+            std::string_view bytes;
+            if (!m_spArchive->Find(m_archiveName, &entry) || !AssetArchive::GetBytes(entry, &buffer, &bytes, &JobSystem::GetDefault())) return false;
+            EndLoadRead(bytes.size());
+            *json = Json::parse(bytes.begin(), bytes.end(), nullptr, false);
+            return !json->is_discarded();
+        }
+        if (JsonParseCache::GetDefault().IsEnabled()) {
+            JsonParseCache::GetSourceStamp(m_filePath, stamp);
+        }
+        if (JsonParseCache::GetDefault().Load(m_filePath, json, validated_schema_hash)) {
+            *is_cached = true;
+            return true;
+        }
+        // Parse straight from the mapping, no stream buffering or copy of the file
+        auto file = MappedFileCache::GetDefault().Open(m_filePath);
+        if (!file) return false;
+        EndLoadRead(file->GetView().size());
+        *json = Json::parse(file->GetView().begin(), file->GetView().end(), nullptr, false);
+        return !json->is_discarded();
+    }
+
+    /**
+     * @brief Store a parsed document in the parse cache with the hash of the schema it passed, 0 if none.
+     */
+    void StoreJson(const Json& json, const JsonParseCache::SourceStamp& stamp, std::uint64_t validated_schema_hash) {
+        if (!IsArchived()) {
+            JsonParseCache::GetDefault().Store(m_filePath, stamp, json, validated_schema_hash);
+        }
+    }
+
 };
 
 #endif
@@ -1,20 +1,38 @@
 ﻿#pragma once
 
+#include <string>
+#include <string_view>
+
+#include "ExternalDependencies/Asset/Json/JsonReflection.h"
+#include "Thread/AsyncFileService/MappedFile.h"
+
 #include "nlohmann/json.hpp"
 
 struct IJsonData {
     virtual void FromJson(const nlohmann::json& json) = 0;
 };
 
+/**************************************************
+*
+* Holds T filled from json
+* T either derives from IJsonData and reads a DOM
+* in FromJson, or is described by
+* MACRO_JSON_REFLECT and can also be read straight
+* from text without a DOM
+*
+**************************************************/
 template <class T>
 class JsonHolder
 {
 public:
 
+    JsonHolder() {
+        static_assert(json_reflection::IsReflectedV<T>, "T must be reflected to be loaded from text");
+    }
     JsonHolder(nlohmann::json* json)
         : m_pJson(json)
     {
-        static_assert(std::is_base_of_v<IJsonData, T>, "T must be derived from IJsonData");
+        static_assert(std::is_base_of_v<IJsonData, T> || json_reflection::IsReflectedV<T>, "T must be derived from IJsonData or reflected");
         Load();
     }
 
@@ -27,8 +45,25 @@ public:
 
     bool Load() {
         if (!m_pJson) return false;
-        m_data.FromJson(*m_pJson);
-        return true;
+        if constexpr (std::is_base_of_v<IJsonData, T>) {
+            m_data.FromJson(*m_pJson);
+            return true;
+        }
+        else {
+            return json_reflection::FromJson(*m_pJson, &m_data);
+        }
+    }
+
+    /**
+     * @brief Fill T from json text through the SAX parser, no DOM is built.
+     */
+    bool LoadFromMemory(std::string_view text) {
+        static_assert(json_reflection::IsReflectedV<T>, "T must be reflected to be loaded from text");
+        return json_reflection::Read(text, &m_data);
+    }
+    bool LoadFromFile(const std::string& path) {
+        MappedFile file;
+        return file.Open(path) && LoadFromMemory(file.GetView());
     }
 
 private:
@@ -24,19 +24,24 @@ class JsonManager : public IAssetManager<JsonData>
 public:
 
     JsonManager()
-        : m_spValidators(std::make_shared<std::unordered_map<std::string, JsonData::JsonValidator>>())
+        : m_spSchemas(std::make_shared<JsonData::JsonSchemas>())
     {}
     virtual ~JsonManager() override {
         Release();
     }
 
+    /**
+     * @details Schemas are shared through JsonSchemaCache and compiled when a document first needs them, so schemas
+     *          that are registered again, or never used, cost no compilation.
+     */
     virtual void Register(std::string_view file_path) override {
         auto json_data = std::make_unique<JsonData>(file_path);
         if (!json_data->Load()) {
             assert::ShowError(ASSERT_FILE_LINE, "Path not found: " + std::string(file_path.data()));
             return;
         }
-        for (const auto& e : json_data->GetData()->at("schema")) {
+        const auto& manifest = *json_data->GetData();
+        for (const auto& e : manifest.contains("schema") ? manifest.at("schema") : nlohmann::json::array()) {
             auto name = e.at("name").get<std::string>();
             auto path = e.at("path").get<std::string>();
             JsonData schema(path);
@@ -44,29 +49,24 @@ public:
                 assert::ShowError(ASSERT_FILE_LINE, "Path not found: " + path);
                 return;
             }
-            JsonData::JsonValidator validator;
-            try {
-                validator.set_root_schema(*schema.GetData());
-            }
-            catch (const std::exception& e) {
-                assert::ShowError(ASSERT_FILE_LINE, "Validation of schema failed: " + path + " - " + std::string(e.what()));
-                return;
-            }
-            m_spValidators->emplace(name, std::move(validator));
+            m_spSchemas->emplace(name, JsonSchemaCache::GetDefault().Get(*schema.GetData(), path));
         }
-        for (const auto& e : json_data->GetData()->at("list")) {
-            auto name = e.at("name").get<std::string>();
-            auto path = e.at("path").get<std::string>();
-            auto asset_data = std::make_unique<JsonData>(path, m_spValidators);
-            m_upAssets.emplace(name, std::move(asset_data));
+        for (const auto& e : manifest.at("list")) {
+            RegisterEntry(e.at("name").get<std::string>(), e);
         }
     }
 
     using IAssetManager<JsonData>::Register;
 
+protected:
+
+    virtual std::unique_ptr<JsonData> CreateAssetData(const std::string& path) override {
+        return std::make_unique<JsonData>(path, m_spSchemas);
+    }
+
 private:
 
-    std::shared_ptr<std::unordered_map<std::string, JsonData::JsonValidator>> m_spValidators;
+    std::shared_ptr<JsonData::JsonSchemas> m_spSchemas;
 
 #else
 public:
@@ -0,0 +1,235 @@
+﻿#pragma once
+
+#ifndef GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_JSON_JSONPARSECACHE_H_
+#define GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_JSON_JSONPARSECACHE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "Thread/AsyncFileService/MappedFile.h"
+
+#include "nlohmann/json.hpp"
+
+
+/**************************************************
+*
+* On-disk cache of parsed json documents stored
+* as MessagePack, keyed by the path, size and
+* modification time of the source file
+* Entries also record the hash of the schema the
+* document passed, so unchanged files skip
+* validation
+* Disabled until a directory is set
+*
+**************************************************/
+class JsonParseCache
+{
+public:
+
+    /**
+     * @brief Size and modification time of a source file. Entries are valid while the stamp of their source matches.
+     */
+    struct SourceStamp {
+        std::uint64_t size    = 0;
+        std::int64_t  time    = 0;
+        bool          isValid = false; // false if the source could not be stat'ed
+    };
+
+    JsonParseCache() {}
+    explicit JsonParseCache(std::string_view directory) {
+        SetDirectory(directory);
+    }
+
+    /**
+     * @brief Cache used by JsonData::Load.
+     */
+    static JsonParseCache& GetDefault() {
+        static JsonParseCache cache;
+        return cache;
+    }
+
+    /**
+     * @brief Set where cache entries are kept. An empty directory disables the cache.
+     */
+    void SetDirectory(std::string_view directory) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_directory = directory;
+        if (!m_directory.empty()) {
+            std::error_code error;
+            std::filesystem::create_directories(m_directory, error);
+        }
+    }
+    std::string GetDirectory() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_directory;
+    }
+    bool IsEnabled() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return !m_directory.empty();
+    }
+
+    /**
+     * @brief Read the cached document of a source file.
+     * @param validated_schema_hash Receives the hash of the schema the document passed, 0 if it was not validated.
+     * @return false if the cache is disabled, has no entry or the source changed since it was stored.
+     */
+    bool Load(const std::string& source_path, nlohmann::json* json, std::uint64_t* validated_schema_hash = nullptr) {
+        const auto directory = GetDirectory();
+        if (directory.empty()) return false;
+
+        SourceStamp stamp;
+        if (!GetSourceStamp(source_path, &stamp)) return false;
+
+        MappedFile entry;
+        if (!entry.Open(GetEntryPath(directory, source_path)) || entry.GetSize() < sizeof(Header)) {
+            ++m_missCount;
+            return false;
+        }
+        Header stored;
+        std::memcpy(&stored, entry.GetView().data(), sizeof(stored));
+        if (std::memcmp(stored.magic, MAGIC, sizeof(MAGIC)) != 0 || stored.version != VERSION
+            || stored.sourceSize != stamp.size || stored.sourceTime != stamp.time) {
+            ++m_missCount;
+            return false;
+        }
+        const auto body = entry.GetView().substr(sizeof(Header));
+        *json = nlohmann::json::from_msgpack(body.begin(), body.end(), true, false);
+        if (json->is_discarded()) {
+            ++m_missCount;
+            return false;
+        }
+        if (validated_schema_hash) {
+            *validated_schema_hash = stored.validatedSchemaHash;
+        }
+        ++m_hitCount;
+        return true;
+    }
+
+    /**
+     * @brief Store the parsed document of a source file. Written to a temporary file first, so readers never see a partial entry.
+     * @param stamp Stamp of the source taken before it was read. A file rewritten while it was parsed is then stored
+     *              under its old stamp and misses, instead of serving the old document under the new stamp.
+     * @param validated_schema_hash Hash of the schema the document passed, 0 if it was not validated.
+     * @return false if the cache is disabled, the stamp is invalid or the entry could not be written.
+     */
+    bool Store(const std::string& source_path, const SourceStamp& stamp, const nlohmann::json& json, std::uint64_t validated_schema_hash = 0) {
+        const auto directory = GetDirectory();
+        if (directory.empty() || !stamp.isValid) return false;
+
+        Header header;
+        header.sourceSize          = stamp.size;
+        header.sourceTime          = stamp.time;
+        header.validatedSchemaHash = validated_schema_hash;
+
+        const auto entry_path = GetEntryPath(directory, source_path);
+        const auto temp_path  = entry_path + "." + std::to_string(++m_tempCounter) + ".tmp";
+        {
+            std::ofstream ofs(temp_path, std::ios::binary);
+            if (!ofs) return false;
+            std::vector<std::uint8_t> body;
+            nlohmann::json::to_msgpack(json, body);
+            ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            ofs.write(reinterpret_cast<const char*>(body.data()), static_cast<std::streamsize>(body.size()));
+            if (!ofs) {
+                ofs.close();
+                std::error_code error;
+                std::filesystem::remove(temp_path, error);
+                return false;
+            }
+        }
+        std::error_code error;
+        std::filesystem::rename(temp_path, entry_path, error);
+        if (error) {
+            std::filesystem::remove(temp_path, error);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Delete every entry of the cache.
+     */
+    void Clear() {
+        const auto directory = GetDirectory();
+        if (directory.empty()) return;
+        std::error_code error;
+        for (const auto& e : std::filesystem::directory_iterator(directory, error)) {
+            if (e.path().extension() == EXTENSION) {
+                std::filesystem::remove(e.path(), error);
+            }
+        }
+    }
+
+    /**
+     * @return false if the source could not be stat'ed, the stamp is then invalid.
+     */
+    static bool GetSourceStamp(const std::string& source_path, SourceStamp* stamp) {
+        *stamp = SourceStamp();
+        std::error_code error;
+        const auto size = std::filesystem::file_size(source_path, error);
+        if (error) return false;
+        const auto time = std::filesystem::last_write_time(source_path, error);
+        if (error) return false;
+        stamp->size    = static_cast<std::uint64_t>(size);
+        stamp->time    = static_cast<std::int64_t>(time.time_since_epoch().count());
+        stamp->isValid = true;
+        return true;
+    }
+
+    std::size_t GetHitCount() const noexcept {
+        return m_hitCount;
+    }
+    std::size_t GetMissCount() const noexcept {
+        return m_missCount;
+    }
+
+private:
+
+    static constexpr char          MAGIC[4]    = { 'J', 'P', 'C', 'M' };
+    static constexpr std::uint32_t VERSION     = 2;
+    static constexpr char          EXTENSION[] = ".msgpack";
+
+    struct Header {
+        char          magic[4]            = { MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3] };
+        std::uint32_t version             = VERSION;
+        std::uint64_t sourceSize          = 0;
+        std::int64_t  sourceTime          = 0;
+        std::uint64_t validatedSchemaHash = 0; // 0 if not validated
+    };
+
+    static std::string GetEntryPath(const std::string& directory, const std::string& source_path) {
+        std::error_code error;
+        auto absolute_path = std::filesystem::absolute(source_path, error).lexically_normal().string();
+        if (error) {
+            absolute_path = source_path;
+        }
+        // FNV-1a
+        std::uint64_t hash = 14695981039346656037ull;
+        for (const auto& e : absolute_path) {
+            hash = (hash ^ static_cast<std::uint8_t>(e)) * 1099511628211ull;
+        }
+        static constexpr char DIGITS[] = "0123456789abcdef";
+        std::string name(16, '0');
+        for (int i = 15; i >= 0; --i, hash >>= 4) {
+            name[static_cast<std::size_t>(i)] = DIGITS[hash & 0xF];
+        }
+        return (std::filesystem::path(directory) / (name + EXTENSION)).string();
+    }
+
+    mutable std::mutex       m_mutex;
+    std::string              m_directory;
+    std::atomic<std::size_t> m_hitCount    = 0;
+    std::atomic<std::size_t> m_missCount   = 0;
+    std::atomic<std::size_t> m_tempCounter = 0;
+
+};
+
+#endif
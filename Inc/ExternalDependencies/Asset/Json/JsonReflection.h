@@ -0,0 +1,430 @@
+﻿#pragma once
+
+#ifndef GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_JSON_JSONREFLECTION_H_
+#define GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_JSON_JSONREFLECTION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+/**
+ * @brief Macro to expand __VA_ARGS__ before it is passed on. Needed by the traditional MSVC preprocessor.
+ */
+#define MACRO_JSON_EXPAND(x) x
+
+/**
+ * @brief Macro to describe one field of a reflected struct.
+ * @param class_name The name of the struct.
+ * @param member The name of the member, also used as the json key.
+ */
+#define MACRO_JSON_FIELD(class_name, member) json_reflection::MakeField(#member, &class_name::member)
+
+/**
+ * @brief Macros to apply func(class_name, x) to up to 32 arguments, separated by commas.
+ */
+#define MACRO_JSON_FOR_EACH_1(func, class_name, x)            func(class_name, x)
+#define MACRO_JSON_FOR_EACH_2(func, class_name, x, ...)  func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_1(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_3(func, class_name, x, ...)  func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_2(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_4(func, class_name, x, ...)  func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_3(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_5(func, class_name, x, ...)  func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_4(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_6(func, class_name, x, ...)  func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_5(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_7(func, class_name, x, ...)  func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_6(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_8(func, class_name, x, ...)  func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_7(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_9(func, class_name, x, ...)  func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_8(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_10(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_9(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_11(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_10(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_12(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_11(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_13(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_12(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_14(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_13(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_15(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_14(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_16(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_15(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_17(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_16(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_18(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_17(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_19(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_18(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_20(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_19(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_21(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_20(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_22(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_21(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_23(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_22(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_24(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_23(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_25(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_24(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_26(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_25(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_27(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_26(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_28(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_27(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_29(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_28(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_30(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_29(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_31(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_30(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_FOR_EACH_32(func, class_name, x, ...) func(class_name, x), MACRO_JSON_EXPAND(MACRO_JSON_FOR_EACH_31(func, class_name, __VA_ARGS__))
+#define MACRO_JSON_GET_FOR_EACH(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, name, ...) name
+#define MACRO_JSON_FOR_EACH(func, class_name, ...) \
+    MACRO_JSON_EXPAND(MACRO_JSON_GET_FOR_EACH(__VA_ARGS__, MACRO_JSON_FOR_EACH_32, MACRO_JSON_FOR_EACH_31, MACRO_JSON_FOR_EACH_30, MACRO_JSON_FOR_EACH_29, MACRO_JSON_FOR_EACH_28, MACRO_JSON_FOR_EACH_27, MACRO_JSON_FOR_EACH_26, MACRO_JSON_FOR_EACH_25, MACRO_JSON_FOR_EACH_24, MACRO_JSON_FOR_EACH_23, MACRO_JSON_FOR_EACH_22, MACRO_JSON_FOR_EACH_21, MACRO_JSON_FOR_EACH_20, MACRO_JSON_FOR_EACH_19, MACRO_JSON_FOR_EACH_18, MACRO_JSON_FOR_EACH_17, MACRO_JSON_FOR_EACH_16, MACRO_JSON_FOR_EACH_15, MACRO_JSON_FOR_EACH_14, MACRO_JSON_FOR_EACH_13, MACRO_JSON_FOR_EACH_12, MACRO_JSON_FOR_EACH_11, MACRO_JSON_FOR_EACH_10, MACRO_JSON_FOR_EACH_9, MACRO_JSON_FOR_EACH_8, MACRO_JSON_FOR_EACH_7, MACRO_JSON_FOR_EACH_6, MACRO_JSON_FOR_EACH_5, MACRO_JSON_FOR_EACH_4, MACRO_JSON_FOR_EACH_3, MACRO_JSON_FOR_EACH_2, MACRO_JSON_FOR_EACH_1)(func, class_name, __VA_ARGS__))
+
+/**
+ * @brief Macro to make the fields of a struct known to json_reflection. Place it in the body of the struct.
+ * @param class_name The name of the struct.
+ * @param ... The names of the members, up to 32. Each is read from the json key of the same name.
+ */
+#define MACRO_JSON_REFLECT(class_name, ...)                                                         \
+    static constexpr auto JsonFields() noexcept {                                                   \
+        return std::make_tuple(MACRO_JSON_FOR_EACH(MACRO_JSON_FIELD, class_name, __VA_ARGS__));    \
+    }
+
+/**************************************************
+*
+* Fills structs described by MACRO_JSON_REFLECT
+* straight from json text through the SAX parser,
+* no DOM is built
+* Supported members are bool, arithmetic types,
+* std::string, std::vector of supported types and
+* reflected structs. Unknown keys are skipped,
+* missing keys keep their value
+*
+**************************************************/
+namespace json_reflection {
+
+    template<class Class, class Member>
+    struct Field {
+        std::string_view name;
+        Member Class::*  member;
+    };
+
+    template<class Class, class Member>
+    constexpr Field<Class, Member> MakeField(std::string_view name, Member Class::* member) noexcept {
+        return { name, member };
+    }
+
+    template<class T, class = void>
+    struct IsReflected : std::false_type {};
+    template<class T>
+    struct IsReflected<T, std::void_t<decltype(T::JsonFields())>> : std::true_type {};
+    template<class T>
+    constexpr bool IsReflectedV = IsReflected<T>::value;
+
+    namespace detail {
+
+        struct VTable;
+
+        /**
+         * @brief Where the next json value goes: an object and how to fill it.
+         */
+        struct Slot {
+            void*         pTarget = nullptr;
+            const VTable* pVTable = nullptr;
+        };
+
+        /**
+         * @brief Type erased operations of a target type. false rejects the value, which fails the read.
+         */
+        struct VTable {
+            bool (*setNull)(void*);
+            bool (*setBool)(void*, bool);
+            bool (*setInteger)(void*, std::int64_t);
+            bool (*setUnsigned)(void*, std::uint64_t);
+            bool (*setFloat)(void*, double);
+            bool (*setString)(void*, std::string&);
+            bool (*beginObject)(void*);
+            Slot (*getField)(void*, std::string_view);
+            bool (*beginArray)(void*);
+            Slot (*emplaceBack)(void*);
+        };
+
+        template<class T>
+        struct IsVector : std::false_type {};
+        template<class T, class Allocator>
+        struct IsVector<std::vector<T, Allocator>> : std::true_type {};
+
+        /**
+         * @brief Target of values nobody wants, such as the values of unknown keys.
+         */
+        struct Skip {};
+
+        template<class T>
+        inline Slot MakeSlot(T* target) noexcept;
+        inline Slot MakeSkipSlot() noexcept;
+
+        template<class T>
+        struct Reader {
+            static_assert(std::is_same_v<T, Skip> || std::is_same_v<T, bool> || std::is_arithmetic_v<T> || std::is_same_v<T, std::string> || IsVector<T>::value || IsReflectedV<T>,
+                "json_reflection does not support this member type");
+
+            static bool SetNull(void*) {
+                return std::is_same_v<T, Skip>;
+            }
+
+            static bool SetBool(void* target, bool value) {
+                if constexpr (std::is_same_v<T, bool>) {
+                    *static_cast<T*>(target) = value;
+                }
+                return std::is_same_v<T, bool> || std::is_same_v<T, Skip>;
+            }
+
+            static bool SetInteger(void* target, std::int64_t value) {
+                if constexpr (std::is_floating_point_v<T>) {
+                    *static_cast<T*>(target) = static_cast<T>(value);
+                    return true;
+                }
+                else if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+                    if constexpr (std::is_unsigned_v<T>) {
+                        if (value < 0 || static_cast<std::uint64_t>(value) > (std::numeric_limits<T>::max)()) return false;
+                    }
+                    else {
+                        if (value < (std::numeric_limits<T>::min)() || value > (std::numeric_limits<T>::max)()) return false;
+                    }
+                    *static_cast<T*>(target) = static_cast<T>(value);
+                    return true;
+                }
+                return std::is_same_v<T, Skip>;
+            }
+
+            static bool SetUnsigned(void* target, std::uint64_t value) {
+                if constexpr (std::is_floating_point_v<T>) {
+                    *static_cast<T*>(target) = static_cast<T>(value);
+                    return true;
+                }
+                else if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+                    if (value > static_cast<std::make_unsigned_t<T>>((std::numeric_limits<T>::max)())) return false;
+                    *static_cast<T*>(target) = static_cast<T>(value);
+                    return true;
+                }
+                return std::is_same_v<T, Skip>;
+            }
+
+            static bool SetFloat(void* target, double value) {
+                if constexpr (std::is_floating_point_v<T>) {
+                    *static_cast<T*>(target) = static_cast<T>(value);
+                }
+                return std::is_floating_point_v<T> || std::is_same_v<T, Skip>;
+            }
+
+            static bool SetString(void* target, std::string& value) {
+                if constexpr (std::is_same_v<T, std::string>) {
+                    *static_cast<T*>(target) = std::move(value);
+                }
+                return std::is_same_v<T, std::string> || std::is_same_v<T, Skip>;
+            }
+
+            static bool BeginObject(void*) {
+                return IsReflectedV<T> || std::is_same_v<T, Skip>;
+            }
+
+            static Slot GetField(void* target, std::string_view key) {
+                if constexpr (IsReflectedV<T>) {
+                    return FindField(static_cast<T*>(target), key, std::make_index_sequence<std::tuple_size_v<decltype(T::JsonFields())>>{});
+                }
+                else {
+                    return MakeSkipSlot();
+                }
+            }
+
+            static bool BeginArray(void* target) {
+                if constexpr (IsVector<T>::value) {
+                    static_cast<T*>(target)->clear();
+                }
+                return IsVector<T>::value || std::is_same_v<T, Skip>;
+            }
+
+            static Slot EmplaceBack(void* target) {
+                if constexpr (IsVector<T>::value) {
+                    return MakeSlot(&static_cast<T*>(target)->emplace_back());
+                }
+                else {
+                    return MakeSkipSlot();
+                }
+            }
+
+        private:
+
+            template<std::size_t... Indices>
+            static Slot FindField(T* target, std::string_view key, std::index_sequence<Indices...>) {
+                constexpr auto fields = T::JsonFields();
+                Slot slot = MakeSkipSlot();
+                // Stops at the first field whose name matches
+                static_cast<void>(((std::get<Indices>(fields).name == key ? (slot = MakeSlot(&(target->*std::get<Indices>(fields).member)), true) : false) || ...));
+                return slot;
+            }
+
+        };
+
+        template<class T>
+        inline constexpr VTable VTABLE = {
+            &Reader<T>::SetNull,
+            &Reader<T>::SetBool,
+            &Reader<T>::SetInteger,
+            &Reader<T>::SetUnsigned,
+            &Reader<T>::SetFloat,
+            &Reader<T>::SetString,
+            &Reader<T>::BeginObject,
+            &Reader<T>::GetField,
+            &Reader<T>::BeginArray,
+            &Reader<T>::EmplaceBack,
+        };
+
+        template<class T>
+        inline Slot MakeSlot(T* target) noexcept {
+            return { target, &VTABLE<T> };
+        }
+        inline Slot MakeSkipSlot() noexcept {
+            return { nullptr, &VTABLE<Skip> };
+        }
+
+        /**
+         * @brief SAX handler of nlohmann::json, routes the events to the slots of the target.
+         */
+        class SaxReader
+        {
+        public:
+
+            using Json = nlohmann::json;
+
+            explicit SaxReader(Slot root)
+                : m_root(root)
+            {}
+
+            bool null() {
+                const auto slot = NextSlot();
+                return slot.pVTable->setNull(slot.pTarget);
+            }
+            bool boolean(bool value) {
+                const auto slot = NextSlot();
+                return slot.pVTable->setBool(slot.pTarget, value);
+            }
+            bool number_integer(Json::number_integer_t value) {
+                const auto slot = NextSlot();
+                return slot.pVTable->setInteger(slot.pTarget, value);
+            }
+            bool number_unsigned(Json::number_unsigned_t value) {
+                const auto slot = NextSlot();
+                return slot.pVTable->setUnsigned(slot.pTarget, value);
+            }
+            bool number_float(Json::number_float_t value, const Json::string_t&) {
+                const auto slot = NextSlot();
+                return slot.pVTable->setFloat(slot.pTarget, value);
+            }
+            bool string(Json::string_t& value) {
+                const auto slot = NextSlot();
+                return slot.pVTable->setString(slot.pTarget, value);
+            }
+            bool binary(Json::binary_t&) {
+                return false;
+            }
+
+            bool start_object(std::size_t) {
+                const auto slot = NextSlot();
+                if (!slot.pVTable->beginObject(slot.pTarget)) return false;
+                m_frames.push_back(slot);
+                return true;
+            }
+            bool key(Json::string_t& value) {
+                const auto& frame = m_frames.back();
+                m_field = frame.pVTable->getField(frame.pTarget, value);
+                return true;
+            }
+            bool end_object() {
+                m_frames.pop_back();
+                return true;
+            }
+
+            bool start_array(std::size_t) {
+                const auto slot = NextSlot();
+                if (!slot.pVTable->beginArray(slot.pTarget)) return false;
+                m_frames.push_back(slot);
+                m_arrayDepths.push_back(m_frames.size());
+                return true;
+            }
+            bool end_array() {
+                m_arrayDepths.pop_back();
+                m_frames.pop_back();
+                return true;
+            }
+
+            bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) {
+                return false;
+            }
+
+        private:
+
+            Slot NextSlot() {
+                if (m_frames.empty()) return m_root;
+                // Elements of the innermost container that is an array, fields otherwise
+                if (!m_arrayDepths.empty() && m_arrayDepths.back() == m_frames.size()) {
+                    const auto& frame = m_frames.back();
+                    return frame.pVTable->emplaceBack(frame.pTarget);
+                }
+                return m_field;
+            }
+
+            Slot                     m_root;
+            Slot                     m_field;
+            std::vector<Slot>        m_frames;
+            std::vector<std::size_t> m_arrayDepths;
+
+        };
+
+        /**
+         * @brief Replay a DOM as SAX events, so DOM and text fill targets the same way.
+         */
+        inline bool Replay(const nlohmann::json& json, SaxReader* reader) {
+            switch (json.type()) {
+            case nlohmann::json::value_t::null:
+                return reader->null();
+            case nlohmann::json::value_t::boolean:
+                return reader->boolean(json.get<bool>());
+            case nlohmann::json::value_t::number_integer:
+                return reader->number_integer(json.get<nlohmann::json::number_integer_t>());
+            case nlohmann::json::value_t::number_unsigned:
+                return reader->number_unsigned(json.get<nlohmann::json::number_unsigned_t>());
+            case nlohmann::json::value_t::number_float:
+                return reader->number_float(json.get<nlohmann::json::number_float_t>(), {});
+            case nlohmann::json::value_t::string: {
+                auto value = json.get<std::string>();
+                return reader->string(value);
+            }
+            case nlohmann::json::value_t::object:
+                if (!reader->start_object(json.size())) return false;
+                for (const auto& e : json.items()) {
+                    auto key = e.key();
+                    if (!reader->key(key) || !Replay(e.value(), reader)) return false;
+                }
+                return reader->end_object();
+            case nlohmann::json::value_t::array:
+                if (!reader->start_array(json.size())) return false;
+                for (const auto& e : json) {
+                    if (!Replay(e, reader)) return false;
+                }
+                return reader->end_array();
+            default:
+                return false;
+            }
+        }
+
+    }
+
+    /**
+     * @brief Fill a value from json text without building a DOM.
+     * @return false if the text is malformed or a value does not fit its member. value is partially filled then.
+     */
+    template<class T>
+    inline bool Read(std::string_view text, T* value) {
+        detail::SaxReader reader(detail::MakeSlot(value));
+        return nlohmann::json::sax_parse(text.begin(), text.end(), &reader, nlohmann::json::input_format_t::json, true);
+    }
+
+    /**
+     * @brief Fill a value from an already parsed document, with the same rules as reading text.
+     */
+    template<class T>
+    inline bool FromJson(const nlohmann::json& json, T* value) {
+        detail::SaxReader reader(detail::MakeSlot(value));
+        return detail::Replay(json, &reader);
+    }
+
+}
+
+#endif
@@ -0,0 +1,186 @@
+﻿#pragma once
+
+#ifndef GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_JSON_JSONSCHEMACACHE_H_
+#define GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_JSON_JSONSCHEMACACHE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "Utility/Assert.h"
+
+#include "nlohmann/json.hpp"
+#ifdef ENABLE_JSON_SCHEMA_VALIDATOR
+#include "nlohmann/json-schema.hpp"
+#endif
+
+#ifdef ENABLE_JSON_SCHEMA_VALIDATOR
+
+/**************************************************
+*
+* A json schema that is compiled into a validator
+* the first time a document is validated with it
+* Validation is read only and may run on several
+* threads at once
+*
+**************************************************/
+class JsonSchema
+{
+public:
+
+    using Json          = nlohmann::json;
+    using JsonValidator = nlohmann::json_schema::json_validator;
+
+    JsonSchema(Json schema, std::uint64_t hash, std::string_view path)
+        : m_schema(std::move(schema))
+        , m_hash(hash)
+        , m_path(path)
+    {}
+
+    /**
+     * @brief Hash of the schema content. Documents that passed validation are cached with it.
+     */
+    std::uint64_t GetHash() const noexcept {
+        return m_hash;
+    }
+
+    const Json& GetSchema() const noexcept {
+        return m_schema;
+    }
+
+    bool IsCompiled() const noexcept {
+        return m_isCompiled;
+    }
+
+    /**
+     * @brief Compile the validator unless it is already. Only the first call does the work.
+     * @return false if the schema itself is invalid.
+     */
+    bool Compile() {
+        std::call_once(m_compileFlag, [&] {
+            try {
+                m_validator.set_root_schema(m_schema);
+                m_isCompileSucceeded = true;
+            }
+            catch (const std::exception& e) {
+                assert::ShowError(ASSERT_FILE_LINE, "Validation of schema failed: " + m_path + " - " + std::string(e.what()));
+            }
+            m_isCompiled = true;
+        });
+        return m_isCompileSucceeded;
+    }
+
+    /**
+     * @brief Validate a document, compiling the schema first if needed.
+     * @param file_path Path of the document, for the error message.
+     */
+    bool Validate(const Json& json, std::string_view file_path) {
+        if (!Compile()) return false;
+        ++m_validationCount;
+        try {
+            m_validator.validate(json);
+            return true;
+        }
+        catch (const std::exception& e) {
+            assert::ShowError(ASSERT_FILE_LINE, "Validation of json failed: " + std::string(file_path) + " - " + std::string(e.what()));
+            return false;
+        }
+    }
+
+    /**
+     * @brief Number of documents validated, documents whose validation was skipped are not counted.
+     */
+    std::size_t GetValidationCount() const noexcept {
+        return m_validationCount;
+    }
+
+private:
+
+    const Json               m_schema;
+    const std::uint64_t      m_hash;
+    const std::string        m_path;
+
+    std::once_flag           m_compileFlag;
+    JsonValidator            m_validator;
+    bool                     m_isCompileSucceeded = false;
+    std::atomic<bool>        m_isCompiled         = false;
+    std::atomic<std::size_t> m_validationCount    = 0;
+
+};
+#endif
+
+/**************************************************
+*
+* Shares compiled schemas by content hash, so a
+* schema registered by several managers, or again
+* after a reload, is compiled once per process
+* Only Hash is available without the validator
+*
+**************************************************/
+class JsonSchemaCache
+{
+public:
+
+    /**
+     * @brief FNV-1a of the serialized schema. Objects serialize with sorted keys, so equal schemas hash equally.
+     */
+    static std::uint64_t Hash(const nlohmann::json& schema) {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (const auto& e : schema.dump()) {
+            hash = (hash ^ static_cast<std::uint8_t>(e)) * 1099511628211ull;
+        }
+        // 0 means "not validated" in the parse cache
+        return hash ? hash : 1;
+    }
+
+#ifdef ENABLE_JSON_SCHEMA_VALIDATOR
+    /**
+     * @brief Cache used by JsonManager::Register.
+     */
+    static JsonSchemaCache& GetDefault() {
+        static JsonSchemaCache cache;
+        return cache;
+    }
+
+    /**
+     * @brief Get the schema of this content, creating it if it is not cached. Compiled on first use.
+     * @param path Path the schema was read from, for error messages.
+     */
+    std::shared_ptr<JsonSchema> Get(const nlohmann::json& schema, std::string_view path) {
+        const auto hash = Hash(schema);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& entry = m_spSchemas[hash];
+        if (!entry) {
+            entry = std::make_shared<JsonSchema>(schema, hash, path);
+        }
+        else if (entry->GetSchema() != schema) {
+            // Hash collision, leave it uncached
+            return std::make_shared<JsonSchema>(schema, hash, path);
+        }
+        return entry;
+    }
+
+    std::size_t GetCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_spSchemas.size();
+    }
+
+    void Clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_spSchemas.clear();
+    }
+
+private:
+
+    mutable std::mutex                                             m_mutex;
+    std::unordered_map<std::uint64_t, std::shared_ptr<JsonSchema>> m_spSchemas;
+#endif
+
+};
+
+#endif
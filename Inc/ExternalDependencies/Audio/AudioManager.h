@@ -3,13 +3,14 @@
 #ifndef GAME_LIBRARIES_EXTERNALDEPENDENCIES_AUDIO_AUDIOMANAGER_H_
 #define GAME_LIBRARIES_EXTERNALDEPENDENCIES_AUDIO_AUDIOMANAGER_H_
 
+#include <algorithm>
 #include <memory>
-#include <string>
 #include <string_view>
-#include <unordered_map>
+#include <vector>
 #include <Windows.h>
 
 #include "Utility/Assert.h"
+#include "Utility/StringIdMap.h"
 #include "ExternalDependencies/Audio/AudioHelper.h"
 
 
@@ -51,50 +52,51 @@ public:
         m_listener.Position = position;
         m_listener.OrientFront = front_direction;
 
-        for (auto iter = m_spSoundInstances.begin(); iter != m_spSoundInstances.end();) {
-            if (iter->second->IsState(DirectX::SoundState::STOPPED)) {
-                iter = m_spSoundInstances.erase(iter);
-            }
-            else {
-                ++iter;
-            }
-        }
+        // Emptied lists are kept, so playing the sound again does not allocate
+        m_spSoundInstances.ForEach([](StringId, std::vector<std::shared_ptr<audio_helper::SoundInstance>>& instances) {
+            instances.erase(std::remove_if(instances.begin(), instances.end(), [](const auto& instance) {
+                return instance->IsState(DirectX::SoundState::STOPPED);
+            }), instances.end());
+        });
     }
 
-    std::shared_ptr<const audio_helper::SoundInstance> GetSoundInstance(std::string_view sound_name) const {
-        if (auto iter = m_spSoundInstances.find(sound_name.data()); iter != m_spSoundInstances.end()) {
-            return iter->second;
+    std::shared_ptr<const audio_helper::SoundInstance> GetSoundInstance(StringId sound_name) const {
+        if (auto* instances = m_spSoundInstances.Find(sound_name); instances && !instances->empty()) {
+            return instances->front();
         }
         return nullptr;
     }
 
     void SetAudio(std::string_view sound_name, std::string_view file_path) {
-        m_spSoundData.emplace(sound_name, std::make_shared<audio_helper::SoundData>(m_upAudioEngine.get(), file_path));
+        m_spSoundData.TryEmplace(StringIdTable::GetDefault().Intern(sound_name), std::make_shared<audio_helper::SoundData>(m_upAudioEngine.get(), file_path));
     }
 
-    std::shared_ptr<audio_helper::SoundInstance> Play(std::string_view sound_name, PlayFlags play_flags = PLAYFLAGS_NONE, const DirectX::SimpleMath::Vector3& position = DirectX::SimpleMath::Vector3::Zero) {
+    /**
+     * @param sound_name Name given to SetAudio. Keep a StringId (e.g. "bgm"_sid) when playing every frame.
+     */
+    std::shared_ptr<audio_helper::SoundInstance> Play(StringId sound_name, PlayFlags play_flags = PLAYFLAGS_NONE, const DirectX::SimpleMath::Vector3& position = DirectX::SimpleMath::Vector3::Zero) {
         if (play_flags & PLAYFLAGS_UNIQUE) {
-            if (auto iter = m_spSoundInstances.find(sound_name.data()); iter != m_spSoundInstances.end()) {
-                return iter->second;
+            if (auto* instances = m_spSoundInstances.Find(sound_name); instances && !instances->empty()) {
+                return instances->front();
             }
         }
-        if (auto iter = m_spSoundData.find(sound_name.data()); iter != m_spSoundData.end()) {
+        if (auto* sound_data = m_spSoundData.Find(sound_name)) {
             DirectX::SOUND_EFFECT_INSTANCE_FLAGS flags = DirectX::SoundEffectInstance_Default;
             if (play_flags & PLAYFLAGS_PLAY3D) {
                 flags |= DirectX::SoundEffectInstance_Use3D | DirectX::SoundEffectInstance_ReverbUseFilters;
             }
-            auto sound_instance = std::make_shared<audio_helper::SoundInstance>(flags, iter->second);
+            auto sound_instance = std::make_shared<audio_helper::SoundInstance>(flags, *sound_data);
             
             if (play_flags & PLAYFLAGS_PLAY3D) {
                 sound_instance->Apply3D(m_listener, position);
             }
             sound_instance->Play(play_flags & PLAYFLAGS_LOOP);
 
-            m_spSoundInstances.emplace(sound_name, sound_instance);
+            m_spSoundInstances[sound_name].push_back(sound_instance);
             return sound_instance;
         }
         else {
-            assert::ShowError(ASSERT_FILE_LINE, "Failed to find sound data.");
+            assert::ShowError(ASSERT_FILE_LINE, "Failed to find sound data: " + sound_name.GetName());
         }
         return nullptr;
     }
@@ -106,14 +108,18 @@ public:
         m_upAudioEngine->SetMasterVolume(volume);
     }
     void StopAllSound() noexcept {
-        for (auto&& e : m_spSoundInstances) {
-            e.second->GetSoundEffectInstance()->Stop();
-        }
+        m_spSoundInstances.ForEach([](StringId, const std::vector<std::shared_ptr<audio_helper::SoundInstance>>& instances) {
+            for (const auto& e : instances) {
+                e->GetSoundEffectInstance()->Stop();
+            }
+        });
     }
     void SetAllVolume(float volume) {
-        for (auto&& e : m_spSoundInstances) {
-            e.second->GetSoundEffectInstance()->SetVolume(volume);
-        }
+        m_spSoundInstances.ForEach([volume](StringId, const std::vector<std::shared_ptr<audio_helper::SoundInstance>>& instances) {
+            for (const auto& e : instances) {
+                e->GetSoundEffectInstance()->SetVolume(volume);
+            }
+        });
     }
 
 private:
@@ -122,10 +128,10 @@ private:
         CoUninitialize();
     }
 
-    std::unique_ptr<DirectX::AudioEngine>                                              m_upAudioEngine = nullptr;
-    DirectX::AudioListener                                                             m_listener;
-    std::unordered_map<std::string, std::shared_ptr<audio_helper::SoundData>>          m_spSoundData;
-    std::unordered_multimap<std::string, std::shared_ptr<audio_helper::SoundInstance>> m_spSoundInstances;
+    std::unique_ptr<DirectX::AudioEngine>                                  m_upAudioEngine = nullptr;
+    DirectX::AudioListener                                                 m_listener;
+    StringIdMap<std::shared_ptr<audio_helper::SoundData>>                  m_spSoundData;
+    StringIdMap<std::vector<std::shared_ptr<audio_helper::SoundInstance>>> m_spSoundInstances;
 
 };
 
@@ -4,9 +4,10 @@
 #define GAME_LIBRARIES_EXTERNALDEPENDENCIES_EFFEKSEER_EFFEKSEERMANAGER_H_
 
 #include <memory>
-#include <string>
 #include <string_view>
-#include <unordered_map>
+#include <vector>
+
+#include "Utility/StringIdMap.h"
 
 #include "EffekseerHelper.h"
 
@@ -25,32 +26,36 @@ public:
 
     void Update(double delta_time) {
         constexpr double effect_frame = 60.0;
-        for (auto iter = m_upEffectInstances.begin(); iter != m_upEffectInstances.end();) {
-            auto& data     = *iter->second;
-            auto& handle   = iter->second->handle;
-            auto& tranform = iter->second->effectTransform;
-
-            if (data.elapsedTime == 0) {
-                handle = m_managerRef->Play(data.GetEffectData()->GetEffectRef(), 0, 0, 0);
-            }
+        // Emptied lists are kept, so emitting the effect again does not allocate a list
+        m_upEffectInstances.ForEach([&](StringId, std::vector<std::unique_ptr<effekseer_helper::EffectInstance>>& instances) {
+            for (auto iter = instances.begin(); iter != instances.end();) {
+                auto& data     = **iter;
+                auto& handle   = data.handle;
+                auto& tranform = data.effectTransform;
+
+                if (data.elapsedTime == 0) {
+                    handle = m_managerRef->Play(data.GetEffectData()->GetEffectRef(), 0, 0, 0);
+                }
 
-            if (data.elapsedTime > (tranform->maxFrame / effect_frame)) {
-                m_managerRef->StopEffect(handle);
-                if (tranform->isLoop) {
-                    data.elapsedTime = 0;
+                if (data.elapsedTime > (tranform->maxFrame / effect_frame)) {
+                    m_managerRef->StopEffect(handle);
+                    if (tranform->isLoop) {
+                        // Visit it again, so it plays again in this frame
+                        data.elapsedTime = 0;
+                    }
+                    else {
+                        iter = instances.erase(iter);
+                    }
                 }
                 else {
-                    iter = m_upEffectInstances.erase(iter);
+                    m_rendererRef->SetTime(static_cast<float>(data.elapsedTime));
+                    m_managerRef->SetMatrix(handle, effekseer_helper::ToMatrix43(tranform->matrix));
+                    m_managerRef->SetSpeed(handle, tranform->speed);
+                    data.elapsedTime += delta_time;
+                    ++iter;
                 }
             }
-            else {
-                m_rendererRef->SetTime(static_cast<float>(data.elapsedTime));
-                m_managerRef->SetMatrix(handle, effekseer_helper::ToMatrix43(tranform->matrix));
-                m_managerRef->SetSpeed(handle, tranform->speed);
-                data.elapsedTime += delta_time;
-                ++iter;
-            }
-        }
+        });
 
         m_managerRef->Update(static_cast<float>(delta_time * effect_frame));
     }
@@ -67,24 +72,27 @@ public:
     }
 
     void SetEffect(std::string_view effect_name, std::string_view file_path) {
-        m_spEffectData.emplace(effect_name, std::make_shared<effekseer_helper::EffectData>(m_managerRef, file_path));
+        m_spEffectData.TryEmplace(StringIdTable::GetDefault().Intern(effect_name), std::make_shared<effekseer_helper::EffectData>(m_managerRef, file_path));
     }
     
-    std::shared_ptr<effekseer_helper::EffectTransform> Emit(std::string_view effect_name, const effekseer_helper::EffectTransform& effect_transform, bool is_unique = false) {
+    /**
+     * @param effect_name Name given to SetEffect. Keep a StringId (e.g. "hit"_sid) when emitting every frame.
+     */
+    std::shared_ptr<effekseer_helper::EffectTransform> Emit(StringId effect_name, const effekseer_helper::EffectTransform& effect_transform, bool is_unique = false) {
         if (is_unique) {
-            if (auto iter = m_upEffectInstances.find(effect_name.data()); iter != m_upEffectInstances.end()) {
-                return iter->second->effectTransform;
+            if (auto* instances = m_upEffectInstances.Find(effect_name); instances && !instances->empty()) {
+                return instances->front()->effectTransform;
             }
         }
-        if (auto iter = m_spEffectData.find(effect_name.data()); iter != m_spEffectData.end()) {
-            auto effect_instance = std::make_unique<effekseer_helper::EffectInstance>(iter->second);
+        if (auto* effect_data = m_spEffectData.Find(effect_name)) {
+            auto effect_instance = std::make_unique<effekseer_helper::EffectInstance>(*effect_data);
             effect_instance->effectTransform = std::make_shared<effekseer_helper::EffectTransform>(effect_transform);
             auto& sp_et = effect_instance->effectTransform;
-            m_upEffectInstances.emplace(effect_name, std::move(effect_instance));
+            m_upEffectInstances[effect_name].push_back(std::move(effect_instance));
             return sp_et;
         }
         else {
-            assert::ShowError(ASSERT_FILE_LINE, "EffectData is not found.");
+            assert::ShowError(ASSERT_FILE_LINE, "EffectData is not found: " + effect_name.GetName());
         }
         return nullptr;
     }
@@ -96,10 +104,10 @@ private:
         m_rendererRef.Reset();
     }
 
-    effekseer_helper::RendererRef                                                           m_rendererRef;
-    Effekseer::ManagerRef                                                                   m_managerRef;
-    std::unordered_map<std::string, std::shared_ptr<effekseer_helper::EffectData>>          m_spEffectData;
-    std::unordered_multimap<std::string, std::unique_ptr<effekseer_helper::EffectInstance>> m_upEffectInstances;
+    effekseer_helper::RendererRef                                               m_rendererRef;
+    Effekseer::ManagerRef                                                       m_managerRef;
+    StringIdMap<std::shared_ptr<effekseer_helper::EffectData>>                  m_spEffectData;
+    StringIdMap<std::vector<std::unique_ptr<effekseer_helper::EffectInstance>>> m_upEffectInstances;
 
 };
 
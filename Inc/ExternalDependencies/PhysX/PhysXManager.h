@@ -8,6 +8,7 @@
 #include "Math/Constant.h"
 #include "Utility/Macro.h"
 #include "Utility/Memory.h"
+#include "Utility/StringIdMap.h"
 
 #include "PhysXHelper.h"
 
@@ -78,7 +79,7 @@ public:
             pvd_client->setScenePvdFlag(physx::PxPvdSceneFlag::eTRANSMIT_SCENEQUERIES, true);
         }
 
-        m_pMaterials.emplace("default", m_pPhysics->createMaterial(0.5f, 0.5f, 0.5f));
+        m_pMaterials.TryEmplace(StringIdTable::GetDefault().Intern("default"), m_pPhysics->createMaterial(0.5f, 0.5f, 0.5f));
 
         if (create_plane) {
             AddActor(StaticPlane());
@@ -98,7 +99,7 @@ public:
     }
 
     void AddMaterial(std::string_view material_name, physx::PxMaterial* material) {
-        m_pMaterials.emplace(material_name.data(), material);
+        m_pMaterials.TryEmplace(StringIdTable::GetDefault().Intern(material_name), material);
     }
 
     // Deprecated
@@ -115,26 +116,26 @@ public:
     * URL:"https://docs.nvidia.com/gameworks/content/gameworkslibrary/physx/guide/Manual/Geometry.html"
     *****************************************************************************************************/
 
-    physx::PxShape* Sphere(float radius, std::string_view material_name = "") {
+    physx::PxShape* Sphere(float radius, StringId material_name = "default"_sid) {
         return m_pPhysics->createShape(physx::PxSphereGeometry(radius), *FindMaterial(material_name));
     }
-    physx::PxShape* Capsule(float radius, float half_height, std::string_view material_name = "") {
+    physx::PxShape* Capsule(float radius, float half_height, StringId material_name = "default"_sid) {
         return m_pPhysics->createShape(physx::PxCapsuleGeometry(radius, half_height), *FindMaterial(material_name));
     }
-    physx::PxShape* Box(const DirectX::SimpleMath::Vector3& half_extent, std::string_view material_name = "") {
+    physx::PxShape* Box(const DirectX::SimpleMath::Vector3& half_extent, StringId material_name = "default"_sid) {
         return m_pPhysics->createShape(physx::PxBoxGeometry(physx_helper::ToPxVec3(half_extent)), *FindMaterial(material_name));
     }
-    physx::PxShape* Plane(std::string_view material_name = "") {
+    physx::PxShape* Plane(StringId material_name = "default"_sid) {
         return m_pPhysics->createShape(physx::PxPlaneGeometry(), *FindMaterial(material_name));
     }
-    physx::PxShape* ConvexMesh(physx::PxConvexMesh* mesh, std::string_view material_name = "") {
+    physx::PxShape* ConvexMesh(physx::PxConvexMesh* mesh, StringId material_name = "default"_sid) {
         return m_pPhysics->createShape(physx::PxConvexMeshGeometry(mesh), *FindMaterial(material_name));
     }
-    physx::PxShape* TriangleMesh(physx::PxTriangleMesh* mesh, const DirectX::SimpleMath::Vector3& scale = { 1.f, 1.f, 1.f }, std::string_view material_name = "") {
+    physx::PxShape* TriangleMesh(physx::PxTriangleMesh* mesh, const DirectX::SimpleMath::Vector3& scale = { 1.f, 1.f, 1.f }, StringId material_name = "default"_sid) {
         return m_pPhysics->createShape(physx::PxTriangleMeshGeometry(mesh, physx::PxMeshScale(physx_helper::ToPxVec3(scale))), *FindMaterial(material_name));
     }
 
-    physx::PxRigidStatic* StaticPlane(std::string_view material_name = "") {
+    physx::PxRigidStatic* StaticPlane(StringId material_name = "default"_sid) {
         return physx::PxCreatePlane(*m_pPhysics, physx::PxPlane(0, 1, 0, 0), *FindMaterial(material_name));
     }
 
@@ -212,12 +213,12 @@ private:
         memory::SafeRelease(&m_pFoundation);
     }
 
-    physx::PxMaterial* FindMaterial(std::string_view material_name) {
-        if (auto iter = m_pMaterials.find(material_name.data()); iter != m_pMaterials.end()) {
-            return iter->second;
+    physx::PxMaterial* FindMaterial(StringId material_name) {
+        if (auto* material = m_pMaterials.Find(material_name)) {
+            return *material;
         }
         else {
-            return m_pMaterials.at("default");
+            return *m_pMaterials.Find("default"_sid);
         }
     }
 
@@ -234,7 +235,7 @@ private:
     physx::PxPvd*                  m_pPvd        = nullptr;
 
     // material
-    std::unordered_map<std::string, physx::PxMaterial*> m_pMaterials;
+    StringIdMap<physx::PxMaterial*> m_pMaterials;
 
     // cuda
     physx::PxCudaContextManager*   m_pCudaCtxMgr = nullptr;
@@ -0,0 +1,734 @@
+﻿/**
+ * @file AsyncFileService.h
+ * @author shirokuma1101
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023 shirokuma1101. All rights reserved.
+ * @license MIT License (see LICENSE.txt file)
+ */
+
+#pragma once
+
+#ifndef GAME_LIBRARIES_THREAD_ASYNCFILESERVICE_ASYNCFILESERVICE_H_
+#define GAME_LIBRARIES_THREAD_ASYNCFILESERVICE_ASYNCFILESERVICE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__) && !defined(DISABLE_IO_URING) && __has_include(<linux/io_uring.h>)
+#define ENABLE_IO_URING
+#endif
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef ENABLE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+#include "Utility/Assert.h"
+
+#include "Thread/SimpleThreadManager/CompletionHandle.h"
+
+class FileReadHandle;
+
+namespace detail {
+
+    struct FileReadState {
+        CompletionSource                    source;
+        std::string                         path;
+        std::string                         data;
+        int                                 error = 0; // errno (GetLastError on Windows), 0 on success
+        std::function<void(FileReadHandle)> onComplete;
+
+        // Owned by the I/O thread while the read is in flight
+        std::shared_ptr<FileReadState>      spSelf = nullptr;
+        int                                 fd     = -1;
+        std::size_t                         offset = 0;
+        bool                                isSizeKnown = false;
+        bool                                isOpened    = false;
+    };
+
+    /**
+     * @brief Read a whole file with blocking calls.
+     * @return 0 on success, otherwise the OS error code.
+     */
+    inline int ReadWholeFile(const std::string& path, std::string* data) {
+        constexpr std::size_t UNKNOWN_SIZE_CHUNK = 64 * 1024;
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return static_cast<int>(GetLastError());
+        LARGE_INTEGER size = {};
+        GetFileSizeEx(file, &size);
+        data->resize(size.QuadPart ? static_cast<std::size_t>(size.QuadPart) : UNKNOWN_SIZE_CHUNK);
+        std::size_t offset = 0;
+        int error = 0;
+        while (true) {
+            DWORD read = 0;
+            const auto request = static_cast<DWORD>((std::min<std::size_t>)(data->size() - offset, 0x7FFFFFFF));
+            if (!::ReadFile(file, data->data() + offset, request, &read, nullptr)) {
+                error = static_cast<int>(GetLastError());
+                break;
+            }
+            if (read == 0) break;
+            offset += read;
+            if (offset == data->size()) {
+                if (size.QuadPart) break;
+                data->resize(data->size() * 2);
+            }
+        }
+        CloseHandle(file);
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return errno;
+        struct stat st = {};
+        if (::fstat(fd, &st) < 0) {
+            const int error = errno;
+            ::close(fd);
+            data->clear();
+            return error;
+        }
+        const bool is_size_known = st.st_size > 0;
+        data->resize(is_size_known ? static_cast<std::size_t>(st.st_size) : UNKNOWN_SIZE_CHUNK);
+        std::size_t offset = 0;
+        int error = 0;
+        while (true) {
+            const auto read = ::pread(fd, data->data() + offset, data->size() - offset, static_cast<off_t>(offset));
+            if (read < 0) {
+                if (errno == EINTR) continue;
+                error = errno;
+                break;
+            }
+            if (read == 0) break;
+            offset += static_cast<std::size_t>(read);
+            if (offset == data->size()) {
+                if (is_size_known) break;
+                data->resize(data->size() * 2);
+            }
+        }
+        ::close(fd);
+#endif
+        data->resize(error ? 0 : offset);
+        return error;
+    }
+
+#ifdef ENABLE_IO_URING
+    /**
+     * @brief Minimal io_uring wrapper over the raw syscalls. Owned and used by one thread.
+     */
+    class IoUring
+    {
+    public:
+
+        IoUring() noexcept = default;
+        ~IoUring() noexcept {
+            if (m_sqes) ::munmap(m_sqes, m_sqesSize);
+            if (m_cqRing && m_cqRing != m_sqRing) ::munmap(m_cqRing, m_cqRingSize);
+            if (m_sqRing) ::munmap(m_sqRing, m_sqRingSize);
+            if (m_fd >= 0) ::close(m_fd);
+        }
+
+        IoUring(const IoUring&) = delete;
+        IoUring& operator=(const IoUring&) = delete;
+
+        bool Init(unsigned entries) {
+            io_uring_params params = {};
+            m_fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+            if (m_fd < 0) return false;
+
+            m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool is_single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+            if (is_single_mmap) {
+                m_sqRingSize = m_cqRingSize = (std::max)(m_sqRingSize, m_cqRingSize);
+            }
+            m_sqRing = ::mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+            if (m_sqRing == MAP_FAILED) {
+                m_sqRing = nullptr;
+                return false;
+            }
+            m_cqRing = is_single_mmap ? m_sqRing : ::mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+            if (m_cqRing == MAP_FAILED) {
+                m_cqRing = nullptr;
+                return false;
+            }
+            m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            m_sqes = static_cast<io_uring_sqe*>(::mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES));
+            if (m_sqes == MAP_FAILED) {
+                m_sqes = nullptr;
+                return false;
+            }
+
+            auto* sq = static_cast<std::uint8_t*>(m_sqRing);
+            auto* cq = static_cast<std::uint8_t*>(m_cqRing);
+            m_sqHead    = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+            m_sqTail    = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            m_sqMask    = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            m_sqEntries = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_entries);
+            m_sqArray   = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            m_cqHead    = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            m_cqTail    = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            m_cqMask    = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            m_cqes      = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            m_localTail = *m_sqTail;
+            return true;
+        }
+
+        /**
+         * @brief Whether the kernel supports an opcode. false on kernels too old to be probed.
+         */
+        bool IsSupported(std::uint8_t opcode) const {
+            constexpr unsigned OP_COUNT = 256;
+            std::vector<std::uint8_t> buffer(sizeof(io_uring_probe) + OP_COUNT * sizeof(io_uring_probe_op));
+            auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+            if (::syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_PROBE, probe, OP_COUNT) < 0) return false;
+            return opcode <= probe->last_op && (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED);
+        }
+
+        /**
+         * @brief Next free submission entry, zeroed. nullptr if the queue is full.
+         */
+        io_uring_sqe* GetSqe() noexcept {
+            const unsigned head = __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+            if (m_localTail - head >= m_sqEntries) return nullptr;
+            const unsigned index = m_localTail & m_sqMask;
+            m_sqArray[index] = index;
+            ++m_localTail;
+            io_uring_sqe* sqe = &m_sqes[index];
+            std::memset(sqe, 0, sizeof(*sqe));
+            return sqe;
+        }
+
+        /**
+         * @brief Submit the prepared entries and wait for at least wait_count completions, in one syscall.
+         * @return false on an unexpected error.
+         */
+        bool SubmitAndWait(unsigned wait_count) noexcept {
+            __atomic_store_n(m_sqTail, m_localTail, __ATOMIC_RELEASE);
+            while (true) {
+                const unsigned to_submit = m_localTail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+                const long result = ::syscall(__NR_io_uring_enter, m_fd, to_submit, wait_count, wait_count ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+                if (result >= 0) return true;
+                if (errno == EINTR) continue;
+                // Completion queue is full, the caller reaps before submitting more
+                return errno == EAGAIN || errno == EBUSY;
+            }
+        }
+
+        /**
+         * @brief Call func(user_data, result) for every completion and release them.
+         */
+        template<class Func>
+        void ForEachCompletion(Func&& func) {
+            unsigned head = *m_cqHead;
+            const unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+            while (head != tail) {
+                const io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+                const auto user_data = cqe.user_data;
+                const auto result    = cqe.res;
+                ++head;
+                __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+                func(user_data, result);
+            }
+        }
+
+    private:
+
+        int           m_fd         = -1;
+        void*         m_sqRing     = nullptr;
+        void*         m_cqRing     = nullptr;
+        io_uring_sqe* m_sqes       = nullptr;
+        std::size_t   m_sqRingSize = 0;
+        std::size_t   m_cqRingSize = 0;
+        std::size_t   m_sqesSize   = 0;
+
+        unsigned*     m_sqHead     = nullptr;
+        unsigned*     m_sqTail     = nullptr;
+        unsigned*     m_sqArray    = nullptr;
+        unsigned      m_sqMask     = 0;
+        unsigned      m_sqEntries  = 0;
+        unsigned      m_localTail  = 0;
+        unsigned*     m_cqHead     = nullptr;
+        unsigned*     m_cqTail     = nullptr;
+        unsigned      m_cqMask     = 0;
+        io_uring_cqe* m_cqes       = nullptr;
+
+    };
+#endif
+
+}
+
+/**
+ * @class FileReadHandle
+ * @brief Result of an asynchronous whole file read.
+ * @details A default constructed handle is invalid and always ready.
+ */
+class FileReadHandle
+{
+public:
+
+    FileReadHandle() noexcept = default;
+
+    bool IsValid() const noexcept {
+        return m_spState != nullptr;
+    }
+
+    bool IsReady() const noexcept {
+        return m_completion.IsReady();
+    }
+
+    void Wait() const {
+        m_completion.Wait();
+    }
+
+    template<class Rep, class Period>
+    bool WaitFor(const std::chrono::duration<Rep, Period>& timeout) const {
+        return m_completion.WaitFor(timeout);
+    }
+
+    /**
+     * @brief true once the read has finished without error.
+     */
+    bool IsSucceeded() const noexcept {
+        return m_spState && IsReady() && m_spState->error == 0;
+    }
+
+    /**
+     * @brief OS error code of a failed read, 0 otherwise.
+     */
+    int GetError() const noexcept {
+        return m_spState && IsReady() ? m_spState->error : 0;
+    }
+
+    const std::string& GetPath() const noexcept {
+        return m_spState->path;
+    }
+
+    /**
+     * @brief Contents of the file. Only valid once ready.
+     */
+    const std::string& GetData() const noexcept {
+        return m_spState->data;
+    }
+
+    /**
+     * @brief Move the contents out of the handle. Only valid once ready.
+     */
+    std::string TakeData() noexcept {
+        return std::move(m_spState->data);
+    }
+
+    const CompletionHandle& GetCompletion() const noexcept {
+        return m_completion;
+    }
+
+private:
+
+    friend class AsyncFileService;
+
+    explicit FileReadHandle(std::shared_ptr<detail::FileReadState> state)
+        : m_spState(std::move(state))
+        , m_completion(m_spState->source.GetHandle())
+    {}
+
+    std::shared_ptr<detail::FileReadState> m_spState = nullptr;
+    CompletionHandle                       m_completion;
+
+};
+
+/**
+ * @class AsyncFileService
+ * @brief Reads whole files asynchronously and hands out completion handles.
+ * @details On Linux the reads go through io_uring: one I/O thread batches the open and read requests of every pending
+ *          file into a single io_uring_enter, so hundreds of small files cost a handful of syscalls instead of three
+ *          blocking ones each. Elsewhere, or when io_uring is unavailable, a small pool of threads reads with pread.
+ *          Completion callbacks run on the I/O thread and must be short, hand heavy work such as parsing to a JobSystem.
+ */
+class AsyncFileService
+{
+public:
+
+    enum class Backend {
+        IO_URING,
+        THREAD_POOL,
+    };
+
+    struct Options {
+        std::size_t queueDepth      = 256;   // Reads in flight at once on io_uring
+        std::size_t threadCount     = 4;     // Threads of the fallback pool
+        bool        forceThreadPool = false; // Skip io_uring even where it is available
+    };
+
+    AsyncFileService()
+        : AsyncFileService(Options{})
+    {}
+    explicit AsyncFileService(const Options& options)
+        : m_options(options)
+    {
+#ifdef ENABLE_IO_URING
+        if (!options.forceThreadPool && InitIoUring()) {
+            m_backend  = Backend::IO_URING;
+            m_ioThread = std::thread(&AsyncFileService::IoUringMain, this);
+            return;
+        }
+#endif
+        m_backend = Backend::THREAD_POOL;
+        const std::size_t thread_count = options.threadCount ? options.threadCount : 1;
+        for (std::size_t i = 0; i < thread_count; ++i) {
+            m_poolThreads.emplace_back(&AsyncFileService::PoolMain, this);
+        }
+    }
+    virtual ~AsyncFileService() noexcept {
+        Release();
+    }
+
+    AsyncFileService(const AsyncFileService&) = delete;
+    AsyncFileService& operator=(const AsyncFileService&) = delete;
+
+    /**
+     * @brief Process wide service used by modules that are not given one explicitly.
+     */
+    static AsyncFileService& GetDefault() {
+        static AsyncFileService instance;
+        return instance;
+    }
+
+    /**
+     * @brief Read a whole file.
+     * @param path Path of the file.
+     * @param on_complete Called on the I/O thread once the read has finished. May be empty.
+     * @return Handle of the read.
+     */
+    FileReadHandle ReadFile(std::string_view path, std::function<void(FileReadHandle)> on_complete = nullptr) {
+        auto state = MakeState(path, std::move(on_complete));
+        FileReadHandle handle(state);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_requests.emplace_back(std::move(state));
+        }
+        Wake();
+        return handle;
+    }
+
+    /**
+     * @brief Read many files. They are queued together and the I/O thread is woken once.
+     */
+    std::vector<FileReadHandle> ReadFiles(const std::vector<std::string>& paths) {
+        std::vector<FileReadHandle> handles;
+        handles.reserve(paths.size());
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto& e : paths) {
+                auto state = MakeState(e, nullptr);
+                handles.emplace_back(FileReadHandle(state));
+                m_requests.emplace_back(std::move(state));
+            }
+        }
+        Wake();
+        return handles;
+    }
+
+    /**
+     * @brief Backend serving the reads. Changes from IO_URING to THREAD_POOL if the ring fails.
+     */
+    Backend GetBackend() const noexcept {
+        return m_backend.load(std::memory_order_acquire);
+    }
+
+private:
+
+    static std::shared_ptr<detail::FileReadState> MakeState(std::string_view path, std::function<void(FileReadHandle)> on_complete) {
+        auto state = std::make_shared<detail::FileReadState>();
+        state->path       = path;
+        state->onComplete = std::move(on_complete);
+        return state;
+    }
+
+    static void Finish(const std::shared_ptr<detail::FileReadState>& state, int error) {
+        state->error = error;
+        if (error) {
+            state->data.clear();
+        }
+        state->source.SetReady();
+        if (state->onComplete) {
+            auto on_complete = std::move(state->onComplete);
+            on_complete(FileReadHandle(state));
+        }
+    }
+
+    void Wake() {
+#ifdef ENABLE_IO_URING
+        if (m_backend.load(std::memory_order_acquire) == Backend::IO_URING) {
+            // One write per batch, the I/O thread clears the flag before it takes the queue
+            if (!m_isWakePending.exchange(true, std::memory_order_acq_rel)) {
+                const std::uint64_t one = 1;
+                [[maybe_unused]] const auto written = ::write(m_eventFd, &one, sizeof(one));
+            }
+            return;
+        }
+#endif
+        m_cv.notify_all();
+    }
+
+    void PoolMain() {
+        while (true) {
+            std::shared_ptr<detail::FileReadState> state;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait(lock, [this] { return m_isStop || !m_requests.empty(); });
+                if (m_requests.empty()) return;
+                state = std::move(m_requests.front());
+                m_requests.pop_front();
+            }
+            const int error = detail::ReadWholeFile(state->path, &state->data);
+            Finish(state, error);
+        }
+    }
+
+#ifdef ENABLE_IO_URING
+    static constexpr std::size_t   UNKNOWN_SIZE_CHUNK = 64 * 1024;
+    static constexpr std::uint64_t WAKE_USER_DATA     = 0;
+
+    bool InitIoUring() {
+        m_eventFd = ::eventfd(0, EFD_CLOEXEC);
+        if (m_eventFd < 0) return false;
+        // One entry per read in flight plus the wake up read
+        const std::size_t depth = m_options.queueDepth ? m_options.queueDepth : 1;
+        // OPENAT and READ came with 5.6, older kernels set the ring up but fail every read
+        if (!m_ring.Init(static_cast<unsigned>(depth + 1)) || !m_ring.IsSupported(IORING_OP_OPENAT) || !m_ring.IsSupported(IORING_OP_READ)) {
+            ::close(m_eventFd);
+            m_eventFd = -1;
+            return false;
+        }
+        return true;
+    }
+
+    void ArmWake() {
+        io_uring_sqe* sqe = m_ring.GetSqe();
+        sqe->opcode    = IORING_OP_READ;
+        sqe->fd        = m_eventFd;
+        sqe->addr      = reinterpret_cast<std::uint64_t>(&m_eventValue);
+        sqe->len       = sizeof(m_eventValue);
+        sqe->user_data = WAKE_USER_DATA;
+    }
+
+    void SubmitOpen(detail::FileReadState* state) {
+        io_uring_sqe* sqe = m_ring.GetSqe();
+        sqe->opcode     = IORING_OP_OPENAT;
+        sqe->fd         = AT_FDCWD;
+        sqe->addr       = reinterpret_cast<std::uint64_t>(state->path.c_str());
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+        sqe->user_data  = reinterpret_cast<std::uint64_t>(state);
+    }
+
+    void SubmitRead(detail::FileReadState* state) {
+        io_uring_sqe* sqe = m_ring.GetSqe();
+        sqe->opcode    = IORING_OP_READ;
+        sqe->fd        = state->fd;
+        sqe->addr      = reinterpret_cast<std::uint64_t>(state->data.data() + state->offset);
+        sqe->len       = static_cast<std::uint32_t>((std::min<std::size_t>)(state->data.size() - state->offset, 0x7FFFF000));
+        sqe->off       = state->offset;
+        sqe->user_data = reinterpret_cast<std::uint64_t>(state);
+    }
+
+    /**
+     * @brief Advance a read after one of its operations completed.
+     * @return true if the read is finished.
+     */
+    bool OnCompletion(detail::FileReadState* state, int result) {
+        if (!state->isOpened) {
+            if (result < 0) {
+                Finish(state->spSelf, -result);
+                return true;
+            }
+            state->fd       = result;
+            state->isOpened = true;
+            struct stat st = {};
+            if (::fstat(state->fd, &st) < 0) {
+                const int error = errno;
+                ::close(state->fd);
+                Finish(state->spSelf, error);
+                return true;
+            }
+            state->isSizeKnown = st.st_size > 0;
+            state->data.resize(state->isSizeKnown ? static_cast<std::size_t>(st.st_size) : UNKNOWN_SIZE_CHUNK);
+            SubmitRead(state);
+            return false;
+        }
+
+        int error = 0;
+        if (result < 0) {
+            if (result == -EINTR || result == -EAGAIN) {
+                SubmitRead(state);
+                return false;
+            }
+            error = -result;
+        }
+        else if (result > 0) {
+            state->offset += static_cast<std::size_t>(result);
+            if (state->offset < state->data.size() || !state->isSizeKnown) {
+                if (state->offset == state->data.size()) {
+                    state->data.resize(state->data.size() * 2);
+                }
+                SubmitRead(state);
+                return false;
+            }
+        }
+        ::close(state->fd);
+        state->data.resize(state->offset);
+        Finish(state->spSelf, error);
+        return true;
+    }
+
+    void IoUringMain() {
+        std::deque<std::shared_ptr<detail::FileReadState>> backlog;
+        std::vector<std::shared_ptr<detail::FileReadState>> in_flight;
+        bool is_woken       = true;
+        bool is_stop        = false;
+        bool is_wake_failed = false;
+        ArmWake();
+
+        while (true) {
+            if (is_woken) {
+                m_isWakePending.store(false, std::memory_order_release);
+                std::lock_guard<std::mutex> lock(m_mutex);
+                while (!m_requests.empty()) {
+                    backlog.emplace_back(std::move(m_requests.front()));
+                    m_requests.pop_front();
+                }
+                is_stop  = m_isStop;
+                is_woken = false;
+            }
+            while (in_flight.size() < m_options.queueDepth && !backlog.empty()) {
+                auto& state = backlog.front();
+                state->spSelf = state;
+                SubmitOpen(state.get());
+                in_flight.emplace_back(std::move(state));
+                backlog.pop_front();
+            }
+            if (is_stop && in_flight.empty() && backlog.empty()) break;
+
+            if (!m_ring.SubmitAndWait(1)) {
+                FallBackToThreadPool(&in_flight, &backlog);
+                return;
+            }
+            m_ring.ForEachCompletion([&](std::uint64_t user_data, int result) {
+                if (user_data == WAKE_USER_DATA) {
+                    // A failed read of the eventfd would fail again at once if re-armed
+                    is_wake_failed = result < 0;
+                    is_woken       = true;
+                    if (!is_wake_failed) {
+                        ArmWake();
+                    }
+                    return;
+                }
+                auto* state = reinterpret_cast<detail::FileReadState*>(user_data);
+                if (OnCompletion(state, result)) {
+                    state->spSelf = nullptr;
+                    in_flight.erase(std::find_if(in_flight.begin(), in_flight.end(), [state](const auto& e) { return e.get() == state; }));
+                }
+            });
+            if (is_wake_failed) {
+                FallBackToThreadPool(&in_flight, &backlog);
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Finish every read of the ring with blocking reads and serve later requests as a pool thread.
+     * @details Reads already submitted may still complete in the kernel, so their buffers are kept alive until the
+     *          service is destroyed and the data is read again into a new one.
+     */
+    void FallBackToThreadPool(std::vector<std::shared_ptr<detail::FileReadState>>* in_flight, std::deque<std::shared_ptr<detail::FileReadState>>* backlog) {
+        assert::ShowWarning(ASSERT_FILE_LINE, "io_uring failed, falling back to blocking reads");
+        // Requests queued from now on wake the pool condition variable instead of the eventfd
+        m_backend.store(Backend::THREAD_POOL, std::memory_order_release);
+        for (auto&& e : *in_flight) {
+            if (e->isOpened) {
+                ::close(e->fd);
+            }
+            m_abandonedBuffers.emplace_back(std::make_unique<std::string>(std::move(e->data)));
+            e->data   = std::string();
+            e->spSelf = nullptr;
+            Finish(e, detail::ReadWholeFile(e->path, &e->data));
+        }
+        in_flight->clear();
+        for (auto&& e : *backlog) {
+            Finish(e, detail::ReadWholeFile(e->path, &e->data));
+        }
+        backlog->clear();
+        PoolMain();
+    }
+#endif
+
+    void Release() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_isStop = true;
+        }
+        m_cv.notify_all();
+#ifdef ENABLE_IO_URING
+        // The I/O thread waits on the eventfd, or on the condition variable once it fell back to the pool
+        if (m_ioThread.joinable()) {
+            const std::uint64_t one = 1;
+            [[maybe_unused]] const auto written = ::write(m_eventFd, &one, sizeof(one));
+            m_ioThread.join();
+            ::close(m_eventFd);
+            m_eventFd = -1;
+        }
+#endif
+        for (auto&& e : m_poolThreads) {
+            if (e.joinable()) {
+                e.join();
+            }
+        }
+        m_poolThreads.clear();
+    }
+
+    const Options                                      m_options;
+    std::atomic<Backend>                               m_backend = Backend::THREAD_POOL;
+
+    std::mutex                                         m_mutex;
+    std::condition_variable                            m_cv;
+    std::deque<std::shared_ptr<detail::FileReadState>> m_requests;
+    bool                                               m_isStop  = false;
+
+    std::vector<std::thread>                           m_poolThreads;
+
+#ifdef ENABLE_IO_URING
+    detail::IoUring                                    m_ring;
+    std::thread                                        m_ioThread;
+    int                                                m_eventFd       = -1;
+    std::uint64_t                                      m_eventValue    = 0;
+    std::atomic<bool>                                  m_isWakePending = false;
+    std::vector<std::unique_ptr<std::string>>          m_abandonedBuffers;
+#endif
+
+};
+
+#endif
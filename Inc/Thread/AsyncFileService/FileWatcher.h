@@ -0,0 +1,299 @@
+﻿/**
+ * @file FileWatcher.h
+ * @author shirokuma1101
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023 shirokuma1101. All rights reserved.
+ * @license MIT License (see LICENSE.txt file)
+ */
+
+#pragma once
+
+#ifndef GAME_LIBRARIES_THREAD_ASYNCFILESERVICE_FILEWATCHER_H_
+#define GAME_LIBRARIES_THREAD_ASYNCFILESERVICE_FILEWATCHER_H_
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__) && !defined(DISABLE_INOTIFY) && __has_include(<sys/inotify.h>)
+#define ENABLE_INOTIFY
+#endif
+
+#ifdef ENABLE_INOTIFY
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @class FileWatcher
+ * @brief Reports changes of a set of files from a background thread.
+ * @details Uses inotify on Linux, where the directories of the watched files are watched so files replaced by a
+ *          rename (as most editors save) are caught too. Elsewhere the files are polled. Changes are coalesced: the
+ *          callback gets each changed path once, after no change has been seen for the debounce time.
+ */
+class FileWatcher
+{
+public:
+
+    /**
+     * @brief Called on the watcher thread with the normalized paths of the changed files.
+     */
+    using Callback = std::function<void(const std::vector<std::string>&)>;
+
+    struct Options {
+        std::chrono::milliseconds debounce     = std::chrono::milliseconds(50);  // Quiet time before changes are reported
+        std::chrono::milliseconds pollInterval = std::chrono::milliseconds(500); // Interval of the polling fallback
+    };
+
+    explicit FileWatcher(Callback callback)
+        : FileWatcher(std::move(callback), Options{})
+    {}
+    FileWatcher(Callback callback, const Options& options)
+        : m_callback(std::move(callback))
+        , m_options(options)
+    {
+#ifdef ENABLE_INOTIFY
+        m_inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        m_wakeFd    = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (m_inotifyFd >= 0 && m_wakeFd >= 0) {
+            m_thread = std::thread(&FileWatcher::InotifyMain, this);
+            return;
+        }
+        CloseFds();
+#endif
+        m_thread = std::thread(&FileWatcher::PollMain, this);
+    }
+    ~FileWatcher() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_isStopRequested = true;
+        }
+        m_cv.notify_all();
+#ifdef ENABLE_INOTIFY
+        if (m_wakeFd >= 0) {
+            const std::uint64_t one = 1;
+            [[maybe_unused]] const auto written = ::write(m_wakeFd, &one, sizeof(one));
+        }
+#endif
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+#ifdef ENABLE_INOTIFY
+        CloseFds();
+#endif
+    }
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * @brief Absolute, lexically normalized form of a path. Paths given to the callback have this form.
+     */
+    static std::string NormalizePath(const std::string& path) {
+        std::error_code error;
+        auto absolute_path = std::filesystem::absolute(path, error);
+        return (error ? std::filesystem::path(path) : absolute_path).lexically_normal().string();
+    }
+
+    /**
+     * @brief Start watching a file. The file does not have to exist yet.
+     * @return false if the directory of the file could not be watched.
+     */
+    bool Watch(const std::string& path) {
+        const auto normalized = NormalizePath(path);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_files.count(normalized)) return true;
+#ifdef ENABLE_INOTIFY
+        if (m_inotifyFd >= 0) {
+            const auto directory = std::filesystem::path(normalized).parent_path().string();
+            auto& watch = m_directories[directory];
+            if (!watch.fileCount) {
+                watch.wd = ::inotify_add_watch(m_inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+                if (watch.wd < 0) {
+                    m_directories.erase(directory);
+                    return false;
+                }
+                m_wdDirectories[watch.wd] = directory;
+            }
+            ++watch.fileCount;
+        }
+#endif
+        m_files.emplace(normalized, GetStamp(normalized));
+        return true;
+    }
+
+    void Unwatch(const std::string& path) {
+        const auto normalized = NormalizePath(path);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_files.erase(normalized)) return;
+#ifdef ENABLE_INOTIFY
+        if (m_inotifyFd >= 0) {
+            const auto directory = std::filesystem::path(normalized).parent_path().string();
+            if (auto iter = m_directories.find(directory); iter != m_directories.end() && !--iter->second.fileCount) {
+                ::inotify_rm_watch(m_inotifyFd, iter->second.wd);
+                m_wdDirectories.erase(iter->second.wd);
+                m_directories.erase(iter);
+            }
+        }
+#endif
+    }
+
+    bool IsWatching(const std::string& path) const {
+        const auto normalized = NormalizePath(path);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_files.count(normalized) != 0;
+    }
+
+    /**
+     * @brief true if changes are reported by inotify, false if the files are polled.
+     */
+    bool IsUsingNotifications() const noexcept {
+#ifdef ENABLE_INOTIFY
+        return m_inotifyFd >= 0;
+#else
+        return false;
+#endif
+    }
+
+private:
+
+    struct FileStamp {
+        std::uintmax_t size = 0;
+        std::int64_t   time = 0;
+
+        bool operator==(const FileStamp& other) const noexcept {
+            return size == other.size && time == other.time;
+        }
+    };
+
+    static FileStamp GetStamp(const std::string& path) {
+        FileStamp stamp;
+        std::error_code error;
+        stamp.size = std::filesystem::file_size(path, error);
+        if (error) return {};
+        const auto time = std::filesystem::last_write_time(path, error);
+        if (error) return {};
+        stamp.time = static_cast<std::int64_t>(time.time_since_epoch().count());
+        return stamp;
+    }
+
+    void Flush(std::unordered_set<std::string>* pending) {
+        if (pending->empty()) return;
+        std::vector<std::string> paths(pending->begin(), pending->end());
+        pending->clear();
+        m_callback(paths);
+    }
+
+#ifdef ENABLE_INOTIFY
+    struct DirectoryWatch {
+        int         wd        = -1;
+        std::size_t fileCount = 0;
+    };
+
+    void CloseFds() noexcept {
+        if (m_inotifyFd >= 0) ::close(m_inotifyFd);
+        if (m_wakeFd >= 0) ::close(m_wakeFd);
+        m_inotifyFd = -1;
+        m_wakeFd    = -1;
+    }
+
+    void InotifyMain() {
+        std::unordered_set<std::string> pending;
+        auto last_event = std::chrono::steady_clock::now();
+        alignas(inotify_event) char buffer[16 * 1024];
+
+        while (true) {
+            int timeout = -1;
+            if (!pending.empty()) {
+                const auto elapsed = std::chrono::steady_clock::now() - last_event;
+                timeout = static_cast<int>((std::max<std::int64_t>)(std::chrono::duration_cast<std::chrono::milliseconds>(m_options.debounce - elapsed).count(), 0));
+            }
+            pollfd fds[2] = { { m_inotifyFd, POLLIN, 0 }, { m_wakeFd, POLLIN, 0 } };
+            const int ready = ::poll(fds, 2, timeout);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_isStopRequested) return;
+            }
+            if (ready > 0 && (fds[0].revents & POLLIN)) {
+                while (true) {
+                    const auto length = ::read(m_inotifyFd, buffer, sizeof(buffer));
+                    if (length <= 0) break;
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    for (char* p = buffer; p < buffer + length;) {
+                        const auto* event = reinterpret_cast<const inotify_event*>(p);
+                        p += sizeof(inotify_event) + event->len;
+                        if (!event->len) continue;
+                        auto iter = m_wdDirectories.find(event->wd);
+                        if (iter == m_wdDirectories.end()) continue;
+                        auto path = (std::filesystem::path(iter->second) / event->name).string();
+                        if (m_files.count(path)) {
+                            pending.insert(std::move(path));
+                        }
+                    }
+                }
+                last_event = std::chrono::steady_clock::now();
+            }
+            if (!pending.empty() && std::chrono::steady_clock::now() - last_event >= m_options.debounce) {
+                Flush(&pending);
+            }
+        }
+    }
+#endif
+
+    void PollMain() {
+        std::unordered_set<std::string> pending;
+        auto last_change = std::chrono::steady_clock::now();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_isStopRequested) {
+            m_cv.wait_for(lock, pending.empty() ? m_options.pollInterval : (std::min)(m_options.pollInterval, m_options.debounce));
+            if (m_isStopRequested) return;
+            for (auto&& e : m_files) {
+                const auto stamp = GetStamp(e.first);
+                if (!(stamp == e.second)) {
+                    e.second = stamp;
+                    pending.insert(e.first);
+                    last_change = std::chrono::steady_clock::now();
+                }
+            }
+            if (!pending.empty() && std::chrono::steady_clock::now() - last_change >= m_options.debounce) {
+                lock.unlock();
+                Flush(&pending);
+                lock.lock();
+            }
+        }
+    }
+
+    Callback                                        m_callback;
+    const Options                                   m_options;
+
+    mutable std::mutex                              m_mutex;
+    std::condition_variable                         m_cv;
+    bool                                            m_isStopRequested = false;
+    std::unordered_map<std::string, FileStamp>      m_files;
+#ifdef ENABLE_INOTIFY
+    int                                             m_inotifyFd = -1;
+    int                                             m_wakeFd    = -1;
+    std::unordered_map<std::string, DirectoryWatch> m_directories;
+    std::unordered_map<int, std::string>            m_wdDirectories;
+#endif
+    std::thread                                     m_thread;
+
+};
+
+#endif
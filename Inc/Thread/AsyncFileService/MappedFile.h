@@ -0,0 +1,239 @@
+﻿/**
+ * @file MappedFile.h
+ * @author shirokuma1101
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023 shirokuma1101. All rights reserved.
+ * @license MIT License (see LICENSE.txt file)
+ */
+
+#pragma once
+
+#ifndef GAME_LIBRARIES_THREAD_ASYNCFILESERVICE_MAPPEDFILE_H_
+#define GAME_LIBRARIES_THREAD_ASYNCFILESERVICE_MAPPEDFILE_H_
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @class MappedFile
+ * @brief Read-only memory mapping of a whole file.
+ * @details Parsers read straight from GetView, the bytes are never copied into a buffer. The mapping is hinted for
+ *          sequential access, so the kernel reads ahead aggressively and drops pages behind the reader.
+ */
+class MappedFile
+{
+public:
+
+    MappedFile() noexcept = default;
+    explicit MappedFile(const std::string& path) {
+        Open(path);
+    }
+    ~MappedFile() noexcept {
+        Close();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : m_pData(std::exchange(other.m_pData, nullptr))
+        , m_size(std::exchange(other.m_size, 0))
+        , m_error(std::exchange(other.m_error, 0))
+        , m_isOpened(std::exchange(other.m_isOpened, false))
+    {}
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            Close();
+            m_pData    = std::exchange(other.m_pData, nullptr);
+            m_size     = std::exchange(other.m_size, 0);
+            m_error    = std::exchange(other.m_error, 0);
+            m_isOpened = std::exchange(other.m_isOpened, false);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Map a file, unmapping the previous one.
+     * @return false if the file could not be opened or mapped, see GetError.
+     */
+    bool Open(const std::string& path) {
+        Close();
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            m_error = static_cast<int>(GetLastError());
+            return false;
+        }
+        LARGE_INTEGER size = {};
+        GetFileSizeEx(file, &size);
+        m_size = static_cast<std::size_t>(size.QuadPart);
+        // Empty files cannot be mapped, they are valid with an empty view
+        if (m_size) {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping) {
+                m_pData = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                CloseHandle(mapping);
+            }
+            if (!m_pData) {
+                m_error = static_cast<int>(GetLastError());
+                m_size  = 0;
+                CloseHandle(file);
+                return false;
+            }
+        }
+        CloseHandle(file);
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            m_error = errno;
+            return false;
+        }
+        struct stat st = {};
+        if (::fstat(fd, &st) != 0) {
+            m_error = errno;
+            ::close(fd);
+            return false;
+        }
+        m_size = static_cast<std::size_t>(st.st_size);
+        // Empty files cannot be mapped, they are valid with an empty view
+        if (m_size) {
+            void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                m_error = errno;
+                m_size  = 0;
+                ::close(fd);
+                return false;
+            }
+            ::madvise(data, m_size, MADV_SEQUENTIAL);
+            ::madvise(data, m_size, MADV_WILLNEED);
+            m_pData = static_cast<const char*>(data);
+        }
+        ::close(fd);
+#endif
+        m_isOpened = true;
+        return true;
+    }
+
+    void Close() noexcept {
+        if (m_pData) {
+#ifdef _WIN32
+            UnmapViewOfFile(m_pData);
+#else
+            ::munmap(const_cast<char*>(m_pData), m_size);
+#endif
+        }
+        m_pData    = nullptr;
+        m_size     = 0;
+        m_error    = 0;
+        m_isOpened = false;
+    }
+
+    bool IsOpened() const noexcept {
+        return m_isOpened;
+    }
+
+    /**
+     * @brief errno (GetLastError on Windows) of the last failed Open, 0 otherwise.
+     */
+    int GetError() const noexcept {
+        return m_error;
+    }
+
+    std::size_t GetSize() const noexcept {
+        return m_size;
+    }
+
+    std::string_view GetView() const noexcept {
+        return std::string_view(m_pData, m_size);
+    }
+
+private:
+
+    const char* m_pData    = nullptr;
+    std::size_t m_size     = 0;
+    int         m_error    = 0;
+    bool        m_isOpened = false;
+
+};
+
+/**
+ * @class MappedFileCache
+ * @brief Shares one read-only mapping per path between everyone that has it open.
+ * @details The cache only holds weak references, a mapping is unmapped as soon as its last user releases it.
+ */
+class MappedFileCache
+{
+public:
+
+    /**
+     * @brief Cache shared by assets that do not specify their own.
+     */
+    static MappedFileCache& GetDefault() {
+        static MappedFileCache cache;
+        return cache;
+    }
+
+    /**
+     * @brief Get the mapping of a file, mapping it if nobody has it open.
+     * @return nullptr if the file could not be mapped.
+     */
+    std::shared_ptr<const MappedFile> Open(const std::string& path) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& entry = m_files[path];
+        if (auto file = entry.lock()) {
+            return file;
+        }
+        auto file = std::make_shared<MappedFile>();
+        if (!file->Open(path)) {
+            m_files.erase(path);
+            return nullptr;
+        }
+        entry = file;
+        // Drop expired entries now and then so paths that are never opened again do not pile up
+        if (m_files.size() >= m_pruneThreshold) {
+            for (auto iter = m_files.begin(); iter != m_files.end();) {
+                iter = iter->second.expired() ? m_files.erase(iter) : std::next(iter);
+            }
+            m_pruneThreshold = (m_files.size() + 1) * 2;
+        }
+        return file;
+    }
+
+    /**
+     * @brief Number of paths currently mapped.
+     */
+    std::size_t GetOpenCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::size_t count = 0;
+        for (const auto& e : m_files) {
+            count += !e.second.expired();
+        }
+        return count;
+    }
+
+private:
+
+    mutable std::mutex                                         m_mutex;
+    std::unordered_map<std::string, std::weak_ptr<MappedFile>> m_files;
+    std::size_t                                                m_pruneThreshold = 64;
+
+};
+
+#endif
@@ -0,0 +1,164 @@
+﻿/**
+ * @file ChaseLevDeque.h
+ * @author shirokuma1101
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023 shirokuma1101. All rights reserved.
+ * @license MIT License (see LICENSE.txt file)
+ */
+
+#pragma once
+
+#ifndef GAME_LIBRARIES_THREAD_JOBSYSTEM_CHASELEVDEQUE_H_
+#define GAME_LIBRARIES_THREAD_JOBSYSTEM_CHASELEVDEQUE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "Thread/ThreadHelper/ThreadHelper.h"
+
+/**
+ * @class ChaseLevDeque
+ * @brief Lock-free work-stealing deque (Chase-Lev, with the memory orderings of Le et al. 2013).
+ * @details The owner thread pushes and pops at the bottom, any other thread may steal from the top.
+ *          The buffer grows on demand. Retired buffers are kept until destruction because a thief may still be reading them.
+ * @tparam T Element type. Must be trivially copyable (typically a pointer).
+ */
+template<class T>
+class ChaseLevDeque
+{
+public:
+
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+    explicit ChaseLevDeque(std::int64_t capacity = 1024)
+        : m_top(0)
+        , m_bottom(0)
+    {
+        std::int64_t pow2 = 1;
+        while (pow2 < capacity) pow2 <<= 1;
+        m_upArrays.emplace_back(std::make_unique<Array>(pow2));
+        m_pArray.store(m_upArrays.back().get(), std::memory_order_relaxed);
+    }
+    ~ChaseLevDeque() noexcept = default;
+
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    /**
+     * @brief Push an element at the bottom. Owner thread only.
+     * @param value The element to push.
+     */
+    void Push(T value) {
+        const std::int64_t b = m_bottom.load(std::memory_order_relaxed);
+        const std::int64_t t = m_top.load(std::memory_order_acquire);
+        Array* array = m_pArray.load(std::memory_order_relaxed);
+        if (b - t > array->capacity - 1) {
+            array = Grow(array, b, t);
+        }
+        array->Put(b, value);
+        // A release store rather than a release fence, same ordering but visible to ThreadSanitizer
+        m_bottom.store(b + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Pop an element from the bottom. Owner thread only.
+     * @param value Receives the popped element.
+     * @return true if an element was popped.
+     */
+    bool Pop(T* value) {
+        const std::int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+        Array* array = m_pArray.load(std::memory_order_relaxed);
+        m_bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = m_top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        *value = array->Get(b);
+        if (t == b) {
+            // Last element, race against thieves
+            const bool won = m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Steal an element from the top. Any thread.
+     * @param value Receives the stolen element.
+     * @return true if an element was stolen, false if the deque was empty or the steal lost a race.
+     */
+    bool Steal(T* value) {
+        std::int64_t t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = m_bottom.load(std::memory_order_acquire);
+
+        if (t >= b) return false;
+
+        Array* array = m_pArray.load(std::memory_order_acquire);
+        *value = array->Get(t);
+        return m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Approximate number of elements. Only exact when called by the owner with no concurrent thieves.
+     */
+    std::int64_t Size() const noexcept {
+        const std::int64_t b = m_bottom.load(std::memory_order_relaxed);
+        const std::int64_t t = m_top.load(std::memory_order_relaxed);
+        return b > t ? b - t : 0;
+    }
+
+    bool IsEmpty() const noexcept {
+        return Size() == 0;
+    }
+
+private:
+
+    struct Array {
+        explicit Array(std::int64_t cap)
+            : capacity(cap)
+            , mask(cap - 1)
+            , upBuffer(std::make_unique<std::atomic<T>[]>(static_cast<std::size_t>(cap)))
+        {}
+
+        T Get(std::int64_t i) const noexcept {
+            return upBuffer[static_cast<std::size_t>(i & mask)].load(std::memory_order_relaxed);
+        }
+        void Put(std::int64_t i, T value) noexcept {
+            upBuffer[static_cast<std::size_t>(i & mask)].store(value, std::memory_order_relaxed);
+        }
+
+        const std::int64_t                      capacity;
+        const std::int64_t                      mask;
+        const std::unique_ptr<std::atomic<T>[]> upBuffer;
+    };
+
+    Array* Grow(Array* old_array, std::int64_t bottom, std::int64_t top) {
+        auto new_array = std::make_unique<Array>(old_array->capacity * 2);
+        for (std::int64_t i = top; i < bottom; ++i) {
+            new_array->Put(i, old_array->Get(i));
+        }
+        Array* raw = new_array.get();
+        m_upArrays.emplace_back(std::move(new_array));
+        m_pArray.store(raw, std::memory_order_release);
+        return raw;
+    }
+
+    alignas(thread_helper::CACHE_LINE_SIZE) std::atomic<std::int64_t> m_top;
+    alignas(thread_helper::CACHE_LINE_SIZE) std::atomic<std::int64_t> m_bottom;
+    alignas(thread_helper::CACHE_LINE_SIZE) std::atomic<Array*>       m_pArray;
+    std::vector<std::unique_ptr<Array>>                                m_upArrays;
+
+};
+
+#endif
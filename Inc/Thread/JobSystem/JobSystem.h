@@ -0,0 +1,698 @@
+﻿/**
+ * @file JobSystem.h
+ * @author shirokuma1101
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023 shirokuma1101. All rights reserved.
+ * @license MIT License (see LICENSE.txt file)
+ */
+
+#pragma once
+
+#ifndef GAME_LIBRARIES_THREAD_JOBSYSTEM_JOBSYSTEM_H_
+#define GAME_LIBRARIES_THREAD_JOBSYSTEM_JOBSYSTEM_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Thread/JobSystem/ChaseLevDeque.h"
+#include "Thread/JobSystem/JobTrace.h"
+#include "Thread/JobSystem/ScratchArena.h"
+#include "Thread/ThreadHelper/ThreadHelper.h"
+#include "Utility/Assert.h"
+
+class JobSystem;
+
+namespace detail {
+
+    /**
+     * @brief Number of outstanding jobs of a handle. Waiters block on the condition variable once it reaches zero.
+     */
+    struct JobCounter {
+        std::atomic<std::int64_t> remaining = 0;
+        std::mutex                mutex;
+        std::condition_variable   cv;
+        std::exception_ptr        exception = nullptr; // First exception thrown by a job of the handle, under mutex
+
+        bool IsDone() const noexcept {
+            return remaining.load(std::memory_order_acquire) <= 0;
+        }
+        void Add(std::int64_t count = 1) noexcept {
+            remaining.fetch_add(count, std::memory_order_relaxed);
+        }
+        void Fail(std::exception_ptr error) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!exception) {
+                exception = std::move(error);
+            }
+        }
+        void Done() {
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(mutex);
+                cv.notify_all();
+            }
+        }
+        void Block() {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this] { return IsDone(); });
+        }
+        template<class Rep, class Period>
+        bool BlockFor(const std::chrono::duration<Rep, Period>& timeout) {
+            std::unique_lock<std::mutex> lock(mutex);
+            return cv.wait_for(lock, timeout, [this] { return IsDone(); });
+        }
+    };
+
+    struct Job {
+        std::function<void()>       func;
+        std::shared_ptr<JobCounter> spCounter      = nullptr;
+        bool                        isPreallocated = false;
+        std::uint64_t               traceKey       = 0;
+    };
+
+    /**
+     * @brief Identifies which JobSystem worker (if any) the calling thread is.
+     */
+    struct JobWorkerContext {
+        const JobSystem* pOwner = nullptr;
+        std::size_t      index  = 0;
+    };
+
+    inline JobWorkerContext& CurrentJobWorker() noexcept {
+        static thread_local JobWorkerContext context;
+        return context;
+    }
+
+    /**
+     * @brief Job running on the calling thread while tracing, used to derive the keys of the jobs it submits.
+     */
+    struct JobTraceContext {
+        std::uint64_t jobKey     = 0;
+        std::uint64_t childCount = 0;
+    };
+
+    inline JobTraceContext& CurrentJobTrace() noexcept {
+        static thread_local JobTraceContext context;
+        return context;
+    }
+
+}
+
+/**
+ * @class JobHandle
+ * @brief Waitable handle of one job or of a group of jobs.
+ * @details A default constructed handle is invalid and always done. A job that throws counts as finished and its
+ *          exception is kept by the handle, Wait does not rethrow it.
+ */
+class JobHandle
+{
+public:
+
+    JobHandle() noexcept = default;
+
+    bool IsValid() const noexcept {
+        return m_spCounter != nullptr;
+    }
+
+    bool IsDone() const noexcept {
+        return !m_spCounter || m_spCounter->IsDone();
+    }
+
+    /**
+     * @brief Block until every job of the handle has finished. Runs other pending jobs while waiting.
+     */
+    inline void Wait() const;
+
+    /**
+     * @brief First exception thrown by a job of the handle, nullptr if none threw. Read once the handle is done.
+     */
+    std::exception_ptr GetException() const {
+        if (!m_spCounter) return nullptr;
+        std::lock_guard<std::mutex> lock(m_spCounter->mutex);
+        return m_spCounter->exception;
+    }
+
+private:
+
+    friend class JobSystem;
+
+    JobHandle(std::shared_ptr<detail::JobCounter> counter, JobSystem* owner) noexcept
+        : m_spCounter(std::move(counter))
+        , m_pOwner(owner)
+    {}
+
+    std::shared_ptr<detail::JobCounter> m_spCounter = nullptr;
+    JobSystem*                          m_pOwner    = nullptr;
+
+};
+
+/**
+ * @class JobSystem
+ * @brief Fixed pool of worker threads with per-worker work-stealing deques.
+ * @details Jobs submitted from a worker go to that worker's deque, jobs submitted from any other thread go to a shared injection queue.
+ *          Idle workers steal from each other and sleep on a condition variable when there is nothing to run.
+ *          While recording, every job gets a key derived from the job that submitted it and its submission index there,
+ *          so the same program submitting the same jobs produces the same keys whatever the interleaving. A JobSystem
+ *          created with a trace to replay starts no workers and runs jobs on the waiting thread in the recorded order.
+ */
+class JobSystem
+{
+public:
+
+    /**
+     * @brief Job object owned by the caller, see SubmitPrepared.
+     */
+    using PreparedJob = detail::Job;
+
+    /**
+     * @brief Creation options of the workers.
+     */
+    struct Options {
+        std::size_t                   workerCount        = 0;     // 0 uses one worker per logical (or physical, when pinned) processor minus the calling thread
+        bool                          pinToPhysicalCores = false; // Pin worker i to the hardware threads of physical core i % (cores - 1) + 1, core 0 is left to the main thread. Unpinned on a single core
+        thread_helper::ThreadPriority priority           = thread_helper::ThreadPriority::NORMAL;
+        std::string                   name               = "JobWorker";
+        const JobTrace*               pReplay            = nullptr; // Replay this trace on the waiting thread, no workers are started
+    };
+
+    /**
+     * @param worker_count Number of worker threads. 0 uses one worker per logical processor minus the calling thread.
+     */
+    explicit JobSystem(std::size_t worker_count = 0)
+        : JobSystem(Options{ worker_count })
+    {}
+    explicit JobSystem(const Options& options)
+        : m_isStop(false)
+        , m_pendingJobs(0)
+        , m_sleepingWorkers(0)
+    {
+        if (options.pReplay) {
+            // Jobs missing from the trace run after every recorded one, in submission order
+            const auto order = options.pReplay->GetExecutionOrder();
+            for (std::size_t i = 0; i < order.size(); ++i) {
+                m_replayRanks.emplace(order[i], i);
+            }
+            m_replayWorkerCount = options.pReplay->GetWorkerCount();
+            m_isReplay          = true;
+            return;
+        }
+
+        std::size_t worker_count = options.workerCount;
+        thread_helper::CpuTopology topology;
+        if (options.pinToPhysicalCores) {
+            topology = thread_helper::GetCpuTopology();
+        }
+        if (worker_count == 0) {
+            const auto processors = options.pinToPhysicalCores ? topology.physicalCores.size() : thread_helper::GetLogicalProcessorCount();
+            worker_count = processors > 1 ? processors - 1 : 1;
+        }
+        m_upWorkers.reserve(worker_count);
+        for (std::size_t i = 0; i < worker_count; ++i) {
+            m_upWorkers.emplace_back(std::make_unique<Worker>(static_cast<std::uint32_t>(i)));
+        }
+        for (std::size_t i = 0; i < worker_count; ++i) {
+            thread_helper::ThreadOptions thread_options;
+            thread_options.priority = options.priority;
+            thread_options.name     = options.name + std::to_string(i);
+            if (options.pinToPhysicalCores && topology.physicalCores.size() > 1) {
+                // More workers than cores share cores 1 to n - 1, never the core of the main thread
+                thread_options.affinity = topology.physicalCores[i % (topology.physicalCores.size() - 1) + 1];
+            }
+            m_upWorkers[i]->thread = std::thread(&JobSystem::WorkerMain, this, i, std::move(thread_options));
+        }
+    }
+    virtual ~JobSystem() noexcept {
+        Release();
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * @brief Process wide job system used by modules that are not given one explicitly.
+     */
+    static JobSystem& GetDefault() {
+        static JobSystem instance;
+        return instance;
+    }
+
+    /**
+     * @brief Create an empty group. Jobs added with Submit(group, func) are waited together.
+     */
+    JobHandle CreateGroup() {
+        return JobHandle(std::make_shared<detail::JobCounter>(), this);
+    }
+
+    /**
+     * @brief Submit a job.
+     * @param func Callable with signature void().
+     * @return Handle of the job.
+     */
+    template<class Func>
+    JobHandle Submit(Func&& func) {
+        auto handle = CreateGroup();
+        Submit(handle, std::forward<Func>(func));
+        return handle;
+    }
+
+    /**
+     * @brief Submit a job as part of a group.
+     * @param group Handle created by CreateGroup or returned by Submit.
+     * @param func Callable with signature void().
+     */
+    template<class Func>
+    void Submit(const JobHandle& group, Func&& func) {
+        group.m_spCounter->Add();
+        Push(new detail::Job{ std::function<void()>(std::forward<Func>(func)), group.m_spCounter });
+    }
+
+    /**
+     * @brief Submit a job object owned by the caller. Nothing is allocated.
+     * @details The job must stay alive until it has run and must not be submitted again before that.
+     * @param group Handle created by CreateGroup or returned by Submit.
+     * @param job The job to run. func must be set.
+     */
+    void SubmitPrepared(const JobHandle& group, PreparedJob* job) {
+        group.m_spCounter->Add();
+        job->spCounter      = group.m_spCounter;
+        job->isPreallocated = true;
+        Push(job);
+    }
+
+    /**
+     * @brief Wait for a handle. The calling thread runs pending jobs until the handle is done.
+     * @param handle The handle to wait for.
+     */
+    void Wait(const JobHandle& handle) {
+        if (!handle.m_spCounter) return;
+        auto& counter = *handle.m_spCounter;
+        const bool is_worker = IsWorkerThread();
+        if (counter.IsDone()) return;
+
+        const auto group_id = reinterpret_cast<std::uintptr_t>(&counter);
+        RecordEvent(JobTraceEvent::Type::WAIT_BEGIN, 0, group_id);
+        while (!counter.IsDone()) {
+            if (RunPendingJob()) continue;
+            if (!is_worker && !m_upWorkers.empty()) {
+                // Every remaining job is owned by a worker, sleep until the last one finishes
+                counter.Block();
+                break;
+            }
+            counter.BlockFor(std::chrono::microseconds(100));
+        }
+        RecordEvent(JobTraceEvent::Type::WAIT_END, 0, group_id);
+    }
+
+    /**
+     * @brief Run one pending job on the calling thread.
+     * @return true if a job was run.
+     */
+    bool RunPendingJob() {
+        if (detail::Job* job = FindJob()) {
+            Execute(job);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Number of worker threads. When replaying, the worker count of the recording so jobs split the same way.
+     */
+    std::size_t GetWorkerCount() const noexcept {
+        return m_isReplay ? m_replayWorkerCount : m_upWorkers.size();
+    }
+
+    /**
+     * @brief Number of submitted jobs that have not started yet.
+     */
+    std::int64_t GetPendingJobCount() const noexcept {
+        return m_pendingJobs.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Check if the calling thread is one of this job system's workers.
+     */
+    bool IsWorkerThread() const noexcept {
+        return detail::CurrentJobWorker().pOwner == this;
+    }
+
+    /**
+     * @brief Index of the calling worker, or GetWorkerCount() for non worker threads.
+     */
+    std::size_t GetCurrentWorkerIndex() const noexcept {
+        return IsWorkerThread() ? detail::CurrentJobWorker().index : GetWorkerCount();
+    }
+
+    /**
+     * @brief Start recording job submissions, starts, ends and waits. Clears the previous recording.
+     */
+    void StartRecording() {
+        for (auto&& e : m_upWorkers) {
+            std::lock_guard<std::mutex> lock(e->traceMutex);
+            e->traceEvents.clear();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_externalTraceMutex);
+            m_externalTraceEvents.clear();
+        }
+        // Keys of jobs submitted from outside of jobs count from the start of the recording, like in a replay
+        m_rootSubmitCount.store(0, std::memory_order_relaxed);
+        m_traceBegin = std::chrono::steady_clock::now();
+        m_isRecording.store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief Stop recording.
+     * @return Everything recorded since StartRecording.
+     */
+    JobTrace StopRecording() {
+        m_isRecording.store(false, std::memory_order_release);
+        std::vector<JobTraceEvent> events;
+        for (auto&& e : m_upWorkers) {
+            std::lock_guard<std::mutex> lock(e->traceMutex);
+            events.insert(events.end(), e->traceEvents.begin(), e->traceEvents.end());
+            e->traceEvents.clear();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_externalTraceMutex);
+            events.insert(events.end(), m_externalTraceEvents.begin(), m_externalTraceEvents.end());
+            m_externalTraceEvents.clear();
+        }
+        return JobTrace(GetWorkerCount(), std::move(events));
+    }
+
+    bool IsRecording() const noexcept {
+        return m_isRecording.load(std::memory_order_relaxed);
+    }
+
+    bool IsReplaying() const noexcept {
+        return m_isReplay;
+    }
+
+private:
+
+    struct alignas(thread_helper::CACHE_LINE_SIZE) Worker {
+        explicit Worker(std::uint32_t seed)
+            : rng(seed * 2654435761u + 1)
+        {}
+
+        ChaseLevDeque<detail::Job*> deque;
+        ScratchArena                scratch;
+        std::thread                 thread;
+        std::uint32_t               rng;
+        std::mutex                  traceMutex;
+        std::vector<JobTraceEvent>  traceEvents;
+    };
+
+    struct ReplayEntry {
+        std::uint64_t rank     = 0;
+        std::uint64_t sequence = 0;
+        detail::Job*  pJob     = nullptr;
+
+        bool operator<(const ReplayEntry& other) const noexcept {
+            // Reversed for the max heap of std::push_heap, the lowest rank comes first
+            return rank != other.rank ? rank > other.rank : sequence > other.sequence;
+        }
+    };
+
+    static constexpr std::size_t INJECTION_BATCH_SIZE = 32;
+    static constexpr int         SPIN_COUNT           = 64;
+
+    void Push(detail::Job* job) {
+        if (m_isReplay || m_isRecording.load(std::memory_order_relaxed)) {
+            AssignTraceKey(job);
+        }
+        if (m_isReplay) {
+            m_pendingJobs.fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(m_injectionMutex);
+            const auto iter = m_replayRanks.find(job->traceKey);
+            m_replayJobs.push_back({ iter != m_replayRanks.end() ? iter->second : m_replayRanks.size(), m_replaySequence++, job });
+            std::push_heap(m_replayJobs.begin(), m_replayJobs.end());
+            return;
+        }
+
+        m_pendingJobs.fetch_add(1, std::memory_order_seq_cst);
+        if (IsWorkerThread()) {
+            m_upWorkers[detail::CurrentJobWorker().index]->deque.Push(job);
+        }
+        else {
+            std::lock_guard<std::mutex> lock(m_injectionMutex);
+            m_injectionJobs.push_back(job);
+            m_injectionCount.fetch_add(1, std::memory_order_release);
+        }
+        if (m_sleepingWorkers.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_sleepCv.notify_one();
+        }
+    }
+
+    detail::Job* FindJob() {
+        if (m_isReplay) {
+            return PopReplay();
+        }
+
+        detail::Job* job = nullptr;
+        const bool is_worker = IsWorkerThread();
+        const std::size_t self = is_worker ? detail::CurrentJobWorker().index : m_upWorkers.size();
+
+        if (is_worker && m_upWorkers[self]->deque.Pop(&job)) {
+            return job;
+        }
+        if (job = PopInjection(is_worker ? m_upWorkers[self].get() : nullptr); job) {
+            return job;
+        }
+        if (!m_upWorkers.empty()) {
+            std::uint32_t seed = is_worker ? NextRandom(&m_upWorkers[self]->rng) : static_cast<std::uint32_t>(self);
+            for (std::size_t i = 0; i < m_upWorkers.size(); ++i) {
+                const std::size_t victim = (seed + i) % m_upWorkers.size();
+                if (victim == self) continue;
+                if (m_upWorkers[victim]->deque.Steal(&job)) {
+                    return job;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    detail::Job* PopInjection(Worker* worker) {
+        // Avoids the lock on the hot path when nothing was submitted from outside
+        if (m_injectionCount.load(std::memory_order_acquire) == 0) return nullptr;
+        std::lock_guard<std::mutex> lock(m_injectionMutex);
+        if (m_injectionJobs.empty()) return nullptr;
+        detail::Job* job = m_injectionJobs.front();
+        m_injectionJobs.pop_front();
+        if (worker) {
+            // Move a batch into the worker's deque so other workers can steal it without the lock
+            for (std::size_t i = 1; i < INJECTION_BATCH_SIZE && !m_injectionJobs.empty(); ++i) {
+                worker->deque.Push(m_injectionJobs.front());
+                m_injectionJobs.pop_front();
+            }
+        }
+        m_injectionCount.store(m_injectionJobs.size(), std::memory_order_release);
+        return job;
+    }
+
+    void Execute(detail::Job* job) {
+        m_pendingJobs.fetch_sub(1, std::memory_order_relaxed);
+
+        // Jobs run nested inside Wait, so the trace context is saved rather than cleared
+        const bool is_traced = m_isReplay || m_isRecording.load(std::memory_order_relaxed);
+        const std::uint64_t trace_key = job->traceKey;
+        detail::JobTraceContext trace_context;
+        if (is_traced) {
+            trace_context = std::exchange(detail::CurrentJobTrace(), { trace_key, 0 });
+            RecordEvent(JobTraceEvent::Type::BEGIN, trace_key, 0);
+        }
+        {
+            // Scratch memory of a job is freed when it ends. A scope rather than Reset, jobs run nested inside Wait
+            ScratchScope scratch;
+            try {
+                job->func();
+            }
+            catch (const std::exception& e) {
+                assert::ShowError(ASSERT_FILE_LINE, "Job threw an exception: " + std::string(e.what()));
+                job->spCounter->Fail(std::current_exception());
+            }
+            catch (...) {
+                assert::ShowError(ASSERT_FILE_LINE, "Job threw an exception");
+                job->spCounter->Fail(std::current_exception());
+            }
+        }
+        if (is_traced) {
+            RecordEvent(JobTraceEvent::Type::END, trace_key, 0);
+            detail::CurrentJobTrace() = trace_context;
+        }
+        // Keep the counter alive on our side, a prepared job may be destroyed as soon as the waiter wakes up
+        std::shared_ptr<detail::JobCounter> counter;
+        if (job->isPreallocated) {
+            counter = job->spCounter;
+        }
+        else {
+            counter = std::move(job->spCounter);
+            delete job;
+        }
+        counter->Done();
+    }
+
+    void WorkerMain(std::size_t index, thread_helper::ThreadOptions options) {
+        thread_helper::ApplyCurrentThreadOptions(options);
+        detail::CurrentJobWorker() = { this, index };
+        ScratchArena::SetCurrent(&m_upWorkers[index]->scratch);
+
+        while (!m_isStop.load(std::memory_order_acquire)) {
+            if (RunPendingJob()) continue;
+
+            bool has_work = false;
+            for (int i = 0; i < SPIN_COUNT; ++i) {
+                if (m_pendingJobs.load(std::memory_order_relaxed) > 0) {
+                    has_work = true;
+                    break;
+                }
+                thread_helper::CpuRelax();
+            }
+            if (has_work) continue;
+
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+            m_sleepCv.wait(lock, [this] {
+                return m_isStop.load(std::memory_order_acquire) || m_pendingJobs.load(std::memory_order_seq_cst) > 0;
+            });
+            m_sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        ScratchArena::SetCurrent(nullptr);
+        detail::CurrentJobWorker() = {};
+    }
+
+    /**
+     * @brief Key of a job from the job that submits it and how many it submitted before.
+     */
+    void AssignTraceKey(detail::Job* job) {
+        auto& context = detail::CurrentJobTrace();
+        std::uint64_t ordinal = 0;
+        if (context.jobKey) {
+            ordinal = context.childCount++;
+        }
+        else {
+            ordinal = m_rootSubmitCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        // splitmix64 finalizer over both values
+        std::uint64_t key = context.jobKey * 0x9E3779B97F4A7C15ull + ordinal + 1;
+        key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ull;
+        key = (key ^ (key >> 27)) * 0x94D049BB133111EBull;
+        key ^= key >> 31;
+        job->traceKey = key ? key : 1;
+        RecordEvent(JobTraceEvent::Type::SUBMIT, job->traceKey, context.jobKey);
+    }
+
+    void RecordEvent(JobTraceEvent::Type type, std::uint64_t job, std::uint64_t related) {
+        if (!m_isRecording.load(std::memory_order_acquire)) return;
+        JobTraceEvent event;
+        event.timeNS  = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_traceBegin).count();
+        event.job     = job;
+        event.related = related;
+        event.thread  = static_cast<std::uint32_t>(GetCurrentWorkerIndex());
+        event.type    = type;
+        if (IsWorkerThread()) {
+            auto& worker = *m_upWorkers[detail::CurrentJobWorker().index];
+            std::lock_guard<std::mutex> lock(worker.traceMutex);
+            worker.traceEvents.push_back(event);
+        }
+        else {
+            std::lock_guard<std::mutex> lock(m_externalTraceMutex);
+            m_externalTraceEvents.push_back(event);
+        }
+    }
+
+    detail::Job* PopReplay() {
+        std::lock_guard<std::mutex> lock(m_injectionMutex);
+        if (m_replayJobs.empty()) return nullptr;
+        std::pop_heap(m_replayJobs.begin(), m_replayJobs.end());
+        detail::Job* job = m_replayJobs.back().pJob;
+        m_replayJobs.pop_back();
+        return job;
+    }
+
+    static std::uint32_t NextRandom(std::uint32_t* state) noexcept {
+        // xorshift32
+        std::uint32_t x = *state;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        return *state = x;
+    }
+
+    void Release() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_isStop.store(true, std::memory_order_release);
+            m_sleepCv.notify_all();
+        }
+        for (auto&& e : m_upWorkers) {
+            if (e->thread.joinable()) {
+                e->thread.join();
+            }
+        }
+        // Finish whatever is left so no handle is waited on forever
+        detail::Job* job = nullptr;
+        for (auto&& e : m_upWorkers) {
+            while (e->deque.Steal(&job)) {
+                Execute(job);
+            }
+        }
+        while ((job = PopInjection(nullptr))) {
+            Execute(job);
+        }
+        while ((job = PopReplay())) {
+            Execute(job);
+        }
+        m_upWorkers.clear();
+    }
+
+    std::vector<std::unique_ptr<Worker>> m_upWorkers;
+
+    std::mutex                           m_injectionMutex;
+    std::deque<detail::Job*>             m_injectionJobs;
+    std::atomic<std::size_t>             m_injectionCount = 0;
+
+    std::atomic<bool>                    m_isStop;
+    alignas(thread_helper::CACHE_LINE_SIZE) std::atomic<std::int64_t> m_pendingJobs;
+    alignas(thread_helper::CACHE_LINE_SIZE) std::atomic<std::int32_t> m_sleepingWorkers;
+    std::mutex                           m_sleepMutex;
+    std::condition_variable              m_sleepCv;
+
+    std::atomic<bool>                    m_isRecording      = false;
+    std::atomic<std::uint64_t>           m_rootSubmitCount  = 0;
+    std::chrono::steady_clock::time_point m_traceBegin;
+    std::mutex                           m_externalTraceMutex;
+    std::vector<JobTraceEvent>           m_externalTraceEvents;
+
+    bool                                              m_isReplay          = false;
+    std::size_t                                       m_replayWorkerCount = 0;
+    std::unordered_map<std::uint64_t, std::uint64_t> m_replayRanks;
+    std::vector<ReplayEntry>                          m_replayJobs;
+    std::uint64_t                                     m_replaySequence    = 0;
+
+};
+
+inline void JobHandle::Wait() const {
+    if (m_pOwner) {
+        m_pOwner->Wait(*this);
+    }
+}
+
+#endif
@@ -0,0 +1,216 @@
+﻿/**
+ * @file JobTrace.h
+ * @author shirokuma1101
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023 shirokuma1101. All rights reserved.
+ * @license MIT License (see LICENSE.txt file)
+ */
+
+#pragma once
+
+#ifndef GAME_LIBRARIES_THREAD_JOBSYSTEM_JOBTRACE_H_
+#define GAME_LIBRARIES_THREAD_JOBSYSTEM_JOBTRACE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief One record of a JobTrace. Kept trivially copyable, traces are saved as raw arrays of it.
+ */
+struct JobTraceEvent {
+    enum class Type : std::uint8_t {
+        SUBMIT,     // job was submitted, related is the key of the job that submitted it (0 outside of jobs)
+        BEGIN,      // job started
+        END,        // job finished
+        WAIT_BEGIN, // thread started waiting on a group, related identifies the group
+        WAIT_END,   // wait returned
+    };
+
+    std::int64_t  timeNS  = 0; // Since the start of the recording
+    std::uint64_t job     = 0; // Key of the job, stable between runs that submit the same jobs
+    std::uint64_t related = 0;
+    std::uint32_t thread  = 0; // Worker index, the worker count for threads that are not workers
+    Type          type    = Type::SUBMIT;
+};
+
+/**
+ * @class JobTrace
+ * @brief Recording of a JobSystem: when each job was submitted, started and finished, on which worker and by whom.
+ * @details Saved in a compact binary form and converted offline to Chrome trace / Perfetto JSON, where spawn edges are
+ *          drawn as flow arrows. It can also be fed back to a JobSystem to replay the recorded order on one thread.
+ */
+class JobTrace
+{
+public:
+
+    JobTrace() noexcept = default;
+    JobTrace(std::size_t worker_count, std::vector<JobTraceEvent> events)
+        : m_workerCount(worker_count)
+        , m_events(std::move(events))
+    {
+        std::stable_sort(m_events.begin(), m_events.end(), [](const JobTraceEvent& lhs, const JobTraceEvent& rhs) {
+            return lhs.timeNS < rhs.timeNS;
+        });
+    }
+
+    std::size_t GetWorkerCount() const noexcept {
+        return m_workerCount;
+    }
+
+    const std::vector<JobTraceEvent>& GetEvents() const noexcept {
+        return m_events;
+    }
+
+    /**
+     * @brief Keys of the recorded jobs in the order they started.
+     */
+    std::vector<std::uint64_t> GetExecutionOrder() const {
+        std::vector<std::uint64_t> order;
+        for (const auto& e : m_events) {
+            if (e.type == JobTraceEvent::Type::BEGIN) {
+                order.push_back(e.job);
+            }
+        }
+        return order;
+    }
+
+    /**
+     * @brief Save in the binary trace format.
+     * @return false if the file could not be written.
+     */
+    bool Save(const std::string& path) const {
+        std::ofstream ofs(path, std::ios::binary);
+        if (!ofs) return false;
+        Header header;
+        header.workerCount = static_cast<std::uint32_t>(m_workerCount);
+        header.eventCount  = m_events.size();
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        ofs.write(reinterpret_cast<const char*>(m_events.data()), static_cast<std::streamsize>(m_events.size() * sizeof(JobTraceEvent)));
+        return static_cast<bool>(ofs);
+    }
+
+    /**
+     * @brief Load a file written by Save.
+     * @return false if the file is missing or not a trace of this version.
+     */
+    bool Load(const std::string& path) {
+        std::ifstream ifs(path, std::ios::binary);
+        if (!ifs) return false;
+        Header header;
+        if (!ifs.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+        if (std::memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0 || header.version != VERSION) return false;
+        std::vector<JobTraceEvent> events(static_cast<std::size_t>(header.eventCount));
+        if (!ifs.read(reinterpret_cast<char*>(events.data()), static_cast<std::streamsize>(events.size() * sizeof(JobTraceEvent)))) return false;
+        m_workerCount = header.workerCount;
+        m_events      = std::move(events);
+        return true;
+    }
+
+    /**
+     * @brief Write the trace as Chrome trace event JSON (chrome://tracing, ui.perfetto.dev).
+     * @details Jobs and waits become slices on the thread that ran them, a spawn becomes a flow arrow from the
+     *          submitting slice to the start of the job.
+     */
+    void WriteChromeTrace(std::ostream& os) const {
+        const auto us = [](std::int64_t ns) {
+            return std::to_string(ns / 1000) + "." + std::to_string(1000 + ns % 1000).substr(1);
+        };
+        const auto key = [](std::uint64_t value) {
+            static constexpr char DIGITS[] = "0123456789abcdef";
+            std::string str(16, '0');
+            for (int i = 15; i >= 0; --i, value >>= 4) {
+                str[static_cast<std::size_t>(i)] = DIGITS[value & 0xF];
+            }
+            return str;
+        };
+
+        os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        bool is_first = true;
+        const auto next = [&]() -> std::ostream& {
+            if (!is_first) os << ",\n";
+            is_first = false;
+            return os;
+        };
+
+        for (std::size_t i = 0; i <= m_workerCount; ++i) {
+            next() << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":0,\"tid\":" << i << ",\"args\":{\"name\":\""
+                   << (i < m_workerCount ? "Worker " + std::to_string(i) : std::string("External")) << "\"}}";
+        }
+
+        std::unordered_map<std::uint64_t, std::int64_t> open_jobs;
+        std::unordered_map<std::uint64_t, std::vector<std::int64_t>> open_waits;
+        for (const auto& e : m_events) {
+            switch (e.type) {
+            case JobTraceEvent::Type::SUBMIT:
+                if (e.related) {
+                    next() << "{\"ph\":\"s\",\"cat\":\"spawn\",\"name\":\"spawn\",\"pid\":0,\"tid\":" << e.thread
+                           << ",\"ts\":" << us(e.timeNS) << ",\"id\":\"0x" << key(e.job) << "\"}";
+                }
+                break;
+            case JobTraceEvent::Type::BEGIN:
+                open_jobs[e.job] = e.timeNS;
+                next() << "{\"ph\":\"f\",\"bp\":\"e\",\"cat\":\"spawn\",\"name\":\"spawn\",\"pid\":0,\"tid\":" << e.thread
+                       << ",\"ts\":" << us(e.timeNS) << ",\"id\":\"0x" << key(e.job) << "\"}";
+                break;
+            case JobTraceEvent::Type::END:
+                if (auto iter = open_jobs.find(e.job); iter != open_jobs.end()) {
+                    next() << "{\"ph\":\"X\",\"cat\":\"job\",\"name\":\"job " << key(e.job) << "\",\"pid\":0,\"tid\":" << e.thread
+                           << ",\"ts\":" << us(iter->second) << ",\"dur\":" << us(e.timeNS - iter->second) << "}";
+                    open_jobs.erase(iter);
+                }
+                break;
+            case JobTraceEvent::Type::WAIT_BEGIN:
+                open_waits[(static_cast<std::uint64_t>(e.thread) << 48) ^ e.related].push_back(e.timeNS);
+                break;
+            case JobTraceEvent::Type::WAIT_END:
+                if (auto iter = open_waits.find((static_cast<std::uint64_t>(e.thread) << 48) ^ e.related); iter != open_waits.end() && !iter->second.empty()) {
+                    const auto begin = iter->second.back();
+                    iter->second.pop_back();
+                    next() << "{\"ph\":\"X\",\"cat\":\"wait\",\"name\":\"wait\",\"pid\":0,\"tid\":" << e.thread
+                           << ",\"ts\":" << us(begin) << ",\"dur\":" << us(e.timeNS - begin) << "}";
+                }
+                break;
+            }
+        }
+        os << "\n]}\n";
+    }
+
+    /**
+     * @brief Write the Chrome trace JSON to a file.
+     * @return false if the file could not be written.
+     */
+    bool ExportChromeTrace(const std::string& path) const {
+        std::ofstream ofs(path);
+        if (!ofs) return false;
+        WriteChromeTrace(ofs);
+        return static_cast<bool>(ofs);
+    }
+
+private:
+
+    static constexpr char          MAGIC[4] = { 'J', 'T', 'R', 'C' };
+    static constexpr std::uint32_t VERSION  = 1;
+
+    struct Header {
+        char          magic[4]    = { MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3] };
+        std::uint32_t version     = VERSION;
+        std::uint32_t workerCount = 0;
+        std::uint32_t reserved    = 0;
+        std::uint64_t eventCount  = 0;
+    };
+
+    std::size_t                m_workerCount = 0;
+    std::vector<JobTraceEvent> m_events;
+
+};
+
+#endif
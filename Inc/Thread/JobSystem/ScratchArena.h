@@ -0,0 +1,211 @@
+﻿/**
+ * @file ScratchArena.h
+ * @author shirokuma1101
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023 shirokuma1101. All rights reserved.
+ * @license MIT License (see LICENSE.txt file)
+ */
+
+#pragma once
+
+#ifndef GAME_LIBRARIES_THREAD_JOBSYSTEM_SCRATCHARENA_H_
+#define GAME_LIBRARIES_THREAD_JOBSYSTEM_SCRATCHARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+/**
+ * @class ScratchArena
+ * @brief Bump pointer allocator for temporary data owned by a single thread.
+ * @details Deallocation is a no-op, memory is given back by rewinding to a marker (ScratchScope does it automatically)
+ *          or by Reset. Blocks are kept after a rewind, so a warmed up arena does not touch the heap at all.
+ *          Every JobSystem worker owns one and rewinds it after each job, other threads get a thread local one that
+ *          should be Reset at frame boundaries.
+ */
+class ScratchArena : public std::pmr::memory_resource
+{
+public:
+
+    /**
+     * @brief Position in the arena to rewind to.
+     */
+    struct Marker {
+        std::size_t block  = 0;
+        std::size_t offset = 0;
+    };
+
+    static constexpr std::size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+
+    explicit ScratchArena(std::size_t block_size = DEFAULT_BLOCK_SIZE)
+        : m_blockSize(block_size)
+    {}
+    virtual ~ScratchArena() noexcept override = default;
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    /**
+     * @brief Arena of the calling thread. The worker's own arena on JobSystem workers.
+     */
+    static ScratchArena& GetCurrent() {
+        if (ScratchArena* arena = CurrentOverride()) {
+            return *arena;
+        }
+        static thread_local ScratchArena thread_arena;
+        return thread_arena;
+    }
+
+    /**
+     * @brief Make GetCurrent return the given arena on the calling thread. nullptr restores the thread local one.
+     */
+    static void SetCurrent(ScratchArena* arena) noexcept {
+        CurrentOverride() = arena;
+    }
+
+    Marker GetMarker() const noexcept {
+        return { m_blockIndex, m_offset };
+    }
+
+    /**
+     * @brief Free everything allocated after the marker was taken.
+     */
+    void Rewind(const Marker& marker) noexcept {
+        m_blockIndex = marker.block;
+        m_offset     = marker.offset;
+    }
+
+    /**
+     * @brief Free everything. Blocks are kept for reuse.
+     */
+    void Reset() noexcept {
+        Rewind({});
+    }
+
+    /**
+     * @brief Bytes currently handed out, including alignment padding.
+     */
+    std::size_t GetUsedBytes() const noexcept {
+        std::size_t used = m_offset;
+        for (std::size_t i = 0; i < m_blockIndex && i < m_blocks.size(); ++i) {
+            used += m_blocks[i].size;
+        }
+        return used;
+    }
+
+    /**
+     * @brief Bytes reserved from the heap.
+     */
+    std::size_t GetCapacity() const noexcept {
+        std::size_t capacity = 0;
+        for (const auto& e : m_blocks) {
+            capacity += e.size;
+        }
+        return capacity;
+    }
+
+protected:
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        while (true) {
+            if (m_blockIndex < m_blocks.size()) {
+                auto& block = m_blocks[m_blockIndex];
+                const auto base    = reinterpret_cast<std::uintptr_t>(block.upData.get());
+                const auto aligned = (base + m_offset + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+                const std::size_t end = static_cast<std::size_t>(aligned - base) + bytes;
+                if (end <= block.size) {
+                    m_offset = end;
+                    return reinterpret_cast<void*>(aligned);
+                }
+                // Does not fit, the rest of this block is wasted until the next rewind
+                if (m_blockIndex + 1 < m_blocks.size() && m_blocks[m_blockIndex + 1].size >= bytes + alignment) {
+                    ++m_blockIndex;
+                    m_offset = 0;
+                    continue;
+                }
+            }
+            // Insert a block large enough after the current one, later blocks stay for reuse
+            const std::size_t size = bytes + alignment > m_blockSize ? bytes + alignment : m_blockSize;
+            const std::size_t index = m_blocks.empty() ? 0 : m_blockIndex + 1;
+            m_blocks.insert(m_blocks.begin() + static_cast<std::ptrdiff_t>(index), Block{ std::make_unique<std::byte[]>(size), size });
+            m_blockIndex = index;
+            m_offset     = 0;
+        }
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+
+    struct Block {
+        std::unique_ptr<std::byte[]> upData;
+        std::size_t                  size = 0;
+    };
+
+    static ScratchArena*& CurrentOverride() noexcept {
+        static thread_local ScratchArena* arena = nullptr;
+        return arena;
+    }
+
+    std::size_t        m_blockSize  = DEFAULT_BLOCK_SIZE;
+    std::vector<Block> m_blocks;
+    std::size_t        m_blockIndex = 0;
+    std::size_t        m_offset     = 0;
+
+};
+
+/**
+ * @class ScratchScope
+ * @brief Rewinds a scratch arena to where it was when the scope was entered.
+ * @details Containers built on GetResource() must not outlive the scope.
+ * @code
+ * ScratchScope scratch;
+ * std::pmr::vector<collision::Result> results(scratch.GetResource());
+ * @endcode
+ */
+class ScratchScope
+{
+public:
+
+    template<class T>
+    using Allocator = std::pmr::polymorphic_allocator<T>;
+
+    ScratchScope()
+        : ScratchScope(ScratchArena::GetCurrent())
+    {}
+    explicit ScratchScope(ScratchArena& arena) noexcept
+        : m_arena(arena)
+        , m_marker(arena.GetMarker())
+    {}
+    ~ScratchScope() noexcept {
+        m_arena.Rewind(m_marker);
+    }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+    std::pmr::memory_resource* GetResource() noexcept {
+        return &m_arena;
+    }
+
+    template<class T>
+    Allocator<T> GetAllocator() noexcept {
+        return Allocator<T>(&m_arena);
+    }
+
+private:
+
+    ScratchArena&              m_arena;
+    const ScratchArena::Marker m_marker;
+
+};
+
+#endif
@@ -0,0 +1,245 @@
+﻿/**
+ * @file Parallel.h
+ * @author shirokuma1101
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023 shirokuma1101. All rights reserved.
+ * @license MIT License (see LICENSE.txt file)
+ */
+
+#pragma once
+
+#ifndef GAME_LIBRARIES_THREAD_PARALLEL_PARALLEL_H_
+#define GAME_LIBRARIES_THREAD_PARALLEL_PARALLEL_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#include "Thread/JobSystem/JobSystem.h"
+
+/**
+ * @namespace parallel
+ * @brief Parallel algorithms over random access ranges, running on a JobSystem.
+ * @details Ranges are split in halves aligned to the grain size. A job only splits while the job system has fewer
+ *          pending jobs than workers, otherwise it keeps processing grain sized chunks itself, so the number of jobs
+ *          adapts to how busy the pool is. Inputs below the serial threshold run on the calling thread without
+ *          touching the job system.
+ */
+namespace parallel {
+
+    /**
+     * @brief Options shared by the parallel algorithms.
+     */
+    struct Options {
+        JobSystem*  pJobSystem      = nullptr; // nullptr uses JobSystem::GetDefault()
+        std::size_t grainSize       = 0;       // 0 picks one from the input size and worker count
+        std::size_t serialThreshold = 0;       // 0 uses the default of each algorithm
+    };
+
+    /**
+     * @brief Default serial thresholds. Below these the overhead of scheduling is larger than the gain.
+     */
+    constexpr std::size_t FOR_SERIAL_THRESHOLD       = 4096;
+    constexpr std::size_t REDUCE_SERIAL_THRESHOLD    = 8192;
+    constexpr std::size_t TRANSFORM_SERIAL_THRESHOLD = 4096;
+    constexpr std::size_t SORT_SERIAL_THRESHOLD      = 16384;
+
+    namespace detail {
+
+        inline JobSystem& GetJobSystem(const Options& options) {
+            return options.pJobSystem ? *options.pJobSystem : JobSystem::GetDefault();
+        }
+
+        inline bool IsSerial(std::size_t count, const Options& options, std::size_t default_threshold) {
+            return count < (options.serialThreshold ? options.serialThreshold : default_threshold);
+        }
+
+        inline std::size_t GetGrainSize(std::size_t count, const Options& options, JobSystem& job_system) {
+            if (options.grainSize) return options.grainSize;
+            // Around eight chunks per thread leaves room for stealing to even out imbalance
+            const std::size_t grain = count / ((job_system.GetWorkerCount() + 1) * 8);
+            return grain ? grain : 1;
+        }
+
+        /**
+         * @brief Process [begin, end) with leaf(begin, end) calls whose bounds are multiples of grain.
+         */
+        template<class Leaf>
+        void Split(JobSystem& job_system, const JobHandle& group, std::size_t begin, std::size_t end, std::size_t grain, const Leaf& leaf) {
+            while (end - begin > grain) {
+                if (job_system.GetPendingJobCount() < static_cast<std::int64_t>(job_system.GetWorkerCount())) {
+                    const std::size_t half = (end - begin) / 2;
+                    const std::size_t mid  = begin + ((half + grain - 1) / grain) * grain;
+                    job_system.Submit(group, [&job_system, &group, mid, end, grain, &leaf] {
+                        Split(job_system, group, mid, end, grain, leaf);
+                    });
+                    end = mid;
+                }
+                else {
+                    leaf(begin, begin + grain);
+                    begin += grain;
+                }
+            }
+            if (begin < end) {
+                leaf(begin, end);
+            }
+        }
+
+        /**
+         * @brief Process [0, count) on the calling thread and the job system and wait for the whole range.
+         * @details The jobs refer to the group and the leaf on this stack, so they are waited for even if the leaf
+         *          throws on the calling thread. The exception then reaches the caller.
+         */
+        template<class Leaf>
+        void Run(JobSystem& job_system, std::size_t count, std::size_t grain, const Leaf& leaf) {
+            struct WaitGuard {
+                const JobHandle& group;
+                ~WaitGuard() {
+                    group.Wait();
+                }
+            };
+            const auto group = job_system.CreateGroup();
+            WaitGuard guard{ group };
+            Split(job_system, group, 0, count, grain, leaf);
+        }
+
+    }
+
+    /**
+     * @brief Call func(i) for every i in [begin, end).
+     * @param begin First index.
+     * @param end One past the last index.
+     * @param func Callable taking an index. Calls may run concurrently.
+     * @param options Options.
+     */
+    template<class Index, class Func>
+    inline void ParallelFor(Index begin, Index end, Func&& func, const Options& options = {}) {
+        if (end <= begin) return;
+        const auto count = static_cast<std::size_t>(end - begin);
+        if (detail::IsSerial(count, options, FOR_SERIAL_THRESHOLD)) {
+            for (Index i = begin; i < end; ++i) {
+                func(i);
+            }
+            return;
+        }
+
+        auto& job_system = detail::GetJobSystem(options);
+        detail::Run(job_system, count, detail::GetGrainSize(count, options, job_system), [&](std::size_t b, std::size_t e) {
+            for (std::size_t i = b; i < e; ++i) {
+                func(static_cast<Index>(begin + static_cast<Index>(i)));
+            }
+        });
+    }
+
+    /**
+     * @brief Reduce a range with an associative operation. The order of operands is kept, so op need not be commutative.
+     * @param first Begin of the range.
+     * @param last End of the range.
+     * @param init Initial value, combined once as the leftmost operand.
+     * @param op Associative binary operation.
+     * @param options Options.
+     * @return The reduced value.
+     */
+    template<class RandomIt, class T, class BinaryOp = std::plus<>>
+    inline T ParallelReduce(RandomIt first, RandomIt last, T init, BinaryOp op = {}, const Options& options = {}) {
+        if (last <= first) return init;
+        const auto count = static_cast<std::size_t>(last - first);
+        if (detail::IsSerial(count, options, REDUCE_SERIAL_THRESHOLD)) {
+            for (; first != last; ++first) {
+                init = op(std::move(init), *first);
+            }
+            return init;
+        }
+
+        auto& job_system = detail::GetJobSystem(options);
+        const std::size_t grain = detail::GetGrainSize(count, options, job_system);
+        // Every leaf covers exactly one grain aligned chunk, so its partial result has a fixed slot
+        std::vector<T> partials((count + grain - 1) / grain, init);
+        detail::Run(job_system, count, grain, [&](std::size_t b, std::size_t e) {
+            T acc = first[b];
+            for (std::size_t i = b + 1; i < e; ++i) {
+                acc = op(std::move(acc), first[i]);
+            }
+            partials[b / grain] = std::move(acc);
+        });
+
+        for (auto&& e : partials) {
+            init = op(std::move(init), std::move(e));
+        }
+        return init;
+    }
+
+    /**
+     * @brief Write op(*it) for every element of [first, last) to d_first.
+     * @param first Begin of the input range.
+     * @param last End of the input range.
+     * @param d_first Begin of the output range. Must be random access and as large as the input.
+     * @param op Unary operation.
+     * @param options Options.
+     * @return Iterator one past the last written element.
+     */
+    template<class RandomIt, class OutRandomIt, class UnaryOp>
+    inline OutRandomIt ParallelTransform(RandomIt first, RandomIt last, OutRandomIt d_first, UnaryOp op, const Options& options = {}) {
+        if (last <= first) return d_first;
+        const auto count = static_cast<std::size_t>(last - first);
+        if (detail::IsSerial(count, options, TRANSFORM_SERIAL_THRESHOLD)) {
+            return std::transform(first, last, d_first, op);
+        }
+
+        auto& job_system = detail::GetJobSystem(options);
+        detail::Run(job_system, count, detail::GetGrainSize(count, options, job_system), [&](std::size_t b, std::size_t e) {
+            std::transform(first + b, first + e, d_first + b, op);
+        });
+        return d_first + count;
+    }
+
+    /**
+     * @brief Sort a range. Chunks are sorted in parallel, then merged pairwise in parallel rounds. Not stable.
+     * @param first Begin of the range.
+     * @param last End of the range.
+     * @param comp Comparison.
+     * @param options Options. grainSize is the minimum chunk size.
+     */
+    template<class RandomIt, class Compare = std::less<>>
+    inline void ParallelSort(RandomIt first, RandomIt last, Compare comp = {}, const Options& options = {}) {
+        if (last <= first) return;
+        const auto count = static_cast<std::size_t>(last - first);
+        if (detail::IsSerial(count, options, SORT_SERIAL_THRESHOLD)) {
+            std::sort(first, last, comp);
+            return;
+        }
+
+        auto& job_system = detail::GetJobSystem(options);
+        const std::size_t min_chunk = options.grainSize ? options.grainSize : 1024;
+        std::size_t chunk_count = 1;
+        while (chunk_count < (job_system.GetWorkerCount() + 1) * 2 && count / (chunk_count * 2) >= min_chunk) {
+            chunk_count *= 2;
+        }
+
+        std::vector<std::size_t> bounds(chunk_count + 1);
+        for (std::size_t i = 0; i <= chunk_count; ++i) {
+            bounds[i] = count * i / chunk_count;
+        }
+
+        Options chunk_options = options;
+        chunk_options.grainSize       = 1;
+        chunk_options.serialThreshold = 1;
+        ParallelFor(std::size_t(0), chunk_count, [&](std::size_t i) {
+            std::sort(first + bounds[i], first + bounds[i + 1], comp);
+        }, chunk_options);
+
+        for (std::size_t width = 1; width < chunk_count; width *= 2) {
+            ParallelFor(std::size_t(0), chunk_count / (width * 2), [&](std::size_t pair) {
+                const std::size_t left = pair * width * 2;
+                std::inplace_merge(first + bounds[left], first + bounds[left + width], first + bounds[left + width * 2], comp);
+            }, chunk_options);
+        }
+    }
+
+}
+
+#endif
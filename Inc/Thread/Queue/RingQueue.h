@@ -0,0 +1,312 @@
+﻿/**
+ * @file RingQueue.h
+ * @author shirokuma1101
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023 shirokuma1101. All rights reserved.
+ * @license MIT License (see LICENSE.txt file)
+ */
+
+#pragma once
+
+#ifndef GAME_LIBRARIES_THREAD_QUEUE_RINGQUEUE_H_
+#define GAME_LIBRARIES_THREAD_QUEUE_RINGQUEUE_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "Thread/ThreadHelper/ThreadHelper.h"
+
+/**
+ * @class SpscRingQueue
+ * @brief Bounded lock-free queue for one producer thread and one consumer thread.
+ * @details Storage is inline, nothing is allocated after construction. Each side keeps a cached copy of the other
+ *          side's index and only reloads it when the queue looks full (or empty), so the shared cache lines are
+ *          touched once per batch rather than once per element.
+ * @tparam T Element type. Must be default constructible and move assignable.
+ * @tparam Capacity Number of slots. Must be a power of two.
+ */
+template<class T, std::size_t Capacity>
+class SpscRingQueue
+{
+public:
+
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_default_constructible_v<T> && std::is_move_assignable_v<T>, "T must be default constructible and move assignable");
+
+    SpscRingQueue() noexcept = default;
+
+    SpscRingQueue(const SpscRingQueue&) = delete;
+    SpscRingQueue& operator=(const SpscRingQueue&) = delete;
+
+    /**
+     * @brief Push an element. Producer thread only.
+     * @return false if the queue is full.
+     */
+    template<class U>
+    bool TryPush(U&& value) {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == Capacity) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == Capacity) return false;
+        }
+        m_buffer[tail & MASK] = std::forward<U>(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Push up to count elements. Producer thread only.
+     * @return Number of elements pushed.
+     */
+    std::size_t TryPushBatch(const T* values, std::size_t count) {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (Capacity - (tail - m_cachedHead) < count) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+        }
+        const std::size_t free_count = Capacity - (tail - m_cachedHead);
+        const std::size_t n = count < free_count ? count : free_count;
+        for (std::size_t i = 0; i < n; ++i) {
+            m_buffer[(tail + i) & MASK] = values[i];
+        }
+        m_tail.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief Pop an element. Consumer thread only.
+     * @return false if the queue is empty.
+     */
+    bool TryPop(T* value) {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) return false;
+        }
+        *value = std::move(m_buffer[head & MASK]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pop up to max_count elements. Consumer thread only.
+     * @return Number of elements popped.
+     */
+    std::size_t TryPopBatch(T* values, std::size_t max_count) {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (m_cachedTail - head < max_count) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+        }
+        const std::size_t available = m_cachedTail - head;
+        const std::size_t n = max_count < available ? max_count : available;
+        for (std::size_t i = 0; i < n; ++i) {
+            values[i] = std::move(m_buffer[(head + i) & MASK]);
+        }
+        m_head.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief Approximate number of elements.
+     */
+    std::size_t Size() const noexcept {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    bool IsEmpty() const noexcept {
+        return Size() == 0;
+    }
+
+    static constexpr std::size_t GetCapacity() noexcept {
+        return Capacity;
+    }
+
+private:
+
+    static constexpr std::size_t MASK = Capacity - 1;
+
+    // Consumer side
+    alignas(thread_helper::CACHE_LINE_SIZE) std::atomic<std::size_t> m_head       = 0;
+    std::size_t                                                      m_cachedTail = 0;
+    // Producer side
+    alignas(thread_helper::CACHE_LINE_SIZE) std::atomic<std::size_t> m_tail       = 0;
+    std::size_t                                                      m_cachedHead = 0;
+
+    alignas(thread_helper::CACHE_LINE_SIZE) std::array<T, Capacity> m_buffer;
+
+};
+
+/**
+ * @class MpmcRingQueue
+ * @brief Bounded lock-free queue for any number of producers and consumers (Vyukov's sequenced ring).
+ * @details Each cell carries a sequence number telling whether it is free or filled for the current lap, so producers
+ *          and consumers only contend on their own index. Batches claim a run of consecutive cells with one CAS.
+ * @tparam T Element type. Must be default constructible and move assignable.
+ * @tparam Capacity Number of slots. Must be a power of two.
+ */
+template<class T, std::size_t Capacity>
+class MpmcRingQueue
+{
+public:
+
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_default_constructible_v<T> && std::is_move_assignable_v<T>, "T must be default constructible and move assignable");
+
+    MpmcRingQueue() noexcept {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcRingQueue(const MpmcRingQueue&) = delete;
+    MpmcRingQueue& operator=(const MpmcRingQueue&) = delete;
+
+    /**
+     * @brief Push an element.
+     * @return false if the queue is full.
+     */
+    template<class U>
+    bool TryPush(U&& value) {
+        std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = m_cells[pos & MASK];
+            const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.data = std::forward<U>(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false;
+            }
+            else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Push up to count elements as one contiguous run.
+     * @return Number of elements pushed.
+     */
+    std::size_t TryPushBatch(const T* values, std::size_t count) {
+        std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            // Free cells for this lap can only be claimed through m_enqueuePos, so counting them before the CAS is safe
+            std::size_t n = 0;
+            while (n < count && n < Capacity &&
+                   m_cells[(pos + n) & MASK].sequence.load(std::memory_order_acquire) == pos + n) {
+                ++n;
+            }
+            if (n == 0) {
+                const std::size_t sequence = m_cells[pos & MASK].sequence.load(std::memory_order_acquire);
+                if (static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos) < 0) return 0;
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    Cell& cell = m_cells[(pos + i) & MASK];
+                    cell.data = values[i];
+                    cell.sequence.store(pos + i + 1, std::memory_order_release);
+                }
+                return n;
+            }
+        }
+    }
+
+    /**
+     * @brief Pop an element.
+     * @return false if the queue is empty.
+     */
+    bool TryPop(T* value) {
+        std::size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = m_cells[pos & MASK];
+            const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    *value = std::move(cell.data);
+                    cell.sequence.store(pos + Capacity, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false;
+            }
+            else {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Pop up to max_count elements as one contiguous run.
+     * @return Number of elements popped.
+     */
+    std::size_t TryPopBatch(T* values, std::size_t max_count) {
+        std::size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            std::size_t n = 0;
+            while (n < max_count && n < Capacity &&
+                   m_cells[(pos + n) & MASK].sequence.load(std::memory_order_acquire) == pos + n + 1) {
+                ++n;
+            }
+            if (n == 0) {
+                const std::size_t sequence = m_cells[pos & MASK].sequence.load(std::memory_order_acquire);
+                if (static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1) < 0) return 0;
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (m_dequeuePos.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    Cell& cell = m_cells[(pos + i) & MASK];
+                    values[i] = std::move(cell.data);
+                    cell.sequence.store(pos + i + Capacity, std::memory_order_release);
+                }
+                return n;
+            }
+        }
+    }
+
+    /**
+     * @brief Approximate number of elements.
+     */
+    std::size_t Size() const noexcept {
+        const std::size_t enqueue = m_enqueuePos.load(std::memory_order_acquire);
+        const std::size_t dequeue = m_dequeuePos.load(std::memory_order_acquire);
+        return enqueue > dequeue ? enqueue - dequeue : 0;
+    }
+
+    bool IsEmpty() const noexcept {
+        return Size() == 0;
+    }
+
+    static constexpr std::size_t GetCapacity() noexcept {
+        return Capacity;
+    }
+
+private:
+
+    static constexpr std::size_t MASK = Capacity - 1;
+
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T                        data;
+    };
+
+    alignas(thread_helper::CACHE_LINE_SIZE) std::atomic<std::size_t> m_enqueuePos = 0;
+    alignas(thread_helper::CACHE_LINE_SIZE) std::atomic<std::size_t> m_dequeuePos = 0;
+    alignas(thread_helper::CACHE_LINE_SIZE) std::array<Cell, Capacity> m_cells;
+
+};
+
+#endif
@@ -0,0 +1,160 @@
+﻿/**
+ * @file CompletionHandle.h
+ * @author shirokuma1101
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023 shirokuma1101. All rights reserved.
+ * @license MIT License (see LICENSE.txt file)
+ */
+
+#pragma once
+
+#ifndef GAME_LIBRARIES_THREAD_SIMPLETHREADMANAGER_COMPLETIONHANDLE_H_
+#define GAME_LIBRARIES_THREAD_SIMPLETHREADMANAGER_COMPLETIONHANDLE_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace detail {
+
+    struct CompletionState {
+        std::atomic<bool>       isReady         = false;
+        std::atomic<bool>       isStopRequested = false;
+        std::mutex              mutex;
+        std::condition_variable cv;
+    };
+
+}
+
+/**
+ * @class StopToken
+ * @brief Read side of a stop request. Long running work polls it and returns early.
+ * @details A default constructed token never requests a stop.
+ */
+class StopToken
+{
+public:
+
+    StopToken() noexcept = default;
+
+    bool IsStopRequested() const noexcept {
+        return m_spState && m_spState->isStopRequested.load(std::memory_order_acquire);
+    }
+
+private:
+
+    friend class CompletionHandle;
+    friend class CompletionSource;
+
+    explicit StopToken(std::shared_ptr<detail::CompletionState> state) noexcept
+        : m_spState(std::move(state))
+    {}
+
+    std::shared_ptr<detail::CompletionState> m_spState = nullptr;
+
+};
+
+/**
+ * @class CompletionHandle
+ * @brief Waitable result of asynchronous work. Waiting blocks on a condition variable and costs no CPU.
+ * @details A default constructed handle is invalid and always ready.
+ */
+class CompletionHandle
+{
+public:
+
+    CompletionHandle() noexcept = default;
+
+    bool IsValid() const noexcept {
+        return m_spState != nullptr;
+    }
+
+    bool IsReady() const noexcept {
+        return !m_spState || m_spState->isReady.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Block until the work has finished.
+     */
+    void Wait() const {
+        if (IsReady()) return;
+        std::unique_lock<std::mutex> lock(m_spState->mutex);
+        m_spState->cv.wait(lock, [this] { return IsReady(); });
+    }
+
+    /**
+     * @brief Block until the work has finished or the timeout expires.
+     * @param timeout Maximum time to wait.
+     * @return true if the work has finished.
+     */
+    template<class Rep, class Period>
+    bool WaitFor(const std::chrono::duration<Rep, Period>& timeout) const {
+        if (IsReady()) return true;
+        std::unique_lock<std::mutex> lock(m_spState->mutex);
+        return m_spState->cv.wait_for(lock, timeout, [this] { return IsReady(); });
+    }
+
+    /**
+     * @brief Ask the work to stop. It is up to the work to check its StopToken.
+     */
+    void RequestStop() const noexcept {
+        if (m_spState) {
+            m_spState->isStopRequested.store(true, std::memory_order_release);
+        }
+    }
+
+    StopToken GetStopToken() const noexcept {
+        return StopToken(m_spState);
+    }
+
+private:
+
+    friend class CompletionSource;
+
+    explicit CompletionHandle(std::shared_ptr<detail::CompletionState> state) noexcept
+        : m_spState(std::move(state))
+    {}
+
+    std::shared_ptr<detail::CompletionState> m_spState = nullptr;
+
+};
+
+/**
+ * @class CompletionSource
+ * @brief Write side of a CompletionHandle, owned by whoever runs the work.
+ */
+class CompletionSource
+{
+public:
+
+    CompletionSource()
+        : m_spState(std::make_shared<detail::CompletionState>())
+    {}
+
+    CompletionHandle GetHandle() const noexcept {
+        return CompletionHandle(m_spState);
+    }
+
+    StopToken GetStopToken() const noexcept {
+        return StopToken(m_spState);
+    }
+
+    void SetReady() const {
+        {
+            std::lock_guard<std::mutex> lock(m_spState->mutex);
+            m_spState->isReady.store(true, std::memory_order_release);
+        }
+        m_spState->cv.notify_all();
+    }
+
+private:
+
+    std::shared_ptr<detail::CompletionState> m_spState;
+
+};
+
+#endif
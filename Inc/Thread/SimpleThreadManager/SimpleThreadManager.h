@@ -13,59 +13,138 @@
 #ifndef GAME_LIBRARIES_THREAD_SIMPLETHREADMANAGER_SIMPLETHREADMANAGER_H_
 #define GAME_LIBRARIES_THREAD_SIMPLETHREADMANAGER_SIMPLETHREADMANAGER_H_
 
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <type_traits>
 #include <vector>
 
+#include "CompletionHandle.h"
 #include "SimpleUniqueThread.h"
+#include "Thread/JobSystem/JobSystem.h"
 
+/**
+ * @class SimpleThreadManager
+ * @brief Manages SimpleUniqueThread instances by ID.
+ * @details If a JobSystem is given, Create submits the work to it instead of spawning a new std::thread per call.
+ */
 class SimpleThreadManager {
 public:
 
-    using ID = std::thread::id;
+    using ID = std::uint64_t;
 
-    SimpleThreadManager() noexcept {
-        m_upThreads.clear();
+    SimpleThreadManager() noexcept
+        : m_pJobSystem(nullptr)
+    {
+        m_threads.clear();
+    }
+    explicit SimpleThreadManager(JobSystem* job_system) noexcept
+        : m_pJobSystem(job_system)
+    {
+        m_threads.clear();
     }
     virtual ~SimpleThreadManager() noexcept {
         Release();
     }
 
     template<class Func, class Inst, class... Args>
-    ID Create(Func func, Inst inst, Args... args) const {
-        auto thread = std::make_unique<SimpleUniqueThread>();
-        thread->Create(func, inst, args...);
-        return m_upThreads.emplace(thread->GetID(), std::move(thread)).first;
+    ID Create(Func func, Inst inst, Args... args) {
+        Entry entry;
+        if (m_pJobSystem) {
+            CompletionSource source;
+            entry.completion = source.GetHandle();
+            entry.job = m_pJobSystem->Submit([=] {
+                // Ready even if the function throws, the exception is kept by the job handle
+                struct ReadyGuard {
+                    const CompletionSource& source;
+                    ~ReadyGuard() {
+                        source.SetReady();
+                    }
+                } guard{ source };
+                if constexpr (std::is_invocable_v<Func, Inst, StopToken, Args...>) {
+                    (inst->*func)(source.GetStopToken(), args...);
+                }
+                else {
+                    (inst->*func)(args...);
+                }
+            });
+        }
+        else {
+            entry.upThread = std::make_unique<SimpleUniqueThread>();
+            entry.completion = entry.upThread->Create(func, inst, args...);
+        }
+        const ID id = ++m_lastID;
+        m_threads.emplace(id, std::move(entry));
+        return id;
     }
 
     bool IsEnd(ID id) const noexcept {
-        if (auto iter = m_upThreads.find(id); iter != m_upThreads.end()) {
-            return iter->second->IsEnd();
+        if (auto iter = m_threads.find(id); iter != m_threads.end()) {
+            return iter->second.completion.IsReady();
         }
         assert::ShowError(ASSERT_FILE_LINE, "thread is not exists");
         return false;
     }
 
+    /**
+     * @brief Get the completion handle of a thread or job to wait on or to cancel it.
+     */
+    CompletionHandle GetCompletion(ID id) const noexcept {
+        if (auto iter = m_threads.find(id); iter != m_threads.end()) {
+            return iter->second.completion;
+        }
+        assert::ShowError(ASSERT_FILE_LINE, "thread is not exists");
+        return CompletionHandle();
+    }
+
     void SyncEnd(ID* id, SimpleUniqueThread::SyncType sync_type = SimpleUniqueThread::SyncType::JOIN) {
-        if (auto iter = m_upThreads.find(*id); iter != m_upThreads.end()) {
-            iter->second->SyncEnd(sync_type);
-            m_upThreads.erase(*id);
+        if (auto iter = m_threads.find(*id); iter != m_threads.end()) {
+            if (iter->second.upThread) {
+                iter->second.upThread->SyncEnd(sync_type);
+            }
+            else if (sync_type == SimpleUniqueThread::SyncType::JOIN) {
+                iter->second.job.Wait();
+            }
+            else if (sync_type == SimpleUniqueThread::SyncType::TERMINATE) {
+                // Jobs can not be killed, they are asked to stop and forgotten like with DETACH
+                iter->second.completion.RequestStop();
+            }
+            m_threads.erase(iter);
             *id = ID();
             return;
         }
         assert::ShowError(ASSERT_FILE_LINE, "thread is not exists");
     }
 
+    JobSystem* GetJobSystem() const noexcept {
+        return m_pJobSystem;
+    }
+
 private:
 
+    struct Entry {
+        std::unique_ptr<SimpleUniqueThread> upThread = nullptr;
+        JobHandle                           job;
+        CompletionHandle                    completion;
+    };
+
     void Release() noexcept {
-        for (auto&& e : m_upThreads) {
-            e.second->SyncEnd();
+        // Threads stop in ~SimpleUniqueThread, jobs get the same treatment here
+        for (auto&& e : m_threads) {
+            if (!e.second.upThread) {
+                e.second.completion.RequestStop();
+                if (!e.second.completion.WaitFor(SimpleUniqueThread::DEFAULT_SHUTDOWN_TIMEOUT)) {
+                    assert::ShowWarning(ASSERT_FILE_LINE, "job did not stop in time, still waiting");
+                }
+                e.second.job.Wait();
+            }
         }
-        m_upThreads.clear();
+        m_threads.clear();
     }
 
-    std::map<ID, std::unique_ptr<SimpleUniqueThread>> m_upThreads;
+    JobSystem*          m_pJobSystem = nullptr;
+    ID                  m_lastID     = 0;
+    std::map<ID, Entry> m_threads;
 
 };
 
@@ -13,11 +13,23 @@
 #ifndef GAME_LIBRARIES_THREAD_SIMPLETHREADMANAGER_SIMPLEUNIQUETHREAD_H_
 #define GAME_LIBRARIES_THREAD_SIMPLETHREADMANAGER_SIMPLEUNIQUETHREAD_H_
 
+#include <chrono>
 #include <memory>
 #include <thread>
+#include <type_traits>
 
+#include "CompletionHandle.h"
+#include "Thread/ThreadHelper/ThreadHelper.h"
 #include "Utility/Assert.h"
 
+/**
+ * @class SimpleUniqueThread
+ * @brief Holds at most one thread running a member function.
+ * @details Create returns a CompletionHandle to wait on. If the member function takes a StopToken as its first
+ *          parameter, the token of that handle is passed so the work can be cancelled cooperatively.
+ *          A detached thread still calls into inst, the caller must keep it alive until the completion is ready.
+ *          The destructor never detaches, it asks the work to stop and waits for it.
+ */
 class SimpleUniqueThread
 {
 public:
@@ -25,19 +37,24 @@ public:
     enum class SyncType {
         JOIN,
         DETACH,
-        TERMINATE,
+        TERMINATE, // Request a stop and detach. The thread is never killed.
     };
 
+    /**
+     * @brief How long the destructor waits for a stop request to be honoured before warning that the work is stuck.
+     */
+    static constexpr std::chrono::milliseconds DEFAULT_SHUTDOWN_TIMEOUT = std::chrono::milliseconds(5000);
+
     SimpleUniqueThread() noexcept
-        : m_isEnd(true)
-        , m_upThread(nullptr)
+        : m_upThread(nullptr)
+        , m_shutdownTimeout(DEFAULT_SHUTDOWN_TIMEOUT)
     {}
     virtual ~SimpleUniqueThread() noexcept {
         Release();
     }
 
     bool IsEnd(bool enable_assert = false) const noexcept {
-        if (m_isEnd) {
+        if (m_completion.IsReady()) {
             return true;
         }
         if (enable_assert) {
@@ -46,7 +63,7 @@ public:
         return false;
     }
     bool IsExists(bool enable_assert = false) const noexcept {
-        if (m_upThread) {
+        if (m_upThread || !m_completion.IsReady()) {
             return true;
         }
         if (enable_assert) {
@@ -55,7 +72,7 @@ public:
         return false;
     }
     bool IsNoExists(bool enable_assert = false) const noexcept {
-        if (!m_upThread) {
+        if (!m_upThread && m_completion.IsReady()) {
             return true;
         }
         if (enable_assert) {
@@ -65,46 +82,86 @@ public:
     }
 
     template<class Func, class Inst, class... Args>
-    void Create(Func func, Inst inst, Args... args) {
+    CompletionHandle Create(Func func, Inst inst, Args... args) {
         if (IsNoExists(true)) {
-            m_isEnd = false;
+            CompletionSource source;
+            m_completion = source.GetHandle();
             m_upThread = std::make_unique<std::thread>(
                 &SimpleUniqueThread::Run<Func, Inst, Args...>,
-                this,
-                &m_isEnd, func, inst, args...
+                source, m_options, func, inst, args...
             );
         }
+        return m_completion;
     }
+    /**
+     * @brief Run the function on a thread that is detached immediately. The returned handle tells when it ends.
+     */
     template<class Func, class Inst, class... Args>
-    void CreateAutoEnd(Func func, Inst inst, Args... args) {
+    CompletionHandle CreateAutoEnd(Func func, Inst inst, Args... args) {
+        if (m_upThread && m_completion.IsReady()) {
+            // Reap the previous thread, it has already finished
+            m_upThread->join();
+            m_upThread = nullptr;
+        }
         if (IsNoExists(true)) {
-            m_isEnd = false;
-            m_upThread = std::make_unique<std::thread>(
-                &SimpleUniqueThread::RunAutoEnd<Func, Inst, Args...>,
-                this,
-                &m_isEnd, func, inst, args...
-            );
+            CompletionSource source;
+            m_completion = source.GetHandle();
+            std::thread(
+                &SimpleUniqueThread::Run<Func, Inst, Args...>,
+                source, m_options, func, inst, args...
+            ).detach();
         }
+        return m_completion;
     }
 
     std::thread::id GetID() const noexcept {
-        if (IsExists(true)) {
+        if (m_upThread) {
             return m_upThread->get_id();
         }
+        assert::ShowError(ASSERT_FILE_LINE, "thread is not exists");
         return std::thread::id();
     }
 
+    const CompletionHandle& GetCompletion() const noexcept {
+        return m_completion;
+    }
+
+    void RequestStop() const noexcept {
+        m_completion.RequestStop();
+    }
+
+    void SetShutdownTimeout(std::chrono::milliseconds timeout) noexcept {
+        m_shutdownTimeout = timeout;
+    }
+
+    /**
+     * @brief Set affinity, priority and name applied to threads created after this call.
+     */
+    void SetThreadOptions(const thread_helper::ThreadOptions& options) {
+        m_options = options;
+    }
+
     void SyncEnd(SyncType sync_type = SyncType::JOIN) {
         if (IsExists(true)) {
             switch (sync_type) {
             case SyncType::JOIN:
-                m_upThread->join();
+                if (m_upThread) {
+                    m_upThread->join();
+                }
+                else {
+                    m_completion.Wait();
+                }
                 break;
             case SyncType::DETACH:
-                m_upThread->detach();
+                if (m_upThread) {
+                    m_upThread->detach();
+                }
                 break;
             case SyncType::TERMINATE:
-                m_upThread->~thread();
+                m_completion.RequestStop();
+                if (m_upThread) {
+                    m_upThread->detach();
+                }
                 break;
             }
         }
@@ -114,25 +171,35 @@ public:
 private:
 
     template<class Func, class Inst, class... Args>
-    void Run(bool* is_end, Func func, Inst inst, Args... args) {
-        (inst->*func)(args...);
-        *is_end = true;
-    }
-    template<class Func, class Inst, class... Args>
-    void RunAutoEnd(bool* is_end, Func func, Inst inst, Args... args) {
-        (inst->*func)(args...);
-        SyncEnd(SyncType::DETACH);
-        *is_end = true;
+    static void Run(CompletionSource source, thread_helper::ThreadOptions options, Func func, Inst inst, Args... args) {
+        thread_helper::ApplyCurrentThreadOptions(options);
+        if constexpr (std::is_invocable_v<Func, Inst, StopToken, Args...>) {
+            (inst->*func)(source.GetStopToken(), args...);
+        }
+        else {
+            (inst->*func)(args...);
+        }
+        source.SetReady();
     }
 
     void Release() noexcept {
-        if (IsExists()) {
-            SyncEnd();
+        if (!IsExists()) return;
+        // The work still uses its instance, giving up on it would leave the thread with a dangling pointer
+        m_completion.RequestStop();
+        if (!m_completion.WaitFor(m_shutdownTimeout)) {
+            assert::ShowWarning(ASSERT_FILE_LINE, "thread did not stop in time, still waiting");
+            m_completion.Wait();
         }
+        if (m_upThread) {
+            m_upThread->join();
+        }
+        m_upThread = nullptr;
     }
 
-    bool                         m_isEnd    = false;
-    std::unique_ptr<std::thread> m_upThread = nullptr;
+    std::unique_ptr<std::thread> m_upThread        = nullptr;
+    CompletionHandle             m_completion;
+    std::chrono::milliseconds    m_shutdownTimeout = DEFAULT_SHUTDOWN_TIMEOUT;
+    thread_helper::ThreadOptions m_options;
 
 };
 
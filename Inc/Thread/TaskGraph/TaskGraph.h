@@ -0,0 +1,320 @@
+﻿/**
+ * @file TaskGraph.h
+ * @author shirokuma1101
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023 shirokuma1101. All rights reserved.
+ * @license MIT License (see LICENSE.txt file)
+ */
+
+#pragma once
+
+#ifndef GAME_LIBRARIES_THREAD_TASKGRAPH_TASKGRAPH_H_
+#define GAME_LIBRARIES_THREAD_TASKGRAPH_TASKGRAPH_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Thread/JobSystem/JobSystem.h"
+#include "Utility/Assert.h"
+
+/**
+ * @class TaskGraph
+ * @brief Dependency graph of tasks that is built once and run every frame on a JobSystem.
+ * @details Nodes whose predecessors have all finished run in parallel. When a node finishes, the ready successor with
+ *          the longest remaining path (measured from the previous run) continues on the same thread and the others are
+ *          submitted, so the critical path is never queued behind shorter work.
+ *          Nodes are prepared jobs, so no job objects are allocated per run. Nodes submitted from a thread that is
+ *          not a worker still go through the injection queue of the JobSystem, which may grow.
+ */
+class TaskGraph
+{
+public:
+
+    using NodeID = std::size_t;
+
+    static constexpr NodeID INVALID_NODE = (std::numeric_limits<NodeID>::max)();
+
+    /**
+     * @brief Timing of a node in the last run. Times are relative to the start of the run.
+     */
+    struct NodeTiming {
+        std::int64_t beginNS     = 0;
+        std::int64_t durationNS  = 0;
+        std::size_t  workerIndex = 0; // JobSystem::GetWorkerCount() means the thread that called Run
+    };
+
+    explicit TaskGraph(JobSystem* job_system = &JobSystem::GetDefault())
+        : m_pJobSystem(job_system)
+    {}
+    virtual ~TaskGraph() noexcept = default;
+
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    /**
+     * @brief Add a node. Invalidates the built state.
+     * @param name Name shown in timings.
+     * @param func Work of the node.
+     * @param predecessors Nodes that must finish before this one starts.
+     * @param estimated_cost_ns Cost used for prioritization until the node has been measured once.
+     * @return ID of the node.
+     */
+    NodeID AddNode(std::string_view name, std::function<void()> func, std::initializer_list<NodeID> predecessors = {}, std::int64_t estimated_cost_ns = 1) {
+        const NodeID id = m_upNodes.size();
+        auto node = std::make_unique<Node>();
+        node->name     = name;
+        node->func     = std::move(func);
+        node->costNS   = estimated_cost_ns;
+        node->job.func = [this, id] { RunChain(id); };
+        m_upNodes.emplace_back(std::move(node));
+        for (const auto& e : predecessors) {
+            AddDependency(e, id);
+        }
+        m_isBuilt = false;
+        return id;
+    }
+
+    /**
+     * @brief Make successor wait for predecessor. Invalidates the built state.
+     */
+    void AddDependency(NodeID predecessor, NodeID successor) {
+        if (predecessor >= m_upNodes.size() || successor >= m_upNodes.size() || predecessor == successor) {
+            assert::ShowError(ASSERT_FILE_LINE, "invalid dependency");
+            return;
+        }
+        m_upNodes[predecessor]->successors.push_back(successor);
+        ++m_upNodes[successor]->predecessorCount;
+        m_isBuilt = false;
+    }
+
+    /**
+     * @brief Validate the graph and prepare everything Run needs. Called by Run if necessary.
+     * @return false if the graph has a cycle.
+     */
+    bool Build() {
+        m_topologicalOrder.clear();
+        m_roots.clear();
+
+        // Kahn's algorithm
+        std::vector<std::size_t> in_degree(m_upNodes.size());
+        for (NodeID i = 0; i < m_upNodes.size(); ++i) {
+            in_degree[i] = m_upNodes[i]->predecessorCount;
+            if (!in_degree[i]) {
+                m_roots.push_back(i);
+                m_topologicalOrder.push_back(i);
+            }
+        }
+        for (std::size_t i = 0; i < m_topologicalOrder.size(); ++i) {
+            for (const auto& e : m_upNodes[m_topologicalOrder[i]]->successors) {
+                if (!--in_degree[e]) {
+                    m_topologicalOrder.push_back(e);
+                }
+            }
+        }
+        if (m_topologicalOrder.size() != m_upNodes.size()) {
+            assert::ShowError(ASSERT_FILE_LINE, "task graph has a cycle");
+            m_topologicalOrder.clear();
+            m_roots.clear();
+            return false;
+        }
+
+        m_group   = m_pJobSystem->CreateGroup();
+        m_isBuilt = true;
+        UpdatePriorities();
+        return true;
+    }
+
+    /**
+     * @brief Run every node once and block until all of them have finished.
+     * @details If a node throws on the calling thread, the nodes already submitted are waited for and the exception
+     *          reaches the caller.
+     */
+    void Run() {
+        if (!m_isBuilt && !Build()) return;
+        if (m_roots.empty()) return;
+        ApplyAsyncRunTimings();
+
+        for (auto&& e : m_upNodes) {
+            e->pendingPredecessors.store(e->predecessorCount, std::memory_order_relaxed);
+        }
+
+        m_runBegin = std::chrono::steady_clock::now();
+
+        {
+            // Submitted nodes refer to this graph, they must finish before an exception leaves Run
+            struct WaitGuard {
+                const JobHandle& group;
+                ~WaitGuard() {
+                    group.Wait();
+                }
+            } guard{ m_group };
+
+            // Roots are sorted by ascending priority, the most critical one runs on this thread
+            for (std::size_t i = 0; i + 1 < m_roots.size(); ++i) {
+                m_pJobSystem->SubmitPrepared(m_group, &m_upNodes[m_roots[i]]->job);
+            }
+            RunChain(m_roots.back());
+        }
+
+        m_lastRunNS = ElapsedNS(m_runBegin);
+        UpdatePriorities();
+    }
+
+    /**
+     * @brief Start every node once without blocking, for graphs run from a job or loaded in the background.
+     * @details Every root is submitted, so no thread is parked waiting for the graph. Nobody sees the run end, so
+     *          its timings update the priorities and the last run time at the start of the next run. Do not run the
+     *          graph again or destroy it before the handle is done.
+     * @return Handle that is done when every node has finished. Invalid if the graph has a cycle.
+     */
+    JobHandle RunAsync() {
+        if (!m_isBuilt && !Build()) return JobHandle();
+        ApplyAsyncRunTimings();
+
+        for (auto&& e : m_upNodes) {
+            e->pendingPredecessors.store(e->predecessorCount, std::memory_order_relaxed);
+        }
+
+        m_runBegin = std::chrono::steady_clock::now();
+
+        // Roots are sorted by ascending priority, the most critical one is submitted first
+        for (auto iter = m_roots.rbegin(); iter != m_roots.rend(); ++iter) {
+            m_pJobSystem->SubmitPrepared(m_group, &m_upNodes[*iter]->job);
+        }
+        m_isAsyncRunPending = true;
+        return m_group;
+    }
+
+    std::size_t GetNodeCount() const noexcept {
+        return m_upNodes.size();
+    }
+
+    const std::string& GetName(NodeID id) const noexcept {
+        return m_upNodes[id]->name;
+    }
+
+    const NodeTiming& GetTiming(NodeID id) const noexcept {
+        return m_upNodes[id]->timing;
+    }
+
+    /**
+     * @brief Longest remaining path from the node, in nanoseconds of the last run. Used as its priority.
+     */
+    std::int64_t GetPriority(NodeID id) const noexcept {
+        return m_upNodes[id]->priority;
+    }
+
+    /**
+     * @brief Wall time of the last run in nanoseconds.
+     */
+    std::int64_t GetLastRunTime() const noexcept {
+        return m_lastRunNS;
+    }
+
+private:
+
+    struct Node {
+        std::string               name;
+        std::function<void()>     func;
+        std::vector<NodeID>       successors;
+        std::size_t               predecessorCount    = 0;
+        std::atomic<std::size_t>  pendingPredecessors = 0;
+        std::int64_t              costNS              = 1;
+        std::int64_t              priority            = 0;
+        NodeTiming                timing;
+        JobSystem::PreparedJob    job;
+    };
+
+    /**
+     * @brief Run a node, then keep running the most critical successor it made ready on the same thread.
+     */
+    void RunChain(NodeID id) {
+        while (id != INVALID_NODE) {
+            auto& node = *m_upNodes[id];
+
+            node.timing.beginNS     = ElapsedNS(m_runBegin);
+            node.timing.workerIndex = m_pJobSystem->GetCurrentWorkerIndex();
+            node.func();
+            node.timing.durationNS  = ElapsedNS(m_runBegin) - node.timing.beginNS;
+
+            // Successors are sorted by ascending priority, so the last ready one is the most critical
+            NodeID next = INVALID_NODE;
+            for (const auto& e : node.successors) {
+                if (m_upNodes[e]->pendingPredecessors.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    if (next != INVALID_NODE) {
+                        m_pJobSystem->SubmitPrepared(m_group, &m_upNodes[next]->job);
+                    }
+                    next = e;
+                }
+            }
+            id = next;
+        }
+    }
+
+    /**
+     * @brief Update the priorities and the last run time from the timings of the previous RunAsync, if any.
+     */
+    void ApplyAsyncRunTimings() {
+        if (!m_isAsyncRunPending) return;
+        m_isAsyncRunPending = false;
+        std::int64_t end_ns = 0;
+        for (const auto& e : m_upNodes) {
+            end_ns = (std::max)(end_ns, e->timing.beginNS + e->timing.durationNS);
+        }
+        m_lastRunNS = end_ns;
+        UpdatePriorities();
+    }
+
+    /**
+     * @brief Recompute upward ranks from the measured costs and reorder roots and successors by them.
+     */
+    void UpdatePriorities() {
+        for (auto iter = m_topologicalOrder.rbegin(); iter != m_topologicalOrder.rend(); ++iter) {
+            auto& node = *m_upNodes[*iter];
+            if (node.timing.durationNS > 0) {
+                node.costNS = node.timing.durationNS;
+            }
+            std::int64_t longest = 0;
+            for (const auto& e : node.successors) {
+                longest = (std::max)(longest, m_upNodes[e]->priority);
+            }
+            node.priority = node.costNS + longest;
+        }
+        const auto by_priority = [this](NodeID lhs, NodeID rhs) {
+            return m_upNodes[lhs]->priority < m_upNodes[rhs]->priority;
+        };
+        for (auto&& e : m_upNodes) {
+            std::sort(e->successors.begin(), e->successors.end(), by_priority);
+        }
+        std::sort(m_roots.begin(), m_roots.end(), by_priority);
+    }
+
+    static std::int64_t ElapsedNS(std::chrono::steady_clock::time_point begin) noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    JobSystem*                         m_pJobSystem        = nullptr;
+    std::vector<std::unique_ptr<Node>> m_upNodes;
+    std::vector<NodeID>                m_roots;
+    std::vector<NodeID>                m_topologicalOrder;
+    JobHandle                          m_group;
+    bool                               m_isBuilt           = false;
+    bool                               m_isAsyncRunPending = false; // Timings of a RunAsync not applied yet
+
+    std::chrono::steady_clock::time_point m_runBegin;
+    std::int64_t                          m_lastRunNS = 0;
+
+};
+
+#endif
@@ -0,0 +1,258 @@
+﻿/**
+ * @file ThreadHelper.h
+ * @author shirokuma1101
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023 shirokuma1101. All rights reserved.
+ * @license MIT License (see LICENSE.txt file)
+ */
+
+#pragma once
+
+#ifndef GAME_LIBRARIES_THREAD_THREADHELPER_THREADHELPER_H_
+#define GAME_LIBRARIES_THREAD_THREADHELPER_THREADHELPER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @namespace thread_helper
+ * @brief Namespace containing helpers shared by the thread modules.
+ */
+namespace thread_helper {
+
+    /**
+     * @brief Size of a cache line. Used to pad data touched by different threads to avoid false sharing.
+     */
+    constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    /**
+     * @brief Hint to the processor that the caller is spinning.
+     */
+    inline void CpuRelax() noexcept {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    /**
+     * @brief Get the number of logical processors.
+     * @return The number of logical processors, at least 1.
+     */
+    inline std::size_t GetLogicalProcessorCount() noexcept {
+        const auto count = std::thread::hardware_concurrency();
+        return count ? count : 1;
+    }
+
+    /**
+     * @brief Scheduling class of a thread.
+     */
+    enum class ThreadPriority {
+        LATENCY_CRITICAL, // Main loop, audio mixing. Raising may need privileges and then silently stays normal.
+        NORMAL,
+        BACKGROUND_IO,    // Loaders and other work that should yield the CPU and the disk to everything else.
+    };
+
+    /**
+     * @brief Options applied to a thread when it starts.
+     */
+    struct ThreadOptions {
+        std::vector<std::size_t> affinity;                          // Logical processors the thread may run on. Empty keeps the default.
+        ThreadPriority           priority = ThreadPriority::NORMAL;
+        std::string              name;                              // Shown in debuggers and profilers. Empty keeps the default.
+    };
+
+    /**
+     * @brief Physical layout of the processors.
+     */
+    struct CpuTopology {
+        std::size_t                           logicalCount = 0;
+        std::vector<std::vector<std::size_t>> physicalCores;        // Logical processors (hardware threads) of each physical core
+    };
+
+    /**
+     * @brief Query which logical processors share a physical core.
+     * @return The topology. Falls back to one logical processor per core if it can not be read.
+     */
+    inline CpuTopology GetCpuTopology() {
+        CpuTopology topology;
+#ifdef _WIN32
+        DWORD length = 0;
+        GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &length);
+        std::vector<char> buffer(length);
+        auto* info = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data());
+        if (length && GetLogicalProcessorInformationEx(RelationProcessorCore, info, &length)) {
+            for (DWORD offset = 0; offset < length;) {
+                auto* entry = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+                std::vector<std::size_t> core;
+                for (WORD group = 0; group < entry->Processor.GroupCount; ++group) {
+                    const auto mask = entry->Processor.GroupMask[group].Mask;
+                    for (std::size_t bit = 0; bit < sizeof(mask) * 8; ++bit) {
+                        if (mask & (static_cast<KAFFINITY>(1) << bit)) {
+                            core.push_back(entry->Processor.GroupMask[group].Group * 64 + bit);
+                        }
+                    }
+                }
+                topology.logicalCount += core.size();
+                topology.physicalCores.emplace_back(std::move(core));
+                offset += entry->Size;
+            }
+        }
+#else
+        const long configured = sysconf(_SC_NPROCESSORS_CONF);
+        std::map<std::pair<int, int>, std::vector<std::size_t>> cores;
+        for (long cpu = 0; cpu < configured; ++cpu) {
+            const std::string dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+            int core_id = -1, package_id = -1;
+            std::ifstream(dir + "core_id") >> core_id;
+            std::ifstream(dir + "physical_package_id") >> package_id;
+            if (core_id < 0) {
+                core_id = static_cast<int>(cpu);
+            }
+            cores[{ package_id, core_id }].push_back(static_cast<std::size_t>(cpu));
+        }
+        for (auto&& e : cores) {
+            topology.logicalCount += e.second.size();
+            topology.physicalCores.emplace_back(std::move(e.second));
+        }
+        std::sort(topology.physicalCores.begin(), topology.physicalCores.end());
+#endif
+        if (topology.physicalCores.empty()) {
+            topology.logicalCount = GetLogicalProcessorCount();
+            for (std::size_t i = 0; i < topology.logicalCount; ++i) {
+                topology.physicalCores.push_back({ i });
+            }
+        }
+        return topology;
+    }
+
+    /**
+     * @brief Restrict the calling thread to a set of logical processors.
+     * @param logical_processors Logical processor indices.
+     * @return true on success.
+     */
+    inline bool SetCurrentThreadAffinity(const std::vector<std::size_t>& logical_processors) {
+        if (logical_processors.empty()) return false;
+#ifdef _WIN32
+        DWORD_PTR mask = 0;
+        for (const auto& e : logical_processors) {
+            if (e < sizeof(DWORD_PTR) * 8) {
+                mask |= static_cast<DWORD_PTR>(1) << e;
+            }
+        }
+        return mask && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#else
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (const auto& e : logical_processors) {
+            if (e < CPU_SETSIZE) {
+                CPU_SET(e, &set);
+            }
+        }
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#endif
+    }
+
+    /**
+     * @brief Change the scheduling class of the calling thread.
+     * @param priority The priority.
+     * @return true on success. Raising the priority may fail without privileges.
+     */
+    inline bool SetCurrentThreadPriority(ThreadPriority priority) {
+#ifdef _WIN32
+        switch (priority) {
+        case ThreadPriority::LATENCY_CRITICAL:
+            return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST) != 0;
+        case ThreadPriority::NORMAL:
+            return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_NORMAL) != 0;
+        case ThreadPriority::BACKGROUND_IO:
+            // Also lowers the I/O and memory priority of the thread
+            return SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN) != 0;
+        }
+        return false;
+#else
+        // Per thread nice value, Linux applies setpriority to a single thread when given its tid
+        const auto tid = static_cast<id_t>(syscall(SYS_gettid));
+        switch (priority) {
+        case ThreadPriority::LATENCY_CRITICAL:
+            return setpriority(PRIO_PROCESS, tid, -5) == 0;
+        case ThreadPriority::NORMAL:
+            return setpriority(PRIO_PROCESS, tid, 0) == 0;
+        case ThreadPriority::BACKGROUND_IO: {
+            const bool nice_result = setpriority(PRIO_PROCESS, tid, 10) == 0;
+#ifdef SYS_ioprio_set
+            // IOPRIO_WHO_PROCESS = 1, best effort class (2) at the lowest level (7)
+            constexpr int IOPRIO_CLASS_SHIFT = 13;
+            syscall(SYS_ioprio_set, 1, static_cast<int>(tid), (2 << IOPRIO_CLASS_SHIFT) | 7);
+#endif
+            return nice_result;
+        }
+        }
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Name the calling thread. Linux truncates names to 15 characters.
+     * @param name The name.
+     * @return true on success.
+     */
+    inline bool SetCurrentThreadName(const std::string& name) {
+        if (name.empty()) return false;
+#ifdef _WIN32
+        const std::wstring wide_name(name.begin(), name.end());
+        return SUCCEEDED(SetThreadDescription(GetCurrentThread(), wide_name.c_str()));
+#else
+        return pthread_setname_np(pthread_self(), name.substr(0, 15).c_str()) == 0;
+#endif
+    }
+
+    /**
+     * @brief Apply every set field of the options to the calling thread.
+     * @param options The options.
+     */
+    inline void ApplyCurrentThreadOptions(const ThreadOptions& options) {
+        if (!options.affinity.empty()) {
+            SetCurrentThreadAffinity(options.affinity);
+        }
+        if (options.priority != ThreadPriority::NORMAL) {
+            SetCurrentThreadPriority(options.priority);
+        }
+        if (!options.name.empty()) {
+            SetCurrentThreadName(options.name);
+        }
+    }
+
+}
+
+#endif
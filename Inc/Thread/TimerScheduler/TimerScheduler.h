@@ -0,0 +1,366 @@
+﻿/**
+ * @file TimerScheduler.h
+ * @author shirokuma1101
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023 shirokuma1101. All rights reserved.
+ * @license MIT License (see LICENSE.txt file)
+ */
+
+#pragma once
+
+#ifndef GAME_LIBRARIES_THREAD_TIMERSCHEDULER_TIMERSCHEDULER_H_
+#define GAME_LIBRARIES_THREAD_TIMERSCHEDULER_TIMERSCHEDULER_H_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "Thread/JobSystem/JobSystem.h"
+
+/**
+ * @class TimerScheduler
+ * @brief Delayed and periodic callbacks on a hierarchical timer wheel.
+ * @details Four wheels of 256 slots cover 2^32 ticks (about 49 days at 1ms). A timer sits in the wheel matching how far
+ *          away it is and moves one wheel down when the slot above comes around, so Schedule and Cancel are O(1) and
+ *          advancing costs one slot per elapsed tick plus the timers that fire, whatever the number of pending timers.
+ *          Stretches where the lowest wheel is empty are skipped without visiting their slots.
+ *          Schedule, Cancel and the queries can be called from any thread. Update or Advance must be called from one
+ *          thread only, usually once per frame from the main thread; MAIN_THREAD callbacks run there, after the wheel
+ *          has been advanced and without the lock held, so they may schedule or cancel timers.
+ */
+class TimerScheduler
+{
+public:
+
+    using TimerID = std::uint64_t;
+
+    static constexpr TimerID INVALID_TIMER = 0;
+
+    /**
+     * @brief Where a callback runs when its timer fires.
+     */
+    enum class Dispatch {
+        MAIN_THREAD, // the thread that calls Update or Advance
+        JOB_SYSTEM,  // submitted to the job system
+    };
+
+    /**
+     * @brief Constructor.
+     * @param tick_duration Resolution of the wheel. Delays are rounded up to whole ticks.
+     * @param job_system Job system for JOB_SYSTEM callbacks. nullptr uses JobSystem::GetDefault() when needed.
+     */
+    explicit TimerScheduler(std::chrono::nanoseconds tick_duration = std::chrono::milliseconds(1), JobSystem* job_system = nullptr)
+        : m_tickNS(tick_duration.count() > 0 ? tick_duration.count() : 1)
+        , m_pJobSystem(job_system)
+        , m_lastUpdate(std::chrono::steady_clock::now())
+    {
+        for (auto&& level : m_slots) {
+            level.fill(NIL);
+        }
+    }
+    virtual ~TimerScheduler() noexcept = default;
+
+    TimerScheduler(const TimerScheduler&) = delete;
+    TimerScheduler& operator=(const TimerScheduler&) = delete;
+
+    /**
+     * @brief Call func once after delay.
+     * @param delay Time from now. Anything below one tick fires on the next tick.
+     * @param func Callback.
+     * @param dispatch Where the callback runs.
+     * @return ID used to cancel the timer.
+     */
+    TimerID Schedule(std::chrono::nanoseconds delay, std::function<void()> func, Dispatch dispatch = Dispatch::MAIN_THREAD) {
+        return Add(ToTicks(delay), 0, std::move(func), dispatch);
+    }
+
+    /**
+     * @brief Call func every interval until cancelled.
+     * @param interval Period, at least one tick. Missed periods are caught up, so the average rate is kept.
+     * @param func Callback.
+     * @param dispatch Where the callback runs.
+     * @return ID used to cancel the timer.
+     */
+    TimerID SchedulePeriodic(std::chrono::nanoseconds interval, std::function<void()> func, Dispatch dispatch = Dispatch::MAIN_THREAD) {
+        const std::uint64_t ticks = ToTicks(interval);
+        return Add(ticks, ticks, std::move(func), dispatch);
+    }
+
+    /**
+     * @brief Cancel a timer. A callback already collected by the running Update still runs once.
+     * @return false if the timer is unknown, has already fired or was already cancelled.
+     */
+    bool Cancel(TimerID id) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const std::uint32_t index = Find(id);
+        if (index == NIL) return false;
+        Unlink(index);
+        Release(index);
+        return true;
+    }
+
+    bool IsPending(TimerID id) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return Find(id) != NIL;
+    }
+
+    std::size_t GetPendingCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_pendingCount;
+    }
+
+    /**
+     * @brief Ticks processed since construction.
+     */
+    std::uint64_t GetCurrentTick() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_currentTick;
+    }
+
+    /**
+     * @brief Advance by the wall time since the last Update and run the callbacks that are due.
+     */
+    void Update() {
+        const auto now = std::chrono::steady_clock::now();
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_lastUpdate);
+        m_lastUpdate = now;
+        Advance(elapsed);
+    }
+
+    /**
+     * @brief Advance by the given time and run the callbacks that are due. Useful with a fixed or scaled delta time.
+     */
+    void Advance(std::chrono::nanoseconds elapsed) {
+        if (elapsed.count() > 0) {
+            m_remainderNS += elapsed.count();
+        }
+        const std::uint64_t ticks = static_cast<std::uint64_t>(m_remainderNS / m_tickNS);
+        m_remainderNS %= m_tickNS;
+        AdvanceTicks(ticks);
+    }
+
+    /**
+     * @brief Advance by whole ticks and run the callbacks that are due.
+     */
+    void AdvanceTicks(std::uint64_t ticks) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const std::uint64_t target = m_currentTick + ticks;
+            while (m_currentTick < target) {
+                if (m_pendingCount == 0) {
+                    m_currentTick = target;
+                    break;
+                }
+                // Nothing can fire before the lowest wheel wraps, jump to the tick before the next cascade
+                if (m_levelCounts[0] == 0) {
+                    const std::uint64_t before_wrap = (m_currentTick | SLOT_MASK);
+                    if (before_wrap > m_currentTick) {
+                        m_currentTick = before_wrap < target ? before_wrap : target;
+                        continue;
+                    }
+                }
+                Tick(++m_currentTick);
+            }
+        }
+
+        for (auto&& e : m_fired) {
+            if (e.dispatch == Dispatch::JOB_SYSTEM) {
+                auto& job_system = m_pJobSystem ? *m_pJobSystem : JobSystem::GetDefault();
+                job_system.Submit([sp_func = std::move(e.spFunc)] { (*sp_func)(); });
+            }
+            else {
+                (*e.spFunc)();
+            }
+        }
+        m_fired.clear();
+    }
+
+private:
+
+    static constexpr std::size_t   LEVELS    = 4;
+    static constexpr std::size_t   SLOT_BITS = 8;
+    static constexpr std::size_t   SLOTS     = std::size_t(1) << SLOT_BITS;
+    static constexpr std::uint64_t SLOT_MASK = SLOTS - 1;
+    static constexpr std::uint32_t NIL       = 0xFFFFFFFF;
+
+    struct Node {
+        std::shared_ptr<std::function<void()>> spFunc;
+        std::uint64_t                          expireTick    = 0;
+        std::uint64_t                          intervalTicks = 0;
+        std::uint32_t                          generation    = 1;
+        std::uint32_t                          prev          = NIL;
+        std::uint32_t                          next          = NIL;
+        std::uint16_t                          level         = 0;
+        std::uint16_t                          slot          = 0;
+        bool                                   isPending     = false;
+        Dispatch                               dispatch      = Dispatch::MAIN_THREAD;
+    };
+
+    struct Fired {
+        std::shared_ptr<std::function<void()>> spFunc;
+        Dispatch                               dispatch = Dispatch::MAIN_THREAD;
+    };
+
+    std::uint64_t ToTicks(std::chrono::nanoseconds duration) const noexcept {
+        if (duration.count() <= 0) return 1;
+        const std::uint64_t ticks = static_cast<std::uint64_t>((duration.count() + m_tickNS - 1) / m_tickNS);
+        return ticks ? ticks : 1;
+    }
+
+    TimerID Add(std::uint64_t delay_ticks, std::uint64_t interval_ticks, std::function<void()> func, Dispatch dispatch) {
+        auto sp_func = std::make_shared<std::function<void()>>(std::move(func));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::uint32_t index = m_freeHead;
+        if (index != NIL) {
+            m_freeHead = m_nodes[index].next;
+        }
+        else {
+            index = static_cast<std::uint32_t>(m_nodes.size());
+            m_nodes.emplace_back();
+        }
+
+        auto& node = m_nodes[index];
+        node.spFunc        = std::move(sp_func);
+        node.expireTick    = m_currentTick + delay_ticks;
+        node.intervalTicks = interval_ticks;
+        node.isPending     = true;
+        node.dispatch      = dispatch;
+        ++m_pendingCount;
+        Link(index);
+        return (static_cast<TimerID>(node.generation) << 32) | index;
+    }
+
+    std::uint32_t Find(TimerID id) const noexcept {
+        const auto index = static_cast<std::uint32_t>(id & 0xFFFFFFFF);
+        if (index >= m_nodes.size()) return NIL;
+        const auto& node = m_nodes[index];
+        if (!node.isPending || node.generation != static_cast<std::uint32_t>(id >> 32)) return NIL;
+        return index;
+    }
+
+    /**
+     * @brief Put a node in the wheel matching the distance to its expiry.
+     */
+    void Link(std::uint32_t index) noexcept {
+        auto& node = m_nodes[index];
+        const std::uint64_t delta = node.expireTick - m_currentTick;
+        std::size_t level = 0;
+        while (level + 1 < LEVELS && delta >= (std::uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+            ++level;
+        }
+        std::uint64_t slot = 0;
+        if (delta >= (std::uint64_t(1) << (SLOT_BITS * LEVELS))) {
+            // Beyond the top wheel, park in the top slot that comes around last and cascade again from there
+            slot = ((m_currentTick >> (SLOT_BITS * level)) - 1) & SLOT_MASK;
+        }
+        else {
+            slot = (node.expireTick >> (SLOT_BITS * level)) & SLOT_MASK;
+        }
+
+        node.level = static_cast<std::uint16_t>(level);
+        node.slot  = static_cast<std::uint16_t>(slot);
+        node.prev  = NIL;
+        node.next  = m_slots[level][slot];
+        if (node.next != NIL) {
+            m_nodes[node.next].prev = index;
+        }
+        m_slots[level][slot] = index;
+        ++m_levelCounts[level];
+    }
+
+    void Unlink(std::uint32_t index) noexcept {
+        auto& node = m_nodes[index];
+        if (node.prev != NIL) {
+            m_nodes[node.prev].next = node.next;
+        }
+        else {
+            m_slots[node.level][node.slot] = node.next;
+        }
+        if (node.next != NIL) {
+            m_nodes[node.next].prev = node.prev;
+        }
+        --m_levelCounts[node.level];
+    }
+
+    void Release(std::uint32_t index) noexcept {
+        auto& node = m_nodes[index];
+        node.spFunc.reset();
+        node.isPending = false;
+        ++node.generation;
+        if (node.generation == 0) {
+            node.generation = 1;
+        }
+        node.next  = m_freeHead;
+        m_freeHead = index;
+        --m_pendingCount;
+    }
+
+    std::uint32_t DetachSlot(std::size_t level, std::size_t slot) noexcept {
+        const std::uint32_t head = m_slots[level][slot];
+        m_slots[level][slot] = NIL;
+        for (std::uint32_t i = head; i != NIL; i = m_nodes[i].next) {
+            --m_levelCounts[level];
+        }
+        return head;
+    }
+
+    /**
+     * @brief Process one tick: move timers down from the upper wheels whose slot came around, then fire the due slot.
+     */
+    void Tick(std::uint64_t tick) {
+        for (std::size_t level = LEVELS - 1; level > 0; --level) {
+            const std::uint64_t shift = SLOT_BITS * level;
+            if ((tick & ((std::uint64_t(1) << shift) - 1)) != 0) continue;
+            if (m_levelCounts[level] == 0) continue;
+            std::uint32_t i = DetachSlot(level, static_cast<std::size_t>((tick >> shift) & SLOT_MASK));
+            while (i != NIL) {
+                const std::uint32_t next = m_nodes[i].next;
+                Link(i);
+                i = next;
+            }
+        }
+
+        std::uint32_t i = DetachSlot(0, static_cast<std::size_t>(tick & SLOT_MASK));
+        while (i != NIL) {
+            auto& node = m_nodes[i];
+            const std::uint32_t next = node.next;
+            m_fired.push_back({ node.spFunc, node.dispatch });
+            if (node.intervalTicks) {
+                node.expireTick += node.intervalTicks;
+                Link(i);
+            }
+            else {
+                Release(i);
+            }
+            i = next;
+        }
+    }
+
+    const std::int64_t m_tickNS;
+    JobSystem*         m_pJobSystem = nullptr;
+
+    mutable std::mutex                                     m_mutex;
+    std::vector<Node>                                      m_nodes;
+    std::array<std::array<std::uint32_t, SLOTS>, LEVELS>   m_slots;
+    std::array<std::size_t, LEVELS>                        m_levelCounts  = {};
+    std::uint32_t                                          m_freeHead     = NIL;
+    std::size_t                                            m_pendingCount = 0;
+    std::uint64_t                                          m_currentTick  = 0;
+
+    // Touched only by the thread that advances
+    std::vector<Fired>                    m_fired;
+    std::int64_t                          m_remainderNS = 0;
+    std::chrono::steady_clock::time_point m_lastUpdate;
+
+};
+
+#endif
@@ -0,0 +1,173 @@
+﻿/**
+ * @file StringId.h
+ * @author shirokuma1101
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023 shirokuma1101. All rights reserved.
+ * @license MIT License (see LICENSE.txt file)
+ */
+
+#pragma once
+
+#ifndef GAME_LIBRARIES_UTILITY_STRINGID_H_
+#define GAME_LIBRARIES_UTILITY_STRINGID_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "Utility/Assert.h"
+
+/**
+ * @class StringId
+ * @brief 64-bit FNV-1a hash of a name, used as the key of name lookups instead of the name itself.
+ * @details Construction is constexpr, so ids of literals (e.g. "player"_sid) can be computed at compile time and
+ *          lookups cost an integer compare. 0 is the invalid id, no name hashes to it. The name is not kept, names
+ *          interned in StringIdTable can be looked up from the id for debugging.
+ */
+class StringId
+{
+public:
+
+    constexpr StringId() noexcept = default;
+    constexpr StringId(const char* name) noexcept
+        : StringId(std::string_view(name))
+    {}
+    constexpr StringId(std::string_view name) noexcept
+        : m_value(Hash(name))
+    {}
+    StringId(const std::string& name) noexcept
+        : StringId(std::string_view(name))
+    {}
+
+    /**
+     * @brief Id of a hash value, e.g. one read back from a file.
+     */
+    static constexpr StringId FromValue(std::uint64_t value) noexcept {
+        StringId id;
+        id.m_value = value;
+        return id;
+    }
+
+    static constexpr std::uint64_t Hash(std::string_view name) noexcept {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (const auto& e : name) {
+            hash = (hash ^ static_cast<std::uint8_t>(e)) * 1099511628211ull;
+        }
+        return hash ? hash : 1;
+    }
+
+    constexpr std::uint64_t GetValue() const noexcept {
+        return m_value;
+    }
+    constexpr bool IsValid() const noexcept {
+        return m_value != 0;
+    }
+
+    /**
+     * @brief Interned name of the id, or its value in hex if the name was never interned. For messages only.
+     */
+    std::string GetName() const;
+
+    constexpr bool operator==(StringId other) const noexcept {
+        return m_value == other.m_value;
+    }
+    constexpr bool operator!=(StringId other) const noexcept {
+        return m_value != other.m_value;
+    }
+    constexpr bool operator<(StringId other) const noexcept {
+        return m_value < other.m_value;
+    }
+
+private:
+
+    std::uint64_t m_value = 0;
+
+};
+
+/**
+ * @brief Id of a string literal.
+ */
+constexpr StringId operator""_sid(const char* name, std::size_t length) noexcept {
+    return StringId(std::string_view(name, length));
+}
+
+namespace std {
+    template<>
+    struct hash<StringId> {
+        std::size_t operator()(StringId id) const noexcept {
+            return static_cast<std::size_t>(id.GetValue());
+        }
+    };
+}
+
+/**
+ * @class StringIdTable
+ * @brief Process wide table of the names behind ids, for debug output.
+ * @details Managers intern the names they register, so lookups by id can still report the name they failed on.
+ *          Two names with the same id are reported as an error when the second one is interned.
+ */
+class StringIdTable
+{
+public:
+
+    static StringIdTable& GetDefault() {
+        static StringIdTable table;
+        return table;
+    }
+
+    /**
+     * @brief Record the name of its id.
+     * @return Id of the name.
+     */
+    StringId Intern(std::string_view name) {
+        const StringId id(name);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto [iter, is_inserted] = m_names.try_emplace(id.GetValue(), name);
+        if (!is_inserted && iter->second != name) {
+            assert::ShowError(ASSERT_FILE_LINE, "StringId collision: " + iter->second + " and " + std::string(name));
+        }
+        return id;
+    }
+
+    /**
+     * @return Empty if the id was never interned. Stays valid as long as the table.
+     */
+    std::string_view Find(StringId id) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (auto iter = m_names.find(id.GetValue()); iter != m_names.end()) {
+            return iter->second;
+        }
+        return std::string_view();
+    }
+
+    std::size_t GetCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_names.size();
+    }
+
+private:
+
+    mutable std::mutex                             m_mutex;
+    std::unordered_map<std::uint64_t, std::string> m_names;
+
+};
+
+inline std::string StringId::GetName() const {
+    if (auto name = StringIdTable::GetDefault().Find(*this); !name.empty()) {
+        return std::string(name);
+    }
+    constexpr char digits[] = "0123456789abcdef";
+    std::string hex = "#0000000000000000";
+    for (std::size_t i = 0; i < 16; ++i) {
+        hex[16 - i] = digits[(m_value >> (i * 4)) & 0xF];
+    }
+    return hex;
+}
+
+#endif
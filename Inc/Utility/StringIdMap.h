@@ -0,0 +1,211 @@
+﻿/**
+ * @file StringIdMap.h
+ * @author shirokuma1101
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2023 shirokuma1101. All rights reserved.
+ * @license MIT License (see LICENSE.txt file)
+ */
+
+#pragma once
+
+#ifndef GAME_LIBRARIES_UTILITY_STRINGIDMAP_H_
+#define GAME_LIBRARIES_UTILITY_STRINGIDMAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Utility/Assert.h"
+#include "Utility/StringId.h"
+
+/**
+ * @class StringIdMap
+ * @brief Hash map from StringId to T with open addressing and linear probing.
+ * @details Keys and values are stored inline in one power-of-two array, a lookup is a multiply, a shift and a scan of
+ *          neighbouring slots, and nothing is allocated except when the map grows. Erasing shifts the following
+ *          entries back, so there are no tombstones. Pointers returned by Find and TryEmplace are invalidated by
+ *          any insertion or erasure.
+ * @tparam T Value type. Must be default constructible and move assignable.
+ */
+template<class T>
+class StringIdMap
+{
+public:
+
+    static_assert(std::is_default_constructible_v<T> && std::is_move_assignable_v<T>, "T must be default constructible and move assignable");
+
+    StringIdMap() noexcept = default;
+
+    /**
+     * @return nullptr if the id is not in the map.
+     */
+    T* Find(StringId id) noexcept {
+        return const_cast<T*>(static_cast<const StringIdMap&>(*this).Find(id));
+    }
+    const T* Find(StringId id) const noexcept {
+        if (!m_size || !id.IsValid()) return nullptr;
+        for (std::size_t i = GetHome(id.GetValue());; i = (i + 1) & m_mask) {
+            const auto& slot = m_slots[i];
+            if (slot.key == id.GetValue()) return &slot.value;
+            if (!slot.key) return nullptr;
+        }
+    }
+
+    bool Contains(StringId id) const noexcept {
+        return Find(id) != nullptr;
+    }
+
+    /**
+     * @brief Insert a value constructed from args unless the id is already in the map.
+     * @return Value of the id and whether it was inserted. nullptr for the invalid id.
+     */
+    template<class... Args>
+    std::pair<T*, bool> TryEmplace(StringId id, Args&&... args) {
+        if (!id.IsValid()) {
+            assert::ShowError(ASSERT_FILE_LINE, "Invalid StringId inserted");
+            return { nullptr, false };
+        }
+        if (auto* value = Find(id)) {
+            return { value, false };
+        }
+        if ((m_size + 1) * 4 > m_slots.size() * 3) {
+            Rehash(m_slots.empty() ? MIN_CAPACITY : m_slots.size() * 2);
+        }
+        auto& slot = m_slots[FindEmpty(id.GetValue())];
+        slot.key   = id.GetValue();
+        slot.value = T(std::forward<Args>(args)...);
+        ++m_size;
+        return { &slot.value, true };
+    }
+
+    /**
+     * @brief Value of the id, default constructed if it is not in the map.
+     */
+    T& operator[](StringId id) {
+        return *TryEmplace(id).first;
+    }
+
+    /**
+     * @return false if the id was not in the map.
+     */
+    bool Erase(StringId id) {
+        if (!m_size || !id.IsValid()) return false;
+        std::size_t i = GetHome(id.GetValue());
+        while (m_slots[i].key != id.GetValue()) {
+            if (!m_slots[i].key) return false;
+            i = (i + 1) & m_mask;
+        }
+        // Move later entries of the cluster back into the hole unless that would put them before their home slot
+        for (std::size_t j = (i + 1) & m_mask; m_slots[j].key; j = (j + 1) & m_mask) {
+            const std::size_t home = GetHome(m_slots[j].key);
+            if (((j - home) & m_mask) >= ((j - i) & m_mask)) {
+                m_slots[i] = std::move(m_slots[j]);
+                i = j;
+            }
+        }
+        m_slots[i].key   = 0;
+        m_slots[i].value = T();
+        --m_size;
+        return true;
+    }
+
+    /**
+     * @brief Call func(StringId, T&) for every entry, in no particular order. func must not insert or erase.
+     */
+    template<class Func>
+    void ForEach(Func&& func) {
+        for (auto&& e : m_slots) {
+            if (e.key) func(StringId::FromValue(e.key), e.value);
+        }
+    }
+    template<class Func>
+    void ForEach(Func&& func) const {
+        for (const auto& e : m_slots) {
+            if (e.key) func(StringId::FromValue(e.key), e.value);
+        }
+    }
+
+    /**
+     * @brief Make room for count entries without growing.
+     */
+    void Reserve(std::size_t count) {
+        std::size_t capacity = MIN_CAPACITY;
+        while (count * 4 > capacity * 3) {
+            capacity *= 2;
+        }
+        if (capacity > m_slots.size()) {
+            Rehash(capacity);
+        }
+    }
+
+    /**
+     * @brief Remove every entry, the capacity is kept.
+     */
+    void Clear() {
+        for (auto&& e : m_slots) {
+            e.key   = 0;
+            e.value = T();
+        }
+        m_size = 0;
+    }
+
+    std::size_t Size() const noexcept {
+        return m_size;
+    }
+    bool IsEmpty() const noexcept {
+        return m_size == 0;
+    }
+    std::size_t GetCapacity() const noexcept {
+        return m_slots.size();
+    }
+
+private:
+
+    static constexpr std::size_t MIN_CAPACITY = 16;
+
+    struct Slot {
+        std::uint64_t key   = 0; // 0 is empty, no StringId has that value
+        T             value = T();
+    };
+
+    std::size_t GetHome(std::uint64_t key) const noexcept {
+        // Fibonacci hashing spreads the high bits of the key over the index
+        return static_cast<std::size_t>((key * 11400714819323198485ull) >> m_shift) & m_mask;
+    }
+
+    std::size_t FindEmpty(std::uint64_t key) const noexcept {
+        std::size_t i = GetHome(key);
+        while (m_slots[i].key) {
+            i = (i + 1) & m_mask;
+        }
+        return i;
+    }
+
+    void Rehash(std::size_t capacity) {
+        std::vector<Slot> slots(capacity);
+        slots.swap(m_slots);
+        m_mask  = capacity - 1;
+        m_shift = 64;
+        for (std::size_t i = capacity; i > 1; i >>= 1) {
+            --m_shift;
+        }
+        for (auto&& e : slots) {
+            if (!e.key) continue;
+            auto& slot = m_slots[FindEmpty(e.key)];
+            slot.key   = e.key;
+            slot.value = std::move(e.value);
+        }
+    }
+
+    std::vector<Slot> m_slots;
+    std::size_t       m_size  = 0;
+    std::size_t       m_mask  = 0;
+    int               m_shift = 64;
+
+};
+
+#endif
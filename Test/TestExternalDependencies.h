@@ -1,13 +1,40 @@
 ﻿#pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ExternalDependencies/Asset/Archive/AssetArchive.h"
+GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_ARCHIVE_ASSETARCHIVE_H_
+#include "ExternalDependencies/Asset/Archive/BlockCodec.h"
+GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_ARCHIVE_BLOCKCODEC_H_
+#include "ExternalDependencies/Asset/IAsset/AssetLoadTelemetry.h"
 #include "ExternalDependencies/Asset/IAsset/IAssetData.h"
 #include "ExternalDependencies/Asset/IAsset/IAssetManager.h"
+GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_IASSET_ASSETLOADTELEMETRY_H_
 GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_IASSET_IASSETDATA_H_
 GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_IASSET_IASSETMANAGER_H_
 #include "ExternalDependencies/Asset/Json/JsonData.h"
 #include "ExternalDependencies/Asset/Json/JsonManager.h"
+#include "ExternalDependencies/Asset/Json/JsonParseCache.h"
+#include "ExternalDependencies/Asset/Json/JsonReflection.h"
+#include "ExternalDependencies/Asset/Json/JsonHolder.h"
+#include "ExternalDependencies/Asset/Json/JsonSchemaCache.h"
 GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_JSON_JSONDATA_H_
 GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_JSON_JSONMANAGER_H_
+GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_JSON_JSONPARSECACHE_H_
+GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_JSON_JSONREFLECTION_H_
+GAME_LIBRARIES_EXTERNALDEPENDENCIES_ASSET_JSON_JSONSCHEMACACHE_H_
 #include "ExternalDependencies/Audio/AudioManager.h"
 #include "ExternalDependencies/Audio/AudioHelper.h"
 GAME_LIBRARIES_EXTERNALDEPENDENCIES_AUDIO_AUDIOMANAGER_H_
@@ -53,11 +80,1084 @@ class TEST_EXTERNALDEPENDENCIES
 public:
 
     static void TEST_JSONDATA() {
-        
+        const std::string path = "json_data_test.json";
+        std::ofstream(path) << R"({"value": 42})";
+
+        JsonData sync_data(path);
+        assert(sync_data.LoadFromFile());
+        assert(sync_data.GetData()->at("value") == 42);
+
+        JsonData async_data(path);
+        async_data.AsyncLoadFromFile().Wait();
+        assert(async_data.IsLoaded() && async_data.IsLoadSuccessed());
+        assert(async_data.GetData()->at("value") == 42);
+
+        // A load that throws fails instead of leaving the asset loading forever
+        struct ThrowingData : IAssetData<int> {
+            ThrowingData(std::string_view path) : IAssetData<int>(path) {}
+            bool Load() override { return false; }
+            bool LoadFromMemory(std::string_view) override { throw std::runtime_error("broken asset"); }
+        };
+        ThrowingData throwing_data(path);
+        throwing_data.AsyncLoadFromFile().Wait();
+        assert(throwing_data.IsLoaded() && !throwing_data.IsLoadSuccessed());
+
+        // Assets of the same file share one mapping
+        MappedFileCache cache;
+        JsonData mapped_data(path);
+        assert(mapped_data.LoadFromMappedFile(cache) && mapped_data.GetData()->at("value") == 42);
+        {
+            auto first  = cache.Open(path);
+            auto second = cache.Open(path);
+            assert(first && first == second && cache.GetOpenCount() == 1);
+            assert(first->GetView() == R"({"value": 42})");
+        }
+        assert(cache.GetOpenCount() == 0);
+        assert(!cache.Open("json_data_missing.json"));
+
+        std::ofstream(path) << "{ broken";
+        JsonData broken_data(path);
+        assert(!broken_data.LoadFromFile() && !broken_data.IsLoadSuccessed());
+        assert(!broken_data.Load());
+        std::remove(path.c_str());
+    }
+
+    static void BENCH_JSONDATA() {
+        for (const std::size_t size : { std::size_t(1) << 10, std::size_t(1) << 20, std::size_t(100) << 20 }) {
+            const std::string path = "json_data_bench.json";
+            {
+                std::ofstream ofs(path);
+                ofs << "[";
+                std::size_t written = 1;
+                for (int i = 0; written + 64 < size; ++i) {
+                    const std::string entry = std::string(i ? "," : "") + R"({"id":)" + std::to_string(i) + R"(,"name":"entry","scale":0.5})";
+                    ofs << entry;
+                    written += entry.size();
+                }
+                ofs << "]";
+            }
+            const int repeat = size < (std::size_t(1) << 20) ? 1000 : size < (std::size_t(100) << 20) ? 10 : 1;
+
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < repeat; ++i) {
+                nlohmann::json json;
+                std::ifstream ifs(path);
+                ifs >> json;
+            }
+            const auto stream_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / repeat;
+
+            start = std::chrono::steady_clock::now();
+            for (int i = 0; i < repeat; ++i) {
+                JsonData json(path);
+                json.LoadFromMappedFile();
+            }
+            const auto mapped_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / repeat;
+
+            std::cout << "json size: " << size << " ifstream: " << stream_us << "us mapped: " << mapped_us << "us" << std::endl;
+            std::remove(path.c_str());
+        }
+    }
+
+    static void TEST_JSONPARSECACHE() {
+        const std::string path = "json_parse_cache_test.json";
+        std::ofstream(path) << R"({"value": 42, "list": [1, 2, 3]})";
+
+        auto& cache = JsonParseCache::GetDefault();
+        cache.SetDirectory("json_parse_cache");
+        const auto hit_count  = cache.GetHitCount();
+        const auto miss_count = cache.GetMissCount();
+
+        JsonData first(path);
+        assert(first.Load() && first.GetData()->at("value") == 42);
+        assert(cache.GetMissCount() == miss_count + 1);
+
+        JsonData second(path);
+        assert(second.Load() && *second.GetData() == *first.GetData());
+        assert(cache.GetHitCount() == hit_count + 1);
+
+        // A changed source invalidates the entry
+        std::ofstream(path) << R"({"value": 43, "list": [1, 2, 3, 4]})";
+        JsonData changed(path);
+        assert(changed.Load() && changed.GetData()->at("value") == 43);
+        assert(cache.GetHitCount() == hit_count + 1);
+
+        // A document is stored under the stamp taken before its file was read, so a rewrite during the parse misses
+        JsonParseCache::SourceStamp stamp;
+        assert(JsonParseCache::GetSourceStamp(path, &stamp));
+        std::ofstream(path) << R"({"value": 44, "list": [1, 2, 3, 4, 5]})";
+        assert(cache.Store(path, stamp, nlohmann::json{ { "value", 43 } }));
+        JsonData rewritten(path);
+        assert(rewritten.Load() && rewritten.GetData()->at("value") == 44);
+        assert(cache.GetHitCount() == hit_count + 1);
+
+        cache.Clear();
+        cache.SetDirectory("");
+        assert(!cache.IsEnabled());
+        std::filesystem::remove_all("json_parse_cache");
+        std::remove(path.c_str());
+    }
+
+    static void BENCH_JSONPARSECACHE() {
+        constexpr int FILES = 20;
+
+        const std::string dir = "json_parse_cache_bench";
+        std::filesystem::create_directories(dir);
+        for (int i = 0; i < FILES; ++i) {
+            nlohmann::json json;
+            for (int j = 0; j < 10000; ++j) {
+                json["values"].push_back({ { "id", j }, { "name", "entry" + std::to_string(j) }, { "scale", j * 0.123456789 }, { "position", { j * 1.1, j * 2.2, j * 3.3 } } });
+            }
+            std::ofstream(dir + "/" + std::to_string(i) + ".json") << json;
+        }
+
+        const auto load_all = [&] {
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < FILES; ++i) {
+                JsonData json(dir + "/" + std::to_string(i) + ".json");
+                json.Load();
+            }
+            return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        };
+
+        auto& cache = JsonParseCache::GetDefault();
+        const auto text_us = load_all();
+        cache.SetDirectory(dir + "/cache");
+        load_all(); // Fill the cache
+        const auto cached_us = load_all();
+        cache.SetDirectory("");
+
+        std::cout << "files: " << FILES << " text: " << text_us << "us cached: " << cached_us << "us" << std::endl;
+        std::filesystem::remove_all(dir);
+    }
+
+    static void TEST_JSONREFLECTION() {
+        struct Vector3 {
+            float x = 0.0f;
+            float y = 0.0f;
+            float z = 0.0f;
+            MACRO_JSON_REFLECT(Vector3, x, y, z)
+        };
+        struct Enemy {
+            std::string          name;
+            int                  hp      = 0;
+            std::uint8_t         level   = 1;
+            bool                 isBoss  = false;
+            Vector3              position;
+            std::vector<Vector3> path;
+            std::vector<int>     drops;
+            MACRO_JSON_REFLECT(Enemy, name, hp, level, isBoss, position, path, drops)
+        };
+
+        const nlohmann::json json = {
+            { "name", "slime" }, { "hp", 30 }, { "isBoss", true },
+            { "position", { { "x", 1 }, { "y", 2.5 }, { "z", -3 } } },
+            { "path", { { { "x", 1 } }, { { "y", 2 } } } },
+            { "drops", { 3, 1, 4 } },
+            { "unknown", { { "nested", { 1, { { "deep", nullptr } } } } } },
+        };
+        static_assert(json_reflection::IsReflectedV<Enemy> && !json_reflection::IsReflectedV<int>);
+
+        const auto check = [](const Enemy& enemy) {
+            assert(enemy.name == "slime" && enemy.hp == 30 && enemy.level == 1 && enemy.isBoss);
+            assert(enemy.position.x == 1.0f && enemy.position.y == 2.5f && enemy.position.z == -3.0f);
+            assert(enemy.path.size() == 2 && enemy.path[0].x == 1.0f && enemy.path[1].y == 2.0f);
+            assert((enemy.drops == std::vector<int>{ 3, 1, 4 }));
+        };
+        Enemy from_text;
+        assert(json_reflection::Read(json.dump(), &from_text));
+        check(from_text);
+        Enemy from_dom;
+        assert(json_reflection::FromJson(json, &from_dom));
+        check(from_dom);
+
+        // Values that do not fit their member fail the read
+        Enemy enemy;
+        assert(!json_reflection::Read(R"({"level": 256})", &enemy));
+        assert(!json_reflection::Read(R"({"hp": "30"})", &enemy));
+        assert(!json_reflection::Read(R"({"position": [1, 2, 3]})", &enemy));
+        assert(!json_reflection::Read(R"({"name": "slime")", &enemy));
+
+        std::vector<Enemy> enemies;
+        assert(json_reflection::Read(nlohmann::json::array({ json, json }).dump(), &enemies) && enemies.size() == 2);
+        check(enemies[1]);
+
+        // JsonHolder reads reflected types from a DOM or straight from text
+        nlohmann::json dom = json;
+        JsonHolder<Enemy> dom_holder(&dom);
+        check(dom_holder.Get());
+        JsonHolder<Enemy> text_holder;
+        assert(text_holder.LoadFromMemory(json.dump()));
+        check(text_holder.Get());
+    }
+
+    static void TEST_JSONSCHEMACACHE() {
+        const std::string dir = "json_schema_cache_test";
+        std::filesystem::create_directories(dir);
+        auto& cache = JsonParseCache::GetDefault();
+        cache.SetDirectory(dir + "/cache");
+
+        // Equal schemas hash equally whatever their key order, never to 0 ("not validated")
+        const auto schema_hash = JsonSchemaCache::Hash(nlohmann::json::parse(R"({"type": "object", "required": ["value"]})"));
+        assert(schema_hash != 0 && schema_hash == JsonSchemaCache::Hash(nlohmann::json::parse(R"({"required": ["value"], "type": "object"})")));
+        assert(schema_hash != JsonSchemaCache::Hash(nlohmann::json{ { "type", "array" } }));
+
+        // The schema a document passed round-trips through the parse cache, until the source changes
+        {
+            const std::string path = dir + "/plain.json";
+            const nlohmann::json json = { { "value", 1 } };
+            std::ofstream(path) << json;
+            JsonParseCache::SourceStamp stamp;
+            assert(JsonParseCache::GetSourceStamp(path, &stamp));
+            nlohmann::json cached;
+            std::uint64_t validated_schema_hash = 0;
+            assert(cache.Store(path, stamp, json, schema_hash));
+            assert(cache.Load(path, &cached, &validated_schema_hash) && cached == json && validated_schema_hash == schema_hash);
+            assert(cache.Store(path, stamp, json));
+            assert(cache.Load(path, &cached, &validated_schema_hash) && validated_schema_hash == 0);
+            std::ofstream(path) << nlohmann::json{ { "value", 22 } };
+            assert(!cache.Load(path, &cached, &validated_schema_hash));
+        }
+
+#ifdef ENABLE_JSON_SCHEMA_VALIDATOR
+        const nlohmann::json schema_json = { { "type", "object" }, { "required", { "value" } } };
+        std::ofstream(dir + "/item.schema.json") << schema_json;
+        nlohmann::json manifest;
+        manifest["schema"].push_back({ { "name", "item" }, { "path", dir + "/item.schema.json" } });
+        for (int i = 0; i < 20; ++i) {
+            const std::string path = dir + "/" + std::to_string(i) + ".json";
+            std::ofstream(path) << nlohmann::json{ { "schema", "item" }, { "value", i } };
+            manifest["list"].push_back({ { "name", "asset" + std::to_string(i) }, { "path", path } });
+        }
+        std::ofstream(dir + "/manifest.json") << manifest;
+
+        const auto schema = JsonSchemaCache::GetDefault().Get(schema_json, dir + "/item.schema.json");
+
+        // Compiled on first use, validated on pool threads
+        JobSystem job_system(2);
+        JsonManager::BulkLoadOptions options;
+        options.pJobSystem = &job_system;
+        {
+            JsonManager manager;
+            manager.Register(dir + "/manifest.json");
+            assert(!schema->IsCompiled());
+            manager.Load(options);
+            assert(manager.GetLoadProgress().failedCount == 0);
+            assert(schema->IsCompiled() && schema->GetValidationCount() == 20);
+        }
+
+        // Unchanged files passed the same schema when they were cached
+        {
+            JsonManager manager;
+            manager.Register(dir + "/manifest.json");
+            manager.Load(options);
+            assert(manager["asset7"].at("value") == 7);
+            assert(schema->GetValidationCount() == 20);
+        }
+
+        // Changed files are validated again
+        std::ofstream(dir + "/3.json") << nlohmann::json{ { "schema", "item" }, { "value", 3000 } };
+        {
+            JsonManager manager;
+            manager.Register(dir + "/manifest.json");
+            manager.Load(options);
+            assert(manager["asset3"].at("value") == 3000);
+            assert(schema->GetValidationCount() == 21);
+
+            auto schemas = std::make_shared<JsonData::JsonSchemas>(JsonData::JsonSchemas{ { "item", schema } });
+            JsonData invalid("invalid.json", schemas);
+            assert(!invalid.LoadFromMemory(R"({"schema": "item"})"));
+        }
+#endif
+
+        cache.SetDirectory("");
+        std::filesystem::remove_all(dir);
     }
 
     static void TEST_JSONMANAGER() {
+        const std::string dir = "json_manager_test";
+        std::filesystem::create_directories(dir);
+        nlohmann::json manifest;
+        for (int i = 0; i < 50; ++i) {
+            const std::string path = dir + "/" + std::to_string(i) + ".json";
+            std::ofstream(path) << nlohmann::json{ { "value", i } };
+            manifest["list"].push_back({ { "name", "asset" + std::to_string(i) }, { "path", path } });
+        }
+        manifest["list"][37]["priority"] = 10; // Title screen
+        std::ofstream(dir + "/manifest.json") << manifest;
+
+        JsonManager manager;
+        manager.Register(dir + "/manifest.json");
+        assert(manager.GetPriority("asset37") == 10 && manager.GetPriority("asset0") == 0);
+
+        JobSystem job_system(2);
+        JsonManager::BulkLoadOptions options;
+        options.pJobSystem      = &job_system;
+        options.maxConcurrentIO = 1;
+        bool is_priority_first = false;
+        std::size_t progress_calls = 0;
+        options.onProgress = [&](const JsonManager::LoadProgress& progress) {
+            if (progress.loadedCount == 1) {
+                is_priority_first = manager.IsLoaded("asset37");
+            }
+            ++progress_calls;
+        };
+        manager.Load(options);
+        assert(is_priority_first && progress_calls == 50);
+        assert(manager.GetLoadProgress().IsDone() && manager.GetLoadProgress().failedCount == 0);
+        for (int i = 0; i < 50; ++i) {
+            assert(manager["asset" + std::to_string(i)].at("value") == i);
+        }
+
+        // Concurrent loaders
+        options.maxConcurrentIO = 8;
+        options.onProgress      = nullptr;
+        manager.AsyncLoadAll(options).Wait();
+        assert(manager.GetLoadProgress().loadedCount == 50);
+        std::filesystem::remove_all(dir);
+    }
+
+    static void TEST_ASSETDEPENDENCIES() {
+        const std::string dir = "asset_dependencies_test";
+        std::filesystem::create_directories(dir);
+        nlohmann::json manifest;
+        for (const auto& e : { "level", "tileset", "enemies", "common", "unrelated" }) {
+            const std::string path = dir + "/" + e + ".json";
+            std::ofstream(path) << nlohmann::json{ { "name", e } };
+            manifest["list"].push_back({ { "name", e }, { "path", path } });
+        }
+        manifest["list"][0]["dependencies"] = { "tileset", "enemies" };
+        manifest["list"][0]["priority"]     = 5;
+        manifest["list"][1]["dependencies"] = { "common" };
+        manifest["list"][2]["dependencies"] = { "common" };
+        std::ofstream(dir + "/manifest.json") << manifest;
+
+        JsonManager manager;
+        manager.Register(dir + "/manifest.json");
+        assert(manager.GetDependencies("level").size() == 2 && manager.GetDependencies("common").empty());
+
+        const auto closure = manager.GetDependencyClosure("level");
+        assert(closure.size() == 4 && closure.front() == "common" && closure.back() == "level");
+
+        JobSystem job_system(2);
+        assert(!manager.IsReady("level"));
+        assert(manager.LoadWithDependencies("level", false, job_system));
+        assert(manager.IsReady("level") && manager.IsReady("common"));
+        assert(!manager.IsLoaded("unrelated"));
+
+        // The closure and its graph are reused until dependencies change
+        assert(manager.LoadWithDependencies("level", true, job_system));
+        manager.AddDependency("common", "unrelated");
+        assert(!manager.IsReady("level") && manager.GetDependencyClosure("level").size() == 5);
+        assert(manager.LoadWithDependencies("level", false, job_system) && manager.IsLoaded("unrelated"));
+
+        // Closures that share a dependency load it once, even when they run at the same time
+        JsonManager shared_manager;
+        shared_manager.Register(dir + "/manifest.json");
+        auto tileset = shared_manager.AsyncLoadWithDependencies("tileset", false, job_system);
+        auto enemies = shared_manager.AsyncLoadWithDependencies("enemies", false, job_system);
+        tileset.Wait();
+        enemies.Wait();
+        assert(shared_manager.IsReady("tileset") && shared_manager.IsReady("enemies"));
+        const auto records = shared_manager.GetLoadTelemetry().GetRecords();
+        assert(std::count_if(records.begin(), records.end(), [](const AssetLoadRecord& e) { return e.name == "common"; }) == 1);
+
+        // Dependencies are started before their dependents in bulk loads too
+        JsonManager bulk_manager;
+        bulk_manager.Register(dir + "/manifest.json");
+        JsonManager::BulkLoadOptions options;
+        options.pJobSystem      = &job_system;
+        options.maxConcurrentIO = 1;
+        std::vector<bool> is_common_first;
+        options.onProgress = [&](const JsonManager::LoadProgress& progress) {
+            if (progress.loadedCount == 1) {
+                is_common_first.push_back(bulk_manager.IsLoaded("common"));
+            }
+        };
+        bulk_manager.Load(options);
+        assert(is_common_first.size() == 1 && is_common_first.front());
+        assert(bulk_manager.IsReady("level"));
+
+        // A missing dependency is reported once, assets sharing its path still push their priority down
+        nlohmann::json broken_manifest;
+        for (const auto& e : { "shared", "other", "z_user", "a_broken0", "a_broken1", "a_broken2", "a_broken3" }) {
+            const std::string path = dir + "/" + e + ".json";
+            std::ofstream(path) << nlohmann::json{ { "name", e } };
+            broken_manifest["list"].push_back({ { "name", e }, { "path", path }, { "dependencies", { "shared" } } });
+        }
+        broken_manifest["list"][0]["dependencies"] = { "missing" };
+        broken_manifest["list"][1]["dependencies"] = nlohmann::json::array();
+        broken_manifest["list"][1]["priority"]     = 5;
+        broken_manifest["list"][2]["priority"]     = 10;
+        std::ofstream(dir + "/broken_manifest.json") << broken_manifest;
+
+        JsonManager broken_manager;
+        broken_manager.Register(dir + "/broken_manifest.json");
+        std::vector<bool> is_shared_first;
+        options.onProgress = [&](const JsonManager::LoadProgress& progress) {
+            if (progress.loadedCount == 1) {
+                is_shared_first.push_back(broken_manager.IsLoaded("shared"));
+            }
+        };
+        broken_manager.Load(options);
+        assert(is_shared_first.size() == 1 && is_shared_first.front());
+        std::filesystem::remove_all(dir);
+    }
+
+    static void TEST_ASSETHANDLE() {
+        const std::string dir = "asset_handle_test";
+        std::filesystem::create_directories(dir);
+        nlohmann::json manifest;
+        for (int i = 0; i < 10; ++i) {
+            const std::string path = dir + "/" + std::to_string(i) + ".json";
+            std::ofstream(path) << nlohmann::json{ { "value", i }, { "padding", std::string(1000, 'x') } };
+            manifest["list"].push_back({ { "name", "asset" + std::to_string(i) }, { "path", path } });
+        }
+        manifest["list"].push_back({ { "name", "late" }, { "path", dir + "/late.json" } });
+        std::ofstream(dir + "/manifest.json") << manifest;
+        const auto asset_size = std::filesystem::file_size(dir + "/0.json");
+
+        JsonManager manager;
+        manager.Register(dir + "/manifest.json");
+        manager.SetMemoryBudget(asset_size * 3);
+
+        auto pinned = manager.Acquire("asset0");
+        assert(pinned.IsValid() && pinned->at("value") == 0);
+        auto copy = pinned;
+        assert(manager.GetReferenceCount("asset0") == 2);
+
+        for (int i = 1; i < 10; ++i) {
+            auto handle = manager.Acquire("asset" + std::to_string(i));
+            assert((*handle).at("value") == i);
+        }
+        // Least recently released assets were evicted, the referenced one stays
+        assert(manager.GetResidentBytes() <= asset_size * 3);
+        assert(!manager.IsLoaded("asset1") && manager.IsLoaded("asset9"));
+        assert(manager.IsLoaded("asset0"));
+
+        // Evicted assets load again on access
+        assert(manager.Acquire("asset1")->at("value") == 1);
+
+        copy.Reset();
+        pinned = {};
+        assert(manager.GetReferenceCount("asset0") == 0);
+        manager.Trim();
+        assert(manager.GetResidentBytes() == 0 && !manager.IsLoaded("asset0"));
+
+        // A failed load is not resident and is tried again on the next access
+        auto late = manager.Acquire("late");
+        late.Get();
+        assert(manager.GetResidentBytes() == 0);
+        std::ofstream(dir + "/late.json") << nlohmann::json{ { "value", 10 } };
+        assert(late->at("value") == 10 && manager.GetResidentBytes() == std::filesystem::file_size(dir + "/late.json"));
+        late.Reset();
+        manager.Trim();
+
+        auto stale = manager.Acquire("asset2");
+        manager.Release();
+        assert(!stale.IsValid());
+        std::filesystem::remove_all(dir);
+    }
+
+    static void TEST_ASSETTELEMETRY() {
+        AssetLoadHistogram histogram;
+        for (std::uint64_t e : { 0, 1, 3, 100, 1000 }) {
+            histogram.Add(e);
+        }
+        assert(histogram.GetCount() == 5 && histogram.GetSum() == 1104 && histogram.GetMax() == 1000);
+        assert(histogram.GetBuckets()[0] == 1 && histogram.GetBuckets()[AssetLoadHistogram::GetBucket(100)] == 1);
+        assert(histogram.GetPercentile(50) == 3 && histogram.GetPercentile(100) == 1000);
+
+        const std::string dir = "asset_telemetry_test";
+        std::filesystem::create_directories(dir);
+        nlohmann::json manifest;
+        for (int i = 0; i < 8; ++i) {
+            const std::string path = dir + "/" + std::to_string(i) + ".json";
+            std::ofstream(path) << nlohmann::json{ { "value", i }, { "padding", std::string(1000 * (i + 1), 'x') } };
+            manifest["list"].push_back({ { "name", "asset\"" + std::to_string(i) }, { "path", path } });
+        }
+        std::ofstream(dir + "/manifest.json") << manifest;
+
+        JsonManager manager;
+        manager.Register(dir + "/manifest.json");
+        typename JsonManager::BulkLoadOptions options;
+        options.maxConcurrentIO = 2;
+        manager.Load(options);
+
+        // Every load is recorded once, with the bytes it read and phases in order
+        auto& telemetry = manager.GetLoadTelemetry();
+        const auto records = telemetry.GetRecords();
+        assert(records.size() == 8 && telemetry.GetFailedCount() == 0);
+        for (const auto& e : records) {
+            assert(e.isSucceeded && e.thread);
+            assert(e.bytes == std::filesystem::file_size(manager.GetFilePath(e.name)));
+            assert(e.requestNS <= e.ioBeginNS && e.ioBeginNS <= e.ioEndNS && e.ioEndNS <= e.parseBeginNS && e.parseBeginNS <= e.endNS);
+        }
+        assert(telemetry.GetTotalHistogram().GetCount() == 8 && telemetry.GetBytesHistogram().GetMax() == std::filesystem::file_size(dir + "/7.json"));
+        assert(telemetry.GetSlowest(1, &AssetLoadRecord::bytes).front().name == "asset\"7");
+
+        // Loads outside of bulk loads are recorded too
+        auto asset = std::make_unique<JsonData>(dir + "/0.json");
+        auto own_telemetry = std::make_shared<AssetLoadTelemetry>();
+        asset->SetLoadTelemetry(own_telemetry, "single");
+        asset->AsyncLoadFromFile().Wait();
+        assert(asset->LoadFromMappedFile());
+        assert(own_telemetry->GetCount() == 2 && own_telemetry->GetRecords().front().name == "single");
+
+        // Only the latest records are kept, the histograms count every load
+        own_telemetry->SetRecordCapacity(3);
+        for (int i = 0; i < 5; ++i) {
+            asset->SetLoadTelemetry(own_telemetry, "single" + std::to_string(i));
+            assert(asset->LoadFromMappedFile());
+        }
+        const auto kept = own_telemetry->GetRecords();
+        assert(kept.size() == 3 && kept.front().name == "single2" && kept.back().name == "single4");
+        assert(own_telemetry->GetTotalHistogram().GetCount() == 7);
+
+        std::ostringstream json, csv, trace;
+        telemetry.WriteJson(json);
+        telemetry.WriteCsv(csv);
+        telemetry.WriteChromeTrace(trace);
+        const auto exported = nlohmann::json::parse(json.str());
+        assert(exported.at("count") == 8 && exported.at("histograms").at("parseNS").at("count") == 8);
+        assert(exported.at("loads").size() == 8);
+        const auto csv_text = csv.str();
+        assert(std::count(csv_text.begin(), csv_text.end(), '\n') == 9);
+        assert(csv_text.find("\"asset\"\"0\"") != std::string::npos);
+        const auto events = nlohmann::json::parse(trace.str()).at("traceEvents");
+        assert(std::any_of(events.begin(), events.end(), [](const nlohmann::json& e) { return e.at("ph") == "X" && e.at("cat") == "parse"; }));
+        assert(telemetry.ExportChromeTrace(dir + "/trace.json") && telemetry.ExportCsv(dir + "/loads.csv"));
+
+        telemetry.Clear();
+        telemetry.SetEnabled(false);
+        manager.Load("asset\"0");
+        assert(telemetry.GetCount() == 0);
+        manager.Release();
+        std::filesystem::remove_all(dir);
+    }
+
+    static void TEST_ASSETFINALIZATION() {
+        const std::string dir = "asset_finalization_test";
+        std::filesystem::create_directories(dir);
+        nlohmann::json manifest;
+        for (int i = 0; i < 20; ++i) {
+            const std::string path = dir + "/" + std::to_string(i) + ".json";
+            std::ofstream(path) << nlohmann::json{ { "value", i } };
+            manifest["list"].push_back({ { "name", "asset" + std::to_string(i) }, { "path", path }, { "priority", i % 4 } });
+        }
+        std::ofstream(dir + "/manifest.json") << manifest;
+
+        JsonManager manager;
+        manager.Register(dir + "/manifest.json");
+        std::vector<std::string> finalized;
+        manager.SetFinalizer([&](const std::string& name, JsonData& asset) {
+            assert(asset.IsLoaded() && asset.IsLoadSuccessed());
+            finalized.push_back(name);
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        });
+
+        // Twenty assets landing at once are spread over several frames
+        manager.Load(typename JsonManager::BulkLoadOptions{});
+        assert(manager.GetFinalizationQueueSize() == 20 && !manager.IsFinalized("asset0"));
+        std::size_t frames = 0;
+        while (manager.GetFinalizationQueueSize()) {
+            const auto start = std::chrono::steady_clock::now();
+            const auto count = manager.UpdateFinalization(std::chrono::microseconds(5000));
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            assert(count >= 1 && count < 20);
+            // Over budget by at most one finalizer, with slack for the scheduler
+            assert(elapsed < std::chrono::milliseconds(5 + 2 + 20));
+            ++frames;
+        }
+        assert(frames > 1 && finalized.size() == 20);
+        for (std::size_t i = 1; i < finalized.size(); ++i) {
+            assert(manager.GetPriority(finalized[i - 1]) >= manager.GetPriority(finalized[i]));
+        }
+        assert(manager.IsFinalized("asset0") && manager.IsFinalized("asset19"));
+
+        // A reload is finalized again, once however often it loaded in between. Failed loads are not
+        finalized.clear();
+        for (int i = 0; i < 10; ++i) {
+            manager.Load("asset3");
+        }
+        assert(manager.GetFinalizationQueueSize() == 1);
+        assert(manager.UpdateFinalization(std::chrono::microseconds(0)) == 1 && finalized == std::vector<std::string>{ "asset3" });
+        std::filesystem::remove(dir + "/5.json");
+        manager.GetAsset("asset5")->Load();
+        assert(manager.UpdateFinalization(std::chrono::microseconds(5000)) == 0 && !manager.IsFinalized("asset5"));
+        assert(manager.GetFinalizationQueueSize() == 0);
+
+        manager.Release();
+        std::filesystem::remove_all(dir);
+    }
+
+    static void TEST_ASSETREQUEST() {
+        const std::string dir = "asset_request_test";
+        std::filesystem::create_directories(dir);
+        nlohmann::json manifest;
+        for (int i = 0; i < 6; ++i) {
+            const std::string path = dir + "/" + std::to_string(i) + ".json";
+            std::ofstream(path) << nlohmann::json{ { "value", i } };
+            manifest["list"].push_back({ { "name", "asset" + std::to_string(i) }, { "path", path } });
+        }
+        std::ofstream(dir + "/manifest.json") << manifest;
+
+        // The only worker is held, so requests stay queued until the gate opens
+        JobSystem job_system(1);
+        std::atomic<bool> is_open = false;
+        const auto close_gate = [&] {
+            is_open = false;
+            job_system.Submit([&] {
+                while (!is_open) std::this_thread::yield();
+            });
+        };
+        close_gate();
+
+        using Status = JsonManager::RequestStatus;
+        JsonManager manager;
+        manager.Register(dir + "/manifest.json");
+        manager.SetRequestOptions({ &job_system, 1 });
+
+        // Ten callers asking for the same asset share one request
+        std::vector<JsonManager::AssetRequest> shared;
+        for (int i = 0; i < 10; ++i) {
+            shared.push_back(manager.Request("asset0", 0));
+        }
+        auto low       = manager.Request("asset1", 1);
+        auto high      = manager.Request("asset2", 5);
+        auto raised    = manager.Request("asset3", 0);
+        auto cancelled = manager.Request("asset4", 10);
+        auto kept      = manager.Request("asset5", 2);
+        auto kept_too  = manager.Request("asset5", 2);
+        assert(manager.GetQueuedRequestCount() == 6 && shared[0].GetStatus() == Status::QUEUED);
+        assert(!manager.Request("missing").IsValid());
+
+        assert(raised.RaisePriority(8) && !raised.RaisePriority(3));
+        assert(cancelled.Cancel() && !cancelled.Cancel());
+        assert(cancelled.GetStatus() == Status::CANCELLED && cancelled.IsReady() && !cancelled.IsLoadSuccessed());
+        // The other callers still want these
+        assert(kept.Cancel() && kept_too.GetStatus() == Status::QUEUED);
+        for (int i = 1; i < 10; ++i) {
+            assert(shared[i].Cancel());
+        }
+        assert(manager.GetQueuedRequestCount() == 5);
+
+        is_open = true;
+        for (auto* e : { &shared[0], &low, &high, &raised, &kept_too }) {
+            e->Wait();
+            assert(e->GetStatus() == Status::LOADED && e->IsLoadSuccessed());
+        }
+        assert(shared[9].IsLoadSuccessed() && !manager.IsLoaded("asset4"));
+
+        // One read per asset, highest priority first
+        std::vector<std::string> order;
+        for (const auto& e : manager.GetLoadTelemetry().GetRecords()) {
+            order.push_back(e.name);
+        }
+        assert((order == std::vector<std::string>{ "asset3", "asset2", "asset5", "asset1", "asset0" }));
+
+        // Loaded assets are not read again
+        auto again = manager.Request("asset2");
+        assert(again.GetStatus() == Status::LOADED && again.IsLoadSuccessed());
+        assert(manager.GetLoadTelemetry().GetCount() == 5);
+
+        // Leaving a level cancels whatever is still queued, however many callers wait on it
+        close_gate();
+        auto left = manager.Request("asset4");
+        auto left_too = manager.Request("asset4");
+        assert(manager.CancelAllRequests() == 1 && manager.GetQueuedRequestCount() == 0);
+        assert(left.GetStatus() == Status::CANCELLED && left_too.IsReady() && !left_too.Cancel());
+        is_open = true;
+
+        // Requests share the read with dependency closures loading the asset at the same time
+        close_gate();
+        auto joined = manager.Request("asset4");
+        JobSystem closure_job_system(2);
+        auto closure = manager.AsyncLoadWithDependencies("asset4", false, closure_job_system);
+        is_open = true;
+        joined.Wait();
+        closure.Wait();
+        assert(joined.IsLoadSuccessed() && manager.GetLoadTelemetry().GetCount() == 6);
+
+        // Bulk loads started while an asset is loading leave the timing of that load alone
+        const auto record_count = manager.GetLoadTelemetry().GetCount();
+        std::thread loader([&] {
+            for (int i = 0; i < 20; ++i) {
+                manager.Load("asset0");
+            }
+        });
+        for (int i = 0; i < 5; ++i) {
+            manager.Load(JsonManager::BulkLoadOptions{ &closure_job_system, 2 });
+        }
+        loader.join();
+        const auto loaded_count = manager.GetLoadTelemetry().GetCount();
+        assert(loaded_count > record_count && loaded_count <= record_count + 20 + 5 * 6);
+
+        manager.Release();
+        assert(!manager.GetAssets().size() && manager.GetLoadTelemetry().GetCount() == loaded_count);
+        std::filesystem::remove_all(dir);
+    }
+
+    static void TEST_ASSETHOTRELOAD() {
+        const std::string dir = "asset_hot_reload_test";
+        std::filesystem::create_directories(dir);
+        nlohmann::json manifest;
+        for (int i = 0; i < 2; ++i) {
+            const std::string path = dir + "/" + std::to_string(i) + ".json";
+            std::ofstream(path) << nlohmann::json{ { "value", i } };
+            manifest["list"].push_back({ { "name", "asset" + std::to_string(i) }, { "path", path } });
+        }
+        std::ofstream(dir + "/manifest.json") << manifest;
+
+        JsonManager manager;
+        manager.Register(dir + "/manifest.json");
+        manager.Load();
+        assert(manager.IsLoadedOnlyOnce("asset0"));
+        manager.EnableHotReload(std::chrono::milliseconds(10));
+        assert(manager.IsHotReloadEnabled());
+
+        const auto wait_reload = [&](std::chrono::milliseconds timeout) {
+            const auto start = std::chrono::steady_clock::now();
+            std::size_t count = 0;
+            while (!count && std::chrono::steady_clock::now() - start < timeout) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                count = manager.UpdateHotReload();
+            }
+            return count;
+        };
+
+        // Readers keep the old data until the swap, the memory of handles follows the new size
+        auto handle = manager.Acquire("asset0");
+        assert(handle->at("value") == 0 && manager.GetResidentBytes() == std::filesystem::file_size(dir + "/0.json"));
+        std::ofstream(dir + "/0.json") << nlohmann::json{ { "value", 100 }, { "padding", std::string(1000, 'x') } };
+        assert(manager["asset0"].at("value") == 0);
+        assert(wait_reload(std::chrono::milliseconds(5000)) == 1);
+        assert(manager["asset0"].at("value") == 100 && manager["asset1"].at("value") == 1);
+        assert(manager.GetResidentBytes() == std::filesystem::file_size(dir + "/0.json"));
+        assert(manager.IsLoadedOnlyOnce("asset0") && !manager.IsLoadedOnlyOnce("asset0"));
+
+        // A broken save keeps the previous data
+        std::ofstream(dir + "/0.json") << "{ broken";
+        assert(wait_reload(std::chrono::milliseconds(300)) == 0);
+        assert(manager["asset0"].at("value") == 100);
+
+        manager.DisableHotReload();
+        assert(!manager.IsHotReloadEnabled());
+
+        // Assets read from an archive ignore changes of their loose files
+        std::ofstream(dir + "/0.json") << nlohmann::json{ { "value", 0 } };
+        assert(AssetArchive::Pack(dir + "/manifest.json", dir + "/assets.pak"));
+        JsonManager archived;
+        assert(archived.RegisterArchive(dir + "/assets.pak"));
+        archived.Load();
+        archived.EnableHotReload(std::chrono::milliseconds(10));
+        std::ofstream(dir + "/1.json") << nlohmann::json{ { "value", 101 } };
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        assert(archived.UpdateHotReload() == 0 && archived["asset1"].at("value") == 1);
+        archived.Release();
+        std::filesystem::remove_all(dir);
+    }
+
+    static void TEST_ASSETARCHIVE() {
+        const std::string dir = "asset_archive_test";
+        std::filesystem::create_directories(dir);
+        nlohmann::json manifest;
+        for (int i = 0; i < 100; ++i) {
+            const std::string path = dir + "/" + std::to_string(i) + ".json";
+            std::ofstream(path) << nlohmann::json{ { "value", i }, { "padding", std::string(i, 'x') } };
+            manifest["list"].push_back({ { "name", "asset" + std::to_string(i) }, { "path", path } });
+        }
+        manifest["list"][1]["dependencies"] = { "asset0" };
+        std::ofstream(dir + "/manifest.json") << manifest;
+
+        const std::string archive_path = dir + "/assets.pak";
+        assert(AssetArchive::Pack(dir + "/manifest.json", archive_path));
+
+        AssetArchive archive(archive_path);
+        assert(archive.IsOpened() && archive.GetEntryCount() == 100);
+        for (int i = 0; i < 100; ++i) {
+            AssetArchive::Entry entry;
+            assert(archive.Find("asset" + std::to_string(i), &entry));
+            assert(entry.path == dir + "/" + std::to_string(i) + ".json");
+            assert(reinterpret_cast<std::uintptr_t>(entry.data.data()) % 16 == 0);
+            std::string buffer;
+            std::string_view bytes;
+            assert(AssetArchive::GetBytes(entry, &buffer, &bytes));
+            assert(bytes.size() == entry.size);
+            assert(nlohmann::json::parse(bytes).at("value") == i);
+        }
+        assert(!archive.Contains("missing"));
+
+        // Stored entries are spans of the mapping
+        AssetArchive::PackOptions store_options;
+        store_options.codec = StoreBlockCodec::ID;
+        assert(AssetArchive::Pack(dir + "/manifest.json", dir + "/stored.pak", store_options));
+        {
+            AssetArchive stored(dir + "/stored.pak");
+            AssetArchive::Entry entry;
+            assert(stored.Find("asset99", &entry) && !entry.IsCompressed());
+            std::string buffer;
+            std::string_view bytes;
+            assert(AssetArchive::GetBytes(entry, &buffer, &bytes) && bytes.data() == entry.data.data() && buffer.empty());
+        }
+
+        // Large entries are split in blocks that decompress alone or in parallel
+        {
+            std::string large;
+            for (int i = 0; large.size() < 300 * 1024; ++i) {
+                large += "{\"id\": " + std::to_string(i) + ", \"name\": \"entry" + std::to_string(i % 97) + "\"},\n";
+            }
+            std::ofstream(dir + "/large.bin", std::ios::binary) << large;
+            std::ofstream(dir + "/large.json") << nlohmann::json{ { "list", { { { "name", "large" }, { "path", dir + "/large.bin" } } } } };
+            AssetArchive::PackOptions options;
+            options.blockSize = 16 * 1024;
+            assert(AssetArchive::Pack(dir + "/large.json", dir + "/large.pak", options));
+
+            AssetArchive large_archive(dir + "/large.pak");
+            AssetArchive::Entry entry;
+            assert(large_archive.Find("large", &entry) && entry.IsCompressed());
+            assert(entry.size == large.size() && entry.data.size() < large.size() / 2);
+            assert(entry.blockCount == (large.size() + options.blockSize - 1) / options.blockSize);
+
+            std::string serial(large.size(), '\0');
+            std::string parallel(large.size(), '\0');
+            assert(AssetArchive::Read(entry, serial.data()) && serial == large);
+            assert(AssetArchive::Read(entry, parallel.data(), &JobSystem::GetDefault()) && parallel == large);
+
+            std::string streamed;
+            std::vector<char> block(options.blockSize);
+            for (std::size_t i = 0; i < entry.blockCount; ++i) {
+                assert(AssetArchive::ReadBlock(entry, i, block.data()));
+                streamed.append(block.data(), AssetArchive::GetBlockDataSize(entry, i));
+            }
+            assert(streamed == large);
+        }
+
+        // Loose files are no longer needed
+        for (int i = 0; i < 100; ++i) {
+            std::remove((dir + "/" + std::to_string(i) + ".json").c_str());
+        }
+        JsonManager manager;
+        assert(manager.RegisterArchive(archive_path));
+        assert(manager.GetDependencies("asset1").size() == 1);
+        manager.Load();
+        for (int i = 0; i < 100; ++i) {
+            assert(manager["asset" + std::to_string(i)].at("value") == i);
+        }
+
+        std::ofstream(dir + "/broken.pak") << "not an archive";
+        assert(!AssetArchive(dir + "/broken.pak").IsOpened());
+        manager.Release();
+        std::filesystem::remove_all(dir);
+    }
+
+    static void TEST_ASSETREGISTER() {
+        const std::string dir = "asset_register_test";
+        std::filesystem::create_directories(dir);
+        std::ofstream(dir + "/forest.json") << nlohmann::json{ { "value", 1 } };
+        std::ofstream(dir + "/desert.json") << nlohmann::json{ { "value", 2 } };
+        std::ofstream(dir + "/aggregate.json") << nlohmann::json{
+            { "levels", {
+                { "forest", { { "a/b", { { "path", dir + "/forest.json" }, { "priority", 3 } } } } },
+                { "desert", { { "a/b", { { "path", dir + "/desert.json" } } } } },
+            } },
+        };
+
+        const auto make_jsons = [&] {
+            std::unordered_map<std::string, std::unique_ptr<JsonData>> jsons;
+            jsons.emplace("forest", std::make_unique<JsonData>(dir + "/aggregate.json"));
+            jsons.emplace("desert", std::make_unique<JsonData>(dir + "/aggregate.json"));
+            for (auto&& e : jsons) {
+                e.second->Load();
+            }
+            return jsons;
+        };
+
+        // Keys
+        {
+            JsonManager manager;
+            manager.Register(make_jsons(), { "levels", "forest", "a/b" });
+            manager.Load();
+            assert(manager["forest"].at("value") == 1 && manager["desert"].at("value") == 1);
+            assert(manager.GetPriority("forest") == 3);
+        }
+        // JSON pointer, "/" in keys is escaped as "~1"
+        {
+            JsonManager manager;
+            auto jsons = make_jsons();
+            manager.Register(jsons, nlohmann::json::json_pointer("/levels/desert/a~1b"));
+            manager.Load();
+            assert(manager["forest"].at("value") == 2 && manager["desert"].at("value") == 2);
+
+            JsonManager missing_manager;
+            missing_manager.Register(jsons, nlohmann::json::json_pointer("/levels/missing"));
+            assert(missing_manager.GetAssets().empty());
+        }
+        std::filesystem::remove_all(dir);
+    }
+
+    static void BENCH_ASSETARCHIVE() {
+        constexpr std::size_t SIZE = 64 * 1024 * 1024;
+
+        const std::string dir = "asset_archive_bench";
+        std::filesystem::create_directories(dir);
+        {
+            std::ofstream ofs(dir + "/data.json");
+            ofs << "[";
+            for (std::size_t i = 0, size = 0; size < SIZE; ++i) {
+                const auto line = nlohmann::json{ { "id", i }, { "name", "entry" + std::to_string(i % 1000) }, { "position", { i * 0.25, i * 0.5, i * 0.75 } } }.dump() + ",\n";
+                ofs << line;
+                size += line.size();
+            }
+            ofs << "0]";
+        }
+        std::ofstream(dir + "/manifest.json") << nlohmann::json{ { "list", { { { "name", "data" }, { "path", dir + "/data.json" } } } } };
+
+        AssetArchive::PackOptions store_options;
+        store_options.codec = StoreBlockCodec::ID;
+        AssetArchive::Pack(dir + "/manifest.json", dir + "/stored.pak", store_options);
+        AssetArchive::Pack(dir + "/manifest.json", dir + "/compressed.pak");
+
+        AssetArchive stored(dir + "/stored.pak");
+        AssetArchive compressed(dir + "/compressed.pak");
+        AssetArchive::Entry stored_entry;
+        AssetArchive::Entry compressed_entry;
+        stored.Find("data", &stored_entry);
+        compressed.Find("data", &compressed_entry);
+        std::string buffer(static_cast<std::size_t>(compressed_entry.size), '\0');
+
+        const auto measure = [&](auto&& func) {
+            const auto start = std::chrono::steady_clock::now();
+            func();
+            const auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+            return static_cast<double>(compressed_entry.size) / (std::max<long long>)(us, 1);
+        };
+        const auto raw_mbs      = measure([&] { AssetArchive::Read(stored_entry, buffer.data()); });
+        const auto serial_mbs   = measure([&] { AssetArchive::Read(compressed_entry, buffer.data()); });
+        const auto parallel_mbs = measure([&] { AssetArchive::Read(compressed_entry, buffer.data(), &JobSystem::GetDefault()); });
+
+        std::cout << "size: " << compressed_entry.size / (1024 * 1024) << "MB ratio: " << static_cast<double>(compressed_entry.data.size()) / compressed_entry.size
+                  << " workers: " << JobSystem::GetDefault().GetWorkerCount() << " raw: " << raw_mbs << "MB/s serial: " << serial_mbs
+                  << "MB/s parallel: " << parallel_mbs << "MB/s" << std::endl;
+        std::filesystem::remove_all(dir);
+    }
+
+    static void BENCH_ASSETREGISTER() {
+        constexpr std::size_t SIZE = 50 * 1024 * 1024;
+
+        const std::string dir = "asset_register_bench";
+        std::filesystem::create_directories(dir);
+        std::ofstream(dir + "/asset.json") << nlohmann::json{ { "value", 1 } };
+        {
+            nlohmann::json aggregate;
+            aggregate["levels"]["target"]["path"] = dir + "/asset.json";
+            auto& padding = aggregate["levels"]["padding"];
+            for (std::size_t i = 0, size = 0; size < SIZE; ++i) {
+                padding.push_back({ { "id", i }, { "name", "entry" + std::to_string(i % 1000) }, { "position", { i * 0.25, i * 0.5, i * 0.75 } } });
+                size += padding.back().dump().size() + 1;
+            }
+            std::ofstream(dir + "/aggregate.json") << aggregate;
+        }
+
+        std::unordered_map<std::string, std::unique_ptr<JsonData>> jsons;
+        jsons.emplace("target", std::make_unique<JsonData>(dir + "/aggregate.json"));
+        jsons.at("target")->Load();
+
+        // What Register did before: copy the whole document, then drill down
+        auto start = std::chrono::steady_clock::now();
+        {
+            auto copy_data = *jsons.at("target")->GetData();
+            copy_data = copy_data.at("levels").at("target");
+        }
+        const auto copy_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        JsonManager manager;
+        start = std::chrono::steady_clock::now();
+        manager.Register(jsons, nlohmann::json::json_pointer("/levels/target"));
+        const auto pointer_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "document: " << std::filesystem::file_size(dir + "/aggregate.json") / (1024 * 1024) << "MB copy: " << copy_us
+                  << "us pointer: " << pointer_us << "us" << std::endl;
+        manager.Release();
+        std::filesystem::remove_all(dir);
+    }
+
+    static void BENCH_JSONREFLECTION() {
+        constexpr int RECORDS = 100000;
+
+        struct Record : IJsonData {
+            int                id = 0;
+            std::string        name;
+            double             scale = 0.0;
+            bool               isActive = false;
+            std::vector<float> position;
+            MACRO_JSON_REFLECT(Record, id, name, scale, isActive, position)
+
+            void FromJson(const nlohmann::json& json) override {
+                id       = json.at("id").get<int>();
+                name     = json.at("name").get<std::string>();
+                scale    = json.at("scale").get<double>();
+                isActive = json.at("isActive").get<bool>();
+                position = json.at("position").get<std::vector<float>>();
+            }
+        };
+
+        nlohmann::json json = nlohmann::json::array();
+        for (int i = 0; i < RECORDS; ++i) {
+            json.push_back({ { "id", i }, { "name", "record" + std::to_string(i) }, { "scale", i * 0.5 }, { "isActive", i % 2 == 0 }, { "position", { i * 0.25, i * 0.5, i * 0.75 } } });
+        }
+        const auto text = json.dump();
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<Record> dom_records;
+        {
+            const auto dom = nlohmann::json::parse(text);
+            dom_records.resize(dom.size());
+            for (std::size_t i = 0; i < dom.size(); ++i) {
+                dom_records[i].FromJson(dom[i]);
+            }
+        }
+        const auto dom_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        std::vector<Record> sax_records;
+        json_reflection::Read(text, &sax_records);
+        const auto sax_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "records: " << RECORDS << " size: " << text.size() / 1024 << "KB dom: " << dom_us << "us sax: " << sax_us
+                  << "us same: " << (sax_records.size() == dom_records.size() && sax_records.back().name == dom_records.back().name) << std::endl;
+    }
+
+    static void BENCH_JSONMANAGER() {
+        constexpr int ASSETS = 2000;
+
+        const std::string dir = "json_manager_bench";
+        std::filesystem::create_directories(dir);
+        nlohmann::json manifest;
+        for (int i = 0; i < ASSETS; ++i) {
+            const std::string path = dir + "/" + std::to_string(i) + ".json";
+            nlohmann::json json;
+            for (int j = 0; j < 50; ++j) {
+                json["values"].push_back({ { "id", j }, { "name", "entry" + std::to_string(j) }, { "scale", j * 0.5 } });
+            }
+            std::ofstream(path) << json;
+            manifest["list"].push_back({ { "name", "asset" + std::to_string(i) }, { "path", path } });
+        }
+        std::ofstream(dir + "/manifest.json") << manifest;
+
+        JsonManager manager;
+        manager.Register(dir + "/manifest.json");
+
+        auto start = std::chrono::steady_clock::now();
+        manager.Load();
+        const auto serial_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        manager.Load(JsonManager::BulkLoadOptions{});
+        const auto bulk_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
 
+        std::cout << "assets: " << ASSETS << " workers: " << JobSystem::GetDefault().GetWorkerCount()
+                  << " serial: " << serial_us << "us bulk: " << bulk_us << "us" << std::endl;
+        std::filesystem::remove_all(dir);
     }
 
     static void TEST_AUDIOHELPER() {
@@ -22,6 +22,52 @@ int main(int, char*)
     TEST_MATH::TEST_RANDOM();
     TEST_MATH::TEST_TIMER();
 
+    TEST_THREAD::TEST_THREADHELPER();
+    TEST_THREAD::TEST_CHASELEVDEQUE();
+    TEST_THREAD::TEST_JOBSYSTEM();
+    TEST_THREAD::TEST_JOBTRACE();
+    TEST_THREAD::TEST_SCRATCHARENA();
+    TEST_THREAD::TEST_COMPLETIONHANDLE();
+    TEST_THREAD::TEST_TASKGRAPH();
+    TEST_THREAD::TEST_PARALLEL();
+    TEST_THREAD::TEST_RINGQUEUE();
+    TEST_THREAD::TEST_TIMERSCHEDULER();
+    TEST_THREAD::TEST_ASYNCFILESERVICE();
+
+    TEST_UTILITY::TEST_STRINGID();
+
+    TEST_EXTERNALDEPENDENCIES::TEST_JSONDATA();
+    TEST_EXTERNALDEPENDENCIES::TEST_JSONPARSECACHE();
+    TEST_EXTERNALDEPENDENCIES::TEST_JSONREFLECTION();
+    TEST_EXTERNALDEPENDENCIES::TEST_JSONSCHEMACACHE();
+    TEST_EXTERNALDEPENDENCIES::TEST_JSONMANAGER();
+    TEST_EXTERNALDEPENDENCIES::TEST_ASSETDEPENDENCIES();
+    TEST_EXTERNALDEPENDENCIES::TEST_ASSETHANDLE();
+    TEST_EXTERNALDEPENDENCIES::TEST_ASSETTELEMETRY();
+    TEST_EXTERNALDEPENDENCIES::TEST_ASSETFINALIZATION();
+    TEST_EXTERNALDEPENDENCIES::TEST_ASSETREQUEST();
+    TEST_EXTERNALDEPENDENCIES::TEST_ASSETHOTRELOAD();
+    TEST_EXTERNALDEPENDENCIES::TEST_ASSETARCHIVE();
+    TEST_EXTERNALDEPENDENCIES::TEST_ASSETREGISTER();
+
+#ifdef ENABLE_BENCHMARK
+    TEST_THREAD::BENCH_JOBSYSTEM();
+    TEST_THREAD::BENCH_SCRATCHARENA();
+    TEST_THREAD::BENCH_PARALLEL();
+    TEST_THREAD::BENCH_RINGQUEUE();
+    TEST_THREAD::BENCH_TIMERSCHEDULER();
+    TEST_THREAD::BENCH_ASYNCFILESERVICE();
+
+    TEST_UTILITY::BENCH_STRINGID();
+
+    TEST_EXTERNALDEPENDENCIES::BENCH_JSONDATA();
+    TEST_EXTERNALDEPENDENCIES::BENCH_JSONPARSECACHE();
+    TEST_EXTERNALDEPENDENCIES::BENCH_ASSETARCHIVE();
+    TEST_EXTERNALDEPENDENCIES::BENCH_ASSETREGISTER();
+    TEST_EXTERNALDEPENDENCIES::BENCH_JSONREFLECTION();
+    TEST_EXTERNALDEPENDENCIES::BENCH_JSONMANAGER();
+#endif
+
     return 0;
 }
 
@@ -1,10 +1,803 @@
 ﻿#pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <string>
+
+#include "Thread/AsyncFileService/AsyncFileService.h"
+#include "Thread/JobSystem/ChaseLevDeque.h"
+#include "Thread/JobSystem/JobSystem.h"
+#include "Thread/JobSystem/JobTrace.h"
+#include "Thread/JobSystem/ScratchArena.h"
+#include "Thread/Parallel/Parallel.h"
+#include "Thread/Queue/RingQueue.h"
+#include "Thread/SimpleThreadManager/CompletionHandle.h"
 #include "Thread/SimpleThreadManager/SimpleUniqueThread.h"
 #include "Thread/SimpleThreadManager/SimpleThreadManager.h"
+#include "Thread/TaskGraph/TaskGraph.h"
+#include "Thread/ThreadHelper/ThreadHelper.h"
+#include "Thread/TimerScheduler/TimerScheduler.h"
+GAME_LIBRARIES_THREAD_ASYNCFILESERVICE_ASYNCFILESERVICE_H_
+GAME_LIBRARIES_THREAD_JOBSYSTEM_CHASELEVDEQUE_H_
+GAME_LIBRARIES_THREAD_JOBSYSTEM_JOBSYSTEM_H_
+GAME_LIBRARIES_THREAD_JOBSYSTEM_JOBTRACE_H_
+GAME_LIBRARIES_THREAD_JOBSYSTEM_SCRATCHARENA_H_
+GAME_LIBRARIES_THREAD_PARALLEL_PARALLEL_H_
+GAME_LIBRARIES_THREAD_QUEUE_RINGQUEUE_H_
+GAME_LIBRARIES_THREAD_SIMPLETHREADMANAGER_COMPLETIONHANDLE_H_
 GAME_LIBRARIES_THREAD_SIMPLETHREADMANAGER_SIMPLEUNIQUETHREAD_H_
 GAME_LIBRARIES_THREAD_SIMPLETHREADMANAGER_SIMPLETHREADMANAGER_H_
+GAME_LIBRARIES_THREAD_TASKGRAPH_TASKGRAPH_H_
+GAME_LIBRARIES_THREAD_THREADHELPER_THREADHELPER_H_
+GAME_LIBRARIES_THREAD_TIMERSCHEDULER_TIMERSCHEDULER_H_
 
 class TEST_THREAD
 {
+public:
+
+    static void TEST_THREADHELPER() {
+        const auto topology = thread_helper::GetCpuTopology();
+        assert(!topology.physicalCores.empty() && topology.logicalCount >= topology.physicalCores.size());
+
+        thread_helper::ThreadOptions options;
+        options.affinity = topology.physicalCores.back();
+        options.priority = thread_helper::ThreadPriority::BACKGROUND_IO;
+        options.name     = "TestWorker";
+
+        Counter counter;
+        SimpleUniqueThread thread;
+        thread.SetThreadOptions(options);
+        thread.Create(&Counter::Increment, &counter).Wait();
+        thread.SyncEnd();
+        assert(counter.value == 1);
+
+        JobSystem::Options job_options;
+        job_options.pinToPhysicalCores = true;
+        JobSystem job_system(job_options);
+        job_system.Submit([&] { counter.Increment(); }).Wait();
+        assert(counter.value == 2);
+
+#ifdef __linux__
+        // More workers than cores share the other cores, none runs on the core of the main thread
+        if (topology.physicalCores.size() > 1) {
+            job_options.workerCount = topology.physicalCores.size() * 2;
+            JobSystem crowded(job_options);
+            const auto& main_core = topology.physicalCores.front();
+            std::atomic<bool> is_on_main_core = false;
+            auto group = crowded.CreateGroup();
+            for (int i = 0; i < 256; ++i) {
+                crowded.Submit(group, [&] {
+                    const auto cpu = static_cast<std::size_t>(sched_getcpu());
+                    if (std::find(main_core.begin(), main_core.end(), cpu) != main_core.end() && crowded.IsWorkerThread()) {
+                        is_on_main_core = true;
+                    }
+                });
+            }
+            group.Wait();
+            assert(!is_on_main_core);
+        }
+#endif
+    }
+
+    static void TEST_CHASELEVDEQUE() {
+        ChaseLevDeque<int> deque(2);
+        for (int i = 0; i < 100; ++i) {
+            deque.Push(i);
+        }
+        int value = 0;
+        assert(deque.Steal(&value) && value == 0);
+        assert(deque.Pop(&value) && value == 99);
+        assert(deque.Size() == 98);
+    }
+
+    static void TEST_JOBSYSTEM() {
+        JobSystem job_system(4);
+        std::atomic<int> count = 0;
+
+        auto group = job_system.CreateGroup();
+        for (int i = 0; i < 10000; ++i) {
+            job_system.Submit(group, [&] { ++count; });
+        }
+        group.Wait();
+        assert(count == 10000);
+
+        // Nested submission from a worker
+        auto parent = job_system.Submit([&] {
+            auto child = job_system.CreateGroup();
+            for (int i = 0; i < 100; ++i) {
+                job_system.Submit(child, [&] { ++count; });
+            }
+            child.Wait();
+        });
+        parent.Wait();
+        assert(count == 10100);
+
+        // Exceptions of any type are kept by the handle of the job and of its group
+        auto failed = job_system.CreateGroup();
+        job_system.Submit(failed, [] { throw 42; });
+        job_system.Submit(failed, [&] { ++count; });
+        failed.Wait();
+        assert(count == 10101 && failed.GetException() && !group.GetException());
+        try {
+            std::rethrow_exception(failed.GetException());
+        }
+        catch (int e) {
+            assert(e == 42);
+        }
+
+        Counter counter;
+        SimpleThreadManager manager(&job_system);
+        auto id = manager.Create(&Counter::Increment, &counter);
+        manager.SyncEnd(&id);
+        assert(counter.value == 1 && id == SimpleThreadManager::ID());
+
+        // A job that throws still completes
+        auto thrown = manager.Create(&Counter::Throw, &counter);
+        manager.GetCompletion(thrown).Wait();
+        assert(manager.IsEnd(thrown));
+        manager.SyncEnd(&thrown);
+    }
+
+    static void TEST_JOBTRACE() {
+        // Parents submitted from this thread, each spawning and waiting on children
+        const auto run = [](JobSystem& job_system) {
+            auto group = job_system.CreateGroup();
+            for (int i = 0; i < 4; ++i) {
+                job_system.Submit(group, [&job_system] {
+                    auto children = job_system.CreateGroup();
+                    for (int j = 0; j < 4; ++j) {
+                        job_system.Submit(children, [] {});
+                    }
+                    children.Wait();
+                });
+            }
+            group.Wait();
+        };
+
+        JobSystem job_system(4);
+        job_system.StartRecording();
+        run(job_system);
+        const JobTrace trace = job_system.StopRecording();
+        assert(!job_system.IsRecording());
+
+        std::size_t counts[5] = {};
+        for (const auto& e : trace.GetEvents()) {
+            ++counts[static_cast<std::size_t>(e.type)];
+        }
+        assert(counts[0] == 20 && counts[1] == 20 && counts[2] == 20 && counts[3] == counts[4]);
+        assert(trace.GetWorkerCount() == 4);
+
+        const std::string path = "job_trace_test.bin";
+        assert(trace.Save(path));
+        JobTrace loaded;
+        assert(loaded.Load(path));
+        assert(loaded.GetEvents().size() == trace.GetEvents().size() && loaded.GetExecutionOrder() == trace.GetExecutionOrder());
+        std::remove(path.c_str());
+
+        std::ostringstream json;
+        trace.WriteChromeTrace(json);
+        assert(json.str().find("\"traceEvents\"") != std::string::npos && json.str().find("\"ph\":\"X\"") != std::string::npos);
+
+        // The replay runs on this thread in the recorded order
+        JobSystem::Options options;
+        options.pReplay = &trace;
+        JobSystem replay(options);
+        assert(replay.IsReplaying() && replay.GetWorkerCount() == 4);
+        replay.StartRecording();
+        run(replay);
+        const JobTrace replayed = replay.StopRecording();
+        assert(replayed.GetExecutionOrder() == trace.GetExecutionOrder());
+        for (const auto& e : replayed.GetEvents()) {
+            assert(e.thread == 4);
+        }
+    }
+
+    static void TEST_SCRATCHARENA() {
+        ScratchArena arena(1024);
+        {
+            ScratchScope outer(arena);
+            std::pmr::vector<int> a(outer.GetResource());
+            a.resize(100);
+            const auto used = arena.GetUsedBytes();
+            {
+                ScratchScope inner(arena);
+                std::pmr::vector<double> b(4096, 0.0, inner.GetResource()); // larger than a block
+                assert(arena.GetUsedBytes() > used);
+            }
+            assert(arena.GetUsedBytes() == used);
+        }
+        assert(arena.GetUsedBytes() == 0);
+
+        // Each worker rewinds its own arena after every job
+        JobSystem job_system(2);
+        auto group = job_system.CreateGroup();
+        for (int i = 0; i < 100; ++i) {
+            job_system.Submit(group, [] {
+                ScratchScope scratch;
+                std::pmr::vector<int> v(1000, 1, scratch.GetResource());
+                assert(ScratchArena::GetCurrent().GetUsedBytes() >= 1000 * sizeof(int));
+            });
+        }
+        group.Wait();
+    }
+
+    static void TEST_COMPLETIONHANDLE() {
+        Counter counter;
+        SimpleUniqueThread thread;
+        auto handle = thread.Create(&Counter::IncrementUntilStopped, &counter);
+        assert(!handle.WaitFor(std::chrono::milliseconds(10)));
+        handle.RequestStop();
+        handle.Wait();
+        assert(handle.IsReady() && thread.IsEnd());
+        thread.SyncEnd();
+
+        // TERMINATE asks to stop and detaches instead of destroying a running std::thread
+        handle = thread.Create(&Counter::IncrementUntilStopped, &counter);
+        thread.SyncEnd(SimpleUniqueThread::SyncType::TERMINATE);
+        assert(handle.WaitFor(std::chrono::seconds(1)));
+
+        JobSystem job_system(2);
+        SimpleThreadManager manager(&job_system);
+        auto id = manager.Create(&Counter::IncrementUntilStopped, &counter);
+        auto job_handle = manager.GetCompletion(id);
+        job_handle.RequestStop();
+        assert(job_handle.WaitFor(std::chrono::seconds(1)));
+        manager.SyncEnd(&id);
+    }
+
+    static void TEST_TASKGRAPH() {
+        JobSystem job_system(4);
+        TaskGraph graph(&job_system);
+        std::atomic<int> step = 0;
+        int input = -1, physics = -1, effect = -1, draw = -1;
+
+        auto input_node   = graph.AddNode("input",   [&] { input = step++; });
+        auto physics_node = graph.AddNode("physics", [&] { physics = step++; }, { input_node });
+        auto effect_node  = graph.AddNode("effect",  [&] { effect = step++; }, { input_node });
+        auto draw_node    = graph.AddNode("draw",    [&] { draw = step++; }, { physics_node, effect_node });
+
+        for (int frame = 0; frame < 3; ++frame) {
+            step = 0;
+            graph.Run();
+            assert(input == 0 && physics > input && effect > input && draw == 3);
+        }
+        assert(graph.GetTiming(draw_node).beginNS >= graph.GetTiming(physics_node).beginNS);
+        assert(graph.GetPriority(input_node) >= graph.GetPriority(draw_node));
+
+        // RunAsync returns at once and keeps the order
+        step = 0;
+        auto run = graph.RunAsync();
+        assert(run.IsValid());
+        run.Wait();
+        assert(input == 0 && physics > input && effect > input && draw == 3);
+
+        // Its timings become priorities when the graph runs next
+        graph.AddNode("slow", [] { std::this_thread::sleep_for(std::chrono::milliseconds(5)); });
+        graph.RunAsync().Wait();
+        graph.RunAsync().Wait();
+        assert(graph.GetPriority(graph.GetNodeCount() - 1) >= 5000000 && graph.GetLastRunTime() >= 5000000);
+
+        // A node throwing on the calling thread waits for the submitted ones
+        TaskGraph throwing(&job_system);
+        std::atomic<bool> is_slow_done = false;
+        throwing.AddNode("slow", [&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            is_slow_done = true;
+        });
+        throwing.AddNode("throw", [] { throw std::runtime_error("node"); }, {}, 1000000000);
+        bool is_thrown = false;
+        try {
+            throwing.Run();
+        }
+        catch (const std::runtime_error&) {
+            is_thrown = true;
+        }
+        assert(is_thrown && is_slow_done);
+
+        TaskGraph cyclic(&job_system);
+        auto a = cyclic.AddNode("a", [] {});
+        auto b = cyclic.AddNode("b", [] {}, { a });
+        cyclic.AddDependency(b, a);
+        assert(!cyclic.Build() && !cyclic.RunAsync().IsValid());
+    }
+
+    static void TEST_PARALLEL() {
+        JobSystem job_system(4);
+        parallel::Options options;
+        options.pJobSystem      = &job_system;
+        options.serialThreshold = 1;
+
+        std::vector<int> v(100000);
+        parallel::ParallelFor(0, static_cast<int>(v.size()), [&](int i) { v[i] = i; }, options);
+        assert(v[12345] == 12345);
+
+        const auto sum = parallel::ParallelReduce(v.begin(), v.end(), 0LL, std::plus<>(), options);
+        assert(sum == std::accumulate(v.begin(), v.end(), 0LL));
+
+        // Non commutative operation keeps its order
+        std::vector<std::string> words(1000, "a");
+        words[999] = "z";
+        assert(parallel::ParallelReduce(words.begin(), words.end(), std::string(), std::plus<>(), options).back() == 'z');
+
+        std::vector<int> doubled(v.size());
+        parallel::ParallelTransform(v.begin(), v.end(), doubled.begin(), [](int x) { return x * 2; }, options);
+        assert(doubled[500] == 1000);
+
+        std::mt19937 mt(0);
+        std::shuffle(v.begin(), v.end(), mt);
+        parallel::ParallelSort(v.begin(), v.end(), std::less<>(), options);
+        assert(std::is_sorted(v.begin(), v.end()));
+
+        // Index 0 is processed on the calling thread and the last one in a job, which is waited for before unwinding
+        std::atomic<bool> is_last_done = false;
+        bool is_thrown = false;
+        try {
+            parallel::ParallelFor(0, static_cast<int>(v.size()), [&](int i) {
+                if (i == 0) throw std::runtime_error("body");
+                if (i == static_cast<int>(v.size()) - 1) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                    is_last_done = true;
+                }
+            }, options);
+        }
+        catch (const std::runtime_error&) {
+            is_thrown = true;
+        }
+        assert(is_thrown && is_last_done);
+    }
+
+    static void BENCH_PARALLEL() {
+        parallel::Options force_parallel;
+        force_parallel.serialThreshold = 1;
+
+        const auto report = [](const char* name, std::size_t size, long long serial_us, long long parallel_us, bool* crossed) {
+            std::cout << name << " n: " << size << " serial: " << serial_us << "us parallel: " << parallel_us << "us";
+            if (!*crossed && parallel_us < serial_us) {
+                *crossed = true;
+                std::cout << " <- crossover";
+            }
+            std::cout << std::endl;
+        };
+
+        bool for_crossed = false, reduce_crossed = false, transform_crossed = false, sort_crossed = false;
+        for (std::size_t size = 256; size <= (1u << 22); size *= 4) {
+            std::vector<float> src(size), dst(size);
+            std::iota(src.begin(), src.end(), 0.0f);
+            const auto work = [](float x) { return std::sqrt(x) * 0.5f + 1.0f; };
+
+            auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < size; ++i) dst[i] = work(src[i]);
+            const auto for_serial = ElapsedUS(start);
+            start = std::chrono::steady_clock::now();
+            parallel::ParallelFor(std::size_t(0), size, [&](std::size_t i) { dst[i] = work(src[i]); }, force_parallel);
+            report("ParallelFor", size, for_serial, ElapsedUS(start), &for_crossed);
+
+            start = std::chrono::steady_clock::now();
+            volatile double serial_sum = std::accumulate(src.begin(), src.end(), 0.0);
+            const auto reduce_serial = ElapsedUS(start);
+            start = std::chrono::steady_clock::now();
+            volatile double parallel_sum = parallel::ParallelReduce(src.begin(), src.end(), 0.0, std::plus<>(), force_parallel);
+            report("ParallelReduce", size, reduce_serial, ElapsedUS(start), &reduce_crossed);
+            (void)serial_sum;
+            (void)parallel_sum;
+
+            start = std::chrono::steady_clock::now();
+            std::transform(src.begin(), src.end(), dst.begin(), work);
+            const auto transform_serial = ElapsedUS(start);
+            start = std::chrono::steady_clock::now();
+            parallel::ParallelTransform(src.begin(), src.end(), dst.begin(), work, force_parallel);
+            report("ParallelTransform", size, transform_serial, ElapsedUS(start), &transform_crossed);
+
+            std::mt19937 mt(0);
+            std::shuffle(src.begin(), src.end(), mt);
+            dst = src;
+            start = std::chrono::steady_clock::now();
+            std::sort(src.begin(), src.end());
+            const auto sort_serial = ElapsedUS(start);
+            start = std::chrono::steady_clock::now();
+            parallel::ParallelSort(dst.begin(), dst.end(), std::less<>(), force_parallel);
+            report("ParallelSort", size, sort_serial, ElapsedUS(start), &sort_crossed);
+        }
+    }
+
+    static void TEST_RINGQUEUE() {
+        SpscRingQueue<int, 8> spsc;
+        int batch[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+        assert(spsc.TryPushBatch(batch, 8) == 8);
+        assert(!spsc.TryPush(8));
+        int value = -1;
+        assert(spsc.TryPop(&value) && value == 0);
+        assert(spsc.TryPopBatch(batch, 8) == 7 && batch[6] == 7);
+        assert(!spsc.TryPop(&value));
+
+        MpmcRingQueue<int, 8> mpmc;
+        assert(mpmc.TryPushBatch(batch, 8) == 8);
+        assert(!mpmc.TryPush(0));
+        assert(mpmc.TryPopBatch(batch, 3) == 3 && mpmc.Size() == 5);
+
+        // Every value pushed by several producers is popped exactly once
+        auto queue = std::make_unique<MpmcRingQueue<int, 1024>>();
+        std::vector<std::thread> producers;
+        for (int p = 0; p < 4; ++p) {
+            producers.emplace_back([&queue, p] {
+                for (int i = 0; i < 10000; ++i) {
+                    while (!queue->TryPush(p * 10000 + i)) thread_helper::CpuRelax();
+                }
+            });
+        }
+        std::vector<bool> seen(40000, false);
+        for (int popped = 0; popped < 40000;) {
+            if (queue->TryPop(&value)) {
+                assert(!seen[value]);
+                seen[value] = true;
+                ++popped;
+            }
+        }
+        for (auto&& e : producers) e.join();
+    }
+
+    static void BENCH_RINGQUEUE() {
+        constexpr std::size_t ITEMS_PER_PRODUCER = 1000000;
+        constexpr std::size_t CAPACITY           = 4096;
+        constexpr std::size_t BATCH              = 64;
+
+        const auto now_ns = [] {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        };
+
+        // Producers push timestamps, the consumer pops in batches and measures the age of each element
+        const auto run = [&](const char* name, std::size_t producer_count, auto* queue) {
+            std::vector<std::thread> producers;
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t p = 0; p < producer_count; ++p) {
+                producers.emplace_back([&] {
+                    for (std::size_t i = 0; i < ITEMS_PER_PRODUCER; ++i) {
+                        while (!queue->TryPush(now_ns())) thread_helper::CpuRelax();
+                    }
+                });
+            }
+            std::vector<long long> latencies;
+            latencies.reserve(producer_count * ITEMS_PER_PRODUCER);
+            long long items[BATCH];
+            while (latencies.size() < producer_count * ITEMS_PER_PRODUCER) {
+                const std::size_t n = queue->TryPopBatch(items, BATCH);
+                const auto t = now_ns();
+                for (std::size_t i = 0; i < n; ++i) {
+                    latencies.push_back(t - items[i]);
+                }
+            }
+            const auto elapsed_us = ElapsedUS(start);
+            for (auto&& e : producers) e.join();
+
+            std::sort(latencies.begin(), latencies.end());
+            std::cout << name << " producers: " << producer_count
+                      << " throughput: " << (latencies.size() * 1000000 / (elapsed_us ? elapsed_us : 1)) << " items/s"
+                      << " latency p50: " << latencies[latencies.size() / 2] << "ns"
+                      << " p99: " << latencies[latencies.size() * 99 / 100] << "ns" << std::endl;
+        };
+
+        run("SpscRingQueue", 1, std::make_unique<SpscRingQueue<long long, CAPACITY>>().get());
+        for (std::size_t producer_count : { 1, 2, 4, 8 }) {
+            run("MpmcRingQueue", producer_count, std::make_unique<MpmcRingQueue<long long, CAPACITY>>().get());
+        }
+    }
+
+    static void TEST_ASYNCFILESERVICE() {
+        const std::string dir = "async_file_test";
+        std::filesystem::create_directories(dir);
+        std::vector<std::string> paths;
+        for (int i = 0; i < 64; ++i) {
+            paths.push_back(dir + "/" + std::to_string(i) + ".txt");
+            std::ofstream(paths.back(), std::ios::binary) << std::string(static_cast<std::size_t>(i) * 1000, static_cast<char>('a' + i % 26));
+        }
+
+        for (bool force_thread_pool : { false, true }) {
+            AsyncFileService::Options options;
+            options.queueDepth      = 8; // fewer than the files, so the backlog is exercised
+            options.forceThreadPool = force_thread_pool;
+            AsyncFileService service(options);
+            assert(!force_thread_pool || service.GetBackend() == AsyncFileService::Backend::THREAD_POOL);
+
+            auto handles = service.ReadFiles(paths);
+            for (std::size_t i = 0; i < handles.size(); ++i) {
+                handles[i].Wait();
+                assert(handles[i].IsSucceeded());
+                assert(handles[i].GetData() == std::string(i * 1000, static_cast<char>('a' + i % 26)));
+            }
+
+            auto missing = service.ReadFile(dir + "/missing.txt");
+            missing.Wait();
+            assert(!missing.IsSucceeded() && missing.GetError() != 0);
+
+            std::atomic<bool> is_called = false;
+            auto callback = service.ReadFile(paths[1], [&is_called](FileReadHandle file) {
+                assert(file.IsSucceeded() && file.GetData().size() == 1000);
+                is_called = true;
+            });
+            callback.Wait();
+            while (!is_called) std::this_thread::yield();
+        }
+        std::filesystem::remove_all(dir);
+    }
+
+    static void BENCH_ASYNCFILESERVICE() {
+        constexpr std::size_t FILES = 10000;
+
+        const std::string dir = "async_file_bench";
+        std::filesystem::create_directories(dir);
+        std::vector<std::string> paths;
+        for (std::size_t i = 0; i < FILES; ++i) {
+            paths.push_back(dir + "/" + std::to_string(i) + ".json");
+            std::ofstream(paths.back(), std::ios::binary) << "{\"id\":" << i << ",\"payload\":\"" << std::string(200 + i % 800, 'x') << "\"}";
+        }
+
+        // Drops the files from the page cache where the OS allows it, otherwise cold equals warm
+        const auto evict = [&paths] {
+#ifndef _WIN32
+            for (const auto& e : paths) {
+                const int fd = ::open(e.c_str(), O_RDONLY);
+                if (fd < 0) continue;
+                ::fdatasync(fd);
+                ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+                ::close(fd);
+            }
+#endif
+        };
+        const auto read_ifstream = [&paths] {
+            std::size_t bytes = 0;
+            for (const auto& e : paths) {
+                std::ifstream ifs(e, std::ios::binary);
+                std::string data((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+                bytes += data.size();
+            }
+            return bytes;
+        };
+        const auto read_service = [&paths](AsyncFileService& service) {
+            std::size_t bytes = 0;
+            for (auto&& e : service.ReadFiles(paths)) {
+                e.Wait();
+                bytes += e.GetData().size();
+            }
+            return bytes;
+        };
+
+        AsyncFileService uring;
+        AsyncFileService::Options pool_options;
+        pool_options.forceThreadPool = true;
+        AsyncFileService pool(pool_options);
+
+        const auto run = [&](const char* name, const auto& read) {
+            evict();
+            auto start = std::chrono::steady_clock::now();
+            const auto cold_bytes = read();
+            const auto cold_us = ElapsedUS(start);
+            start = std::chrono::steady_clock::now();
+            const auto warm_bytes = read();
+            const auto warm_us = ElapsedUS(start);
+            assert(cold_bytes == warm_bytes);
+            std::cout << name << " files: " << FILES << " cold: " << cold_us << "us warm: " << warm_us << "us" << std::endl;
+        };
+        run("ifstream", read_ifstream);
+        run(uring.GetBackend() == AsyncFileService::Backend::IO_URING ? "io_uring" : "thread pool (no io_uring)", [&] { return read_service(uring); });
+        run("thread pool", [&] { return read_service(pool); });
+
+        std::filesystem::remove_all(dir);
+    }
+
+    static void TEST_TIMERSCHEDULER() {
+        using namespace std::chrono_literals;
+
+        TimerScheduler scheduler(1ms);
+        std::size_t fired_count = 0;
+        // Delays that land in every wheel, including one cascading down from the top wheel
+        const std::vector<std::uint64_t> delays = { 1, 255, 256, 1000, 65535, 65536, 70000, 16777216 + 5 };
+        for (const auto& e : delays) {
+            scheduler.Schedule(std::chrono::milliseconds(e), [&fired_count] { ++fired_count; });
+        }
+        const auto cancelled = scheduler.Schedule(500ms, [] { assert(false); });
+        assert(scheduler.IsPending(cancelled));
+        assert(scheduler.Cancel(cancelled));
+        assert(!scheduler.Cancel(cancelled));
+
+        // Each timer fires exactly on its tick
+        for (std::size_t i = 0; i < delays.size(); ++i) {
+            scheduler.AdvanceTicks(delays[i] - 1 - scheduler.GetCurrentTick());
+            assert(fired_count == i);
+            scheduler.AdvanceTicks(1);
+            assert(fired_count == i + 1);
+        }
+        assert(scheduler.GetPendingCount() == 0);
+
+        int periodic_count = 0;
+        const auto periodic = scheduler.SchedulePeriodic(10ms, [&periodic_count] { ++periodic_count; });
+        scheduler.Advance(100ms);
+        assert(periodic_count == 10);
+        assert(scheduler.Cancel(periodic));
+        scheduler.Advance(100ms);
+        assert(periodic_count == 10);
+
+        // Callbacks on the pool
+        JobSystem job_system(2);
+        TimerScheduler pool_scheduler(1ms, &job_system);
+        std::atomic<int> pool_count = 0;
+        for (int i = 0; i < 100; ++i) {
+            pool_scheduler.Schedule(std::chrono::milliseconds(i), [&pool_count] { ++pool_count; }, TimerScheduler::Dispatch::JOB_SYSTEM);
+        }
+        pool_scheduler.Advance(100ms);
+        while (pool_count.load() != 100) {
+            job_system.RunPendingJob();
+        }
+    }
+
+    static void BENCH_TIMERSCHEDULER() {
+        using namespace std::chrono_literals;
+        constexpr std::size_t TIMERS = 200000;
+        constexpr std::size_t FRAMES = 1000;
+
+        std::mt19937 random(42);
+        std::uniform_int_distribution<int> delay_ms(1000, 600000);
+
+        // Frame cost with few pending timers versus many, each frame advances 16ms
+        const auto run = [&](std::size_t timer_count) {
+            TimerScheduler scheduler(1ms);
+            std::size_t fired_count = 0;
+            std::vector<TimerScheduler::TimerID> ids;
+            ids.reserve(timer_count);
+
+            auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < timer_count; ++i) {
+                ids.push_back(scheduler.Schedule(std::chrono::milliseconds(delay_ms(random)), [&fired_count] { ++fired_count; }));
+            }
+            const auto schedule_us = ElapsedUS(start);
+
+            start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < FRAMES; ++i) {
+                scheduler.Advance(16ms);
+            }
+            const auto advance_us = ElapsedUS(start);
+
+            start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < ids.size(); i += 2) {
+                scheduler.Cancel(ids[i]);
+            }
+            const auto cancel_us = ElapsedUS(start);
+
+            std::cout << "timers: " << timer_count << " schedule: " << schedule_us << "us"
+                      << " advance per frame: " << advance_us * 1000 / FRAMES << "ns (fired " << fired_count << ")"
+                      << " cancel half: " << cancel_us << "us" << std::endl;
+        };
+
+        run(10);
+        run(TIMERS);
+    }
+
+    static void BENCH_SCRATCHARENA() {
+        constexpr std::size_t WORKERS        = 8;
+        constexpr std::size_t JOBS           = 2000;
+        constexpr std::size_t LISTS_PER_JOB  = 64;
+        constexpr std::size_t ITEMS_PER_LIST = 256;
+
+        JobSystem job_system(WORKERS);
+
+        // Temporary lists on the global heap, every push_back growth hits the shared allocator
+        auto start = std::chrono::steady_clock::now();
+        auto group = job_system.CreateGroup();
+        for (std::size_t i = 0; i < JOBS; ++i) {
+            job_system.Submit(group, [] {
+                for (std::size_t l = 0; l < LISTS_PER_JOB; ++l) {
+                    std::vector<std::size_t> list;
+                    for (std::size_t n = 0; n < ITEMS_PER_LIST; ++n) list.push_back(n);
+                }
+            });
+        }
+        group.Wait();
+        const auto heap_us = ElapsedUS(start);
+
+        // Same lists on the worker's scratch arena
+        start = std::chrono::steady_clock::now();
+        group = job_system.CreateGroup();
+        for (std::size_t i = 0; i < JOBS; ++i) {
+            job_system.Submit(group, [] {
+                for (std::size_t l = 0; l < LISTS_PER_JOB; ++l) {
+                    ScratchScope scratch;
+                    std::pmr::vector<std::size_t> list(scratch.GetResource());
+                    for (std::size_t n = 0; n < ITEMS_PER_LIST; ++n) list.push_back(n);
+                }
+            });
+        }
+        group.Wait();
+        const auto scratch_us = ElapsedUS(start);
+
+        std::cout << "workers: " << WORKERS << " lists: " << JOBS * LISTS_PER_JOB
+                  << " global heap: " << heap_us << "us scratch arena: " << scratch_us << "us" << std::endl;
+    }
+
+    static void BENCH_JOBSYSTEM() {
+        JobSystem job_system;
+        for (std::size_t job_count : { 10000, 100000, 1000000 }) {
+            Counter counter;
+            auto start = std::chrono::steady_clock::now();
+            {
+                // Today's path: one std::thread per call, a bounded number in flight
+                SimpleThreadManager manager;
+                std::deque<SimpleThreadManager::ID> in_flight;
+                for (std::size_t i = 0; i < job_count; ++i) {
+                    in_flight.push_back(manager.Create(&Counter::Increment, &counter));
+                    if (in_flight.size() >= thread_helper::GetLogicalProcessorCount() * 4) {
+                        manager.SyncEnd(&in_flight.front());
+                        in_flight.pop_front();
+                    }
+                }
+            }
+            const auto spawn_us = ElapsedUS(start);
+
+            start = std::chrono::steady_clock::now();
+            {
+                SimpleThreadManager manager(&job_system);
+                for (std::size_t i = 0; i < job_count; ++i) {
+                    manager.Create(&Counter::Increment, &counter);
+                }
+            }
+            const auto manager_us = ElapsedUS(start);
+
+            start = std::chrono::steady_clock::now();
+            auto group = job_system.CreateGroup();
+            for (std::size_t i = 0; i < job_count; ++i) {
+                job_system.Submit(group, [&counter] { counter.Increment(); });
+            }
+            group.Wait();
+            const auto job_us = ElapsedUS(start);
+
+            assert(counter.value == static_cast<int>(job_count * 3));
+            std::cout << "jobs: " << job_count
+                      << " spawn-per-call: " << spawn_us << "us"
+                      << " manager on JobSystem: " << manager_us << "us"
+                      << " JobSystem group: " << job_us << "us" << std::endl;
+        }
+    }
+
+private:
+
+    struct Counter {
+        std::atomic<int> value = 0;
+        void Increment() {
+            ++value;
+        }
+        void IncrementUntilStopped(StopToken token) {
+            while (!token.IsStopRequested()) {
+                ++value;
+                std::this_thread::yield();
+            }
+        }
+        void Throw() {
+            throw std::runtime_error("counter");
+        }
+    };
+
+    static long long ElapsedUS(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
 };
@@ -1,13 +1,25 @@
 ﻿#pragma once
 
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "Utility/Assert.h"
 #include "Utility/Macro.h"
 #include "Utility/Memory.h"
 #include "Utility/StdC++.h"
+#include "Utility/StringId.h"
+#include "Utility/StringIdMap.h"
 #include "Utility/Templates.h"
 GAME_LIBRARIES_UTILITY_ASSERT_H_
 GAME_LIBRARIES_UTILITY_MACRO_H_
 GAME_LIBRARIES_UTILITY_MEMORY_H_
+GAME_LIBRARIES_UTILITY_STRINGID_H_
+GAME_LIBRARIES_UTILITY_STRINGIDMAP_H_
 GAME_LIBRARIES_UTILITY_TEMPLATES_H_
 
 class TEST_UTILITY
@@ -39,5 +51,98 @@ public:
     static void TEST_TEMPLATES() {
         
     }
+
+    static void TEST_STRINGID() {
+        // Ids of literals are compile time constants
+        static_assert("player"_sid == StringId("player"));
+        static_assert("player"_sid != "enemy"_sid);
+        static_assert(StringId("").IsValid() && !StringId().IsValid());
+        constexpr StringId player = "player"_sid;
+        assert(player == StringId(std::string("player")));
+        assert(player.GetName()[0] == '#');
+        assert(StringIdTable::GetDefault().Intern("player") == player);
+        assert(player.GetName() == "player");
+
+        StringIdMap<int> map;
+        assert(!map.Find(player) && map.IsEmpty());
+        assert(map.TryEmplace(player, 1).second);
+        assert(!map.TryEmplace(player, 2).second && *map.Find(player) == 1);
+        assert(!map.TryEmplace(StringId(), 0).first);
+
+        // Compare against std::unordered_map through growth and erasure, which shifts entries back
+        std::unordered_map<std::string, int> expected;
+        map.Clear();
+        for (int i = 0; i < 1000; ++i) {
+            const auto name = "asset" + std::to_string(i);
+            map[name] = i;
+            expected[name] = i;
+        }
+        for (int i = 0; i < 1000; i += 3) {
+            const auto name = "asset" + std::to_string(i);
+            assert(map.Erase(name));
+            expected.erase(name);
+        }
+        assert(!map.Erase("asset0"));
+        assert(map.Size() == expected.size());
+        for (int i = 0; i < 1000; ++i) {
+            const auto name = "asset" + std::to_string(i);
+            const auto* value = map.Find(name);
+            assert(expected.count(name) ? value && *value == expected[name] : !value);
+        }
+        std::size_t count = 0;
+        map.ForEach([&](StringId, int& value) {
+            value = -value;
+            ++count;
+        });
+        assert(count == expected.size() && *map.Find("asset1") == -1);
+
+        // Move only values
+        StringIdMap<std::vector<std::unique_ptr<int>>> lists;
+        lists["a"_sid].push_back(std::make_unique<int>(1));
+        lists.Reserve(100);
+        assert(lists.GetCapacity() >= 128 && *lists.Find("a"_sid)->front() == 1);
+    }
+
+    static void BENCH_STRINGID() {
+        constexpr int COUNT  = 256;
+        constexpr int ROUNDS = 20000;
+
+        std::vector<std::string> names;
+        std::unordered_map<std::string, int> string_map;
+        StringIdMap<int> id_map;
+        for (int i = 0; i < COUNT; ++i) {
+            names.push_back("Asset/Texture/" + std::to_string(i) + ".png");
+            string_map.emplace(names.back(), i);
+            id_map.TryEmplace(StringIdTable::GetDefault().Intern(names.back()), i);
+        }
+        std::vector<std::string_view> views(names.begin(), names.end());
+        std::vector<StringId> ids(names.begin(), names.end());
+
+        // Lookups as the managers did them before: a std::string built from the view on every call
+        auto start = std::chrono::steady_clock::now();
+        long long string_sum = 0;
+        for (int r = 0; r < ROUNDS; ++r) {
+            for (const auto& e : views) {
+                string_sum += string_map.find(std::string(e))->second;
+            }
+        }
+        const auto string_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        long long id_sum = 0;
+        for (int r = 0; r < ROUNDS; ++r) {
+            for (const auto& e : ids) {
+                id_sum += *id_map.Find(e);
+            }
+        }
+        const auto id_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        if (string_sum != id_sum) {
+            std::cout << "StringIdMap lookup mismatch" << std::endl;
+        }
+        const double lookups = static_cast<double>(COUNT) * ROUNDS;
+        std::cout << "std::string lookup: " << string_ns / lookups << "ns"
+                  << " StringId lookup: " << id_ns / lookups << "ns" << std::endl;
+    }
     
 };